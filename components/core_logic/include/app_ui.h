@@ -3,29 +3,57 @@
 
 #include "hal_interface.h"
 #include "psu_protocol.h"
+#include "output_ctrl.h"
+#include "can_health.h"
+#include "telemetry_stats.h"
 
 enum UIMode {
     MODE_MONITOR,
     MODE_SET_VOLTAGE,
-    MODE_SET_CURRENT
+    MODE_SET_CURRENT,
+    MODE_CAN_STATUS,  // 唯讀頁面，僅在 setCanHealth() 後出現
+    MODE_STATS        // 滾動統計頁面，僅在 setStats() 後出現; UP/DOWN 切換視窗
 };
 
-class AppUI {
+// HAL: 顯示與按鍵使用的 HAL 類別
+// - AppUI (= AppUIT<IHardwareHAL>): 透過 vtable 呼叫，core_logic 內已具現化 (app_ui.cpp)，模擬 / 測試使用
+// - AppUIT<具體 HAL> (例 Esp32HAL，宣告為 final): 直接呼叫; 使用者 include "app_ui_impl.h" 具現化
+template <class HAL>
+class AppUIT {
 public:
-    AppUI(IHardwareHAL* hal, PowerProtocol* psu);
+    // DOWN (監看頁面) 經由 out 關閉所有並聯模塊
+    AppUIT(HAL* hal, PowerProtocol* psu, OutputControl* out);
     void begin();
     void loop();
+    uint32_t nextDeadline() const;
+
+    void setCanHealth(const CanHealth* can) { _can = can; }
+    void setStats(const TelemetryStats* stats) { _stats = stats; }
 
 private:
-    IHardwareHAL* _hal;
+    HAL* _hal;
     PowerProtocol* _psu;
+    OutputControl* _out;
     UIMode _mode;
+    const CanHealth* _can;
+    const TelemetryStats* _stats;
+    int _statsWindow;
 
     bool lastSel, lastUp, lastDown;
     uint32_t lastDebounce;
 
+    static const uint32_t DEBOUNCE_MS = 150;
+    static const uint32_t REFRESH_MS  = 100;
+    static const int SCREEN_WIDTH = 128;
+
     void handleButtons();
     void drawScreen();
+    void drawCanStatus();
+    void drawStats();
+    UIMode nextMode() const;
 };
 
+extern template class AppUIT<IHardwareHAL>;
+typedef AppUIT<IHardwareHAL> AppUI;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,206 @@
+#ifndef APP_UI_IMPL_H
+#define APP_UI_IMPL_H
+
+// AppUIT 的成員定義: 只由具現化的編譯單元 include (core_logic 的 app_ui.cpp、選用具體 HAL 的 main)
+#include "app_ui.h"
+#include <stdio.h>
+
+template <class HAL>
+AppUIT<HAL>::AppUIT(HAL* hal, PowerProtocol* psu, OutputControl* out)
+    : _hal(hal), _psu(psu), _out(out), _mode(MODE_MONITOR), _can(NULL), _stats(NULL), _statsWindow(0) {
+    lastSel = false; // Initial state assuming not pressed
+    lastUp = false;
+    lastDown = false;
+    lastDebounce = 0;
+}
+
+template <class HAL>
+void AppUIT<HAL>::begin() {
+    // HAL handles setup
+}
+
+template <class HAL>
+void AppUIT<HAL>::loop() {
+    handleButtons();
+    drawScreen();
+}
+
+template <class HAL>
+uint32_t AppUIT<HAL>::nextDeadline() const {
+    uint32_t now = _hal->getTickCount();
+    // 去彈跳期間內的按鍵要等視窗結束才會被處理
+    if (now - lastDebounce < DEBOUNCE_MS) return lastDebounce + DEBOUNCE_MS;
+    return now + REFRESH_MS;
+}
+
+template <class HAL>
+void AppUIT<HAL>::handleButtons() {
+    if (_hal->getTickCount() - lastDebounce < DEBOUNCE_MS) return;
+
+    bool s = _hal->readButton(BTN_SELECT);
+    bool u = _hal->readButton(BTN_UP);
+    bool d = _hal->readButton(BTN_DOWN);
+
+    PowerStatus st = _psu->getStatus();
+    float tmpV = st.voltageSet;
+    float tmpI = st.currentSet;
+    bool changed = false;
+
+    // Detect Rising Edge (Press)
+    if (s && !lastSel) {
+        lastDebounce = _hal->getTickCount();
+        _mode = nextMode();
+    }
+
+    if (u && !lastUp) {
+        lastDebounce = _hal->getTickCount();
+        if (_mode == MODE_SET_VOLTAGE) { tmpV += 1.0f; changed = true; }
+        if (_mode == MODE_SET_CURRENT) { tmpI += 1.0f; changed = true; }
+        if (_mode == MODE_MONITOR) { _out->powerOnAll(); }
+        if (_mode == MODE_STATS) { _statsWindow = (_statsWindow + 1) % RollingStats::STATS_WINDOWS; }
+    }
+
+    if (d && !lastDown) {
+        lastDebounce = _hal->getTickCount();
+        if (_mode == MODE_SET_VOLTAGE) { tmpV -= 1.0f; changed = true; }
+        if (_mode == MODE_SET_CURRENT) { tmpI -= 1.0f; changed = true; }
+        if (_mode == MODE_MONITOR) { _out->powerOffAll(); }
+        if (_mode == MODE_STATS) {
+            _statsWindow = (_statsWindow + RollingStats::STATS_WINDOWS - 1) % RollingStats::STATS_WINDOWS;
+        }
+    }
+
+    if (tmpV < 0) tmpV = 0;
+    if (tmpI < 0) tmpI = 0;
+
+    // 控制器擁有輸出時設定頁面只顯示，不改變設定值
+    if (changed && _out->isFree()) {
+        _psu->setOutput(tmpV, tmpI);
+    }
+
+    lastSel = s; lastUp = u; lastDown = d;
+}
+
+// SELECT: 監看 -> 設定電壓 -> 設定電流 -> [CAN 狀態] -> [統計] -> 監看
+template <class HAL>
+UIMode AppUIT<HAL>::nextMode() const {
+    switch (_mode) {
+        case MODE_MONITOR:     return MODE_SET_VOLTAGE;
+        case MODE_SET_VOLTAGE: return MODE_SET_CURRENT;
+        case MODE_SET_CURRENT:
+            if (_can) return MODE_CAN_STATUS;
+            return _stats ? MODE_STATS : MODE_MONITOR;
+        case MODE_CAN_STATUS:  return _stats ? MODE_STATS : MODE_MONITOR;
+        default:               return MODE_MONITOR;
+    }
+}
+
+template <class HAL>
+void AppUIT<HAL>::drawScreen() {
+    if (_mode == MODE_CAN_STATUS) {
+        drawCanStatus();
+        return;
+    }
+    if (_mode == MODE_STATS) {
+        drawStats();
+        return;
+    }
+
+    _hal->displayClear();
+    PowerStatus st = _psu->getStatus();
+    char buf[32];
+
+    // Header
+    snprintf(buf, sizeof(buf), "Addr:%d %s", _psu->getAddress(), 
+             st.isSoftStarting ? "SOFT" : (st.isOn ? "ON" : "OFF"));
+    _hal->displayDrawString(0, 0, buf, HAL_FONT_SMALL);
+    
+    // 依實際字寬排版: ACK 接在標題後面，BUS! 靠右
+    int headerW = _hal->displayTextWidth(buf, HAL_FONT_SMALL);
+    if(st.setCmdSuccess) _hal->displayDrawString(headerW + 6, 0, "ACK", HAL_FONT_SMALL);
+    // CAN Bus 異常或接近飽和時提示 (詳細資訊見 CAN 頁面)
+    if (_can && (!_can->isHealthy() || _can->isSaturated())) {
+        _hal->displayDrawString(SCREEN_WIDTH - _hal->displayTextWidth("BUS!", HAL_FONT_SMALL), 0, "BUS!", HAL_FONT_SMALL);
+    }
+
+    // Values
+    snprintf(buf, sizeof(buf), "V: %5.1f V", st.voltageOut);
+    _hal->displayDrawString(0, 20, buf, HAL_FONT_LARGE);
+
+    snprintf(buf, sizeof(buf), "I: %5.1f A", st.currentOut);
+    _hal->displayDrawString(0, 40, buf, HAL_FONT_LARGE);
+
+    // Footer
+    if (_mode == MODE_MONITOR) {
+        snprintf(buf, sizeof(buf), "Set: %.0fV %.1fA", st.voltageSet, st.currentSet);
+    } else if (_mode == MODE_SET_VOLTAGE) {
+        snprintf(buf, sizeof(buf), ">> Set Volt: %.1f", st.voltageSet);
+    } else if (_mode == MODE_SET_CURRENT) {
+        snprintf(buf, sizeof(buf), ">> Set Curr: %.1f", st.currentSet);
+    }
+    _hal->displayDrawString(0, 56, buf, HAL_FONT_SMALL);
+
+    _hal->displayShow();
+}
+
+template <class HAL>
+void AppUIT<HAL>::drawCanStatus() {
+    _hal->displayClear();
+    const HalCanStats& s = _can->stats();
+    char buf[48]; // 計數器很大時可能超過螢幕寬度 (21 字)
+
+    uint32_t load = _can->loadPermille();
+    snprintf(buf, sizeof(buf), "CAN %s %lu.%lu%%", _can->stateName(),
+             (unsigned long)(load / 10), (unsigned long)(load % 10));
+    _hal->displayDrawString(0, 0, buf, HAL_FONT_SMALL);
+
+    snprintf(buf, sizeof(buf), "TEC:%u REC:%u BO:%lu", s.txErrorCounter, s.rxErrorCounter,
+             (unsigned long)s.busOffCount);
+    _hal->displayDrawString(0, 14, buf, HAL_FONT_SMALL);
+
+    snprintf(buf, sizeof(buf), "%lu f/s %lu B/s", (unsigned long)_can->framesPerSec(),
+             (unsigned long)_can->bytesPerSec());
+    _hal->displayDrawString(0, 26, buf, HAL_FONT_SMALL);
+
+    snprintf(buf, sizeof(buf), "ARB:%lu MISS:%lu", (unsigned long)s.arbLost,
+             (unsigned long)(s.rxMissed + s.rxOverrun));
+    _hal->displayDrawString(0, 38, buf, HAL_FONT_SMALL);
+
+    snprintf(buf, sizeof(buf), "RXQ:%u/%u TXQ:%u/%u", s.rxQueueHigh, s.rxQueueSize,
+             s.txQueueHigh, s.txQueueSize);
+    _hal->displayDrawString(0, 50, buf, HAL_FONT_SMALL);
+
+    _hal->displayShow();
+}
+
+template <class HAL>
+void AppUIT<HAL>::drawStats() {
+    _hal->displayClear();
+    char buf[48];
+
+    uint32_t ms = _stats->channel(STAT_VOUT).windowMs(_statsWindow);
+    RollingStats::Result r;
+    uint16_t n = _stats->channel(STAT_VOUT).get(_statsWindow, r) ? r.count : 0;
+    snprintf(buf, sizeof(buf), "STATS %lus  N:%u", (unsigned long)(ms / 1000), n);
+    _hal->displayDrawString(0, 0, buf, HAL_FONT_SMALL);
+
+    // 每個通道一行: 平均值與峰對峰漣波
+    static const StatsChannel rows[] = { STAT_VOUT, STAT_IOUT, STAT_VIN };
+    for (int i = 0; i < 3; i++) {
+        if (_stats->channel(rows[i]).get(_statsWindow, r)) {
+            snprintf(buf, sizeof(buf), "%-2s %6.2f pp %5.2f", TelemetryStats::channelName(rows[i]), r.mean, r.ripple);
+        } else {
+            snprintf(buf, sizeof(buf), "%-2s   --", TelemetryStats::channelName(rows[i]));
+        }
+        _hal->displayDrawString(0, 14 + i * 12, buf, HAL_FONT_SMALL);
+    }
+
+    if (_stats->channel(STAT_IOUT).get(_statsWindow, r)) {
+        snprintf(buf, sizeof(buf), "I %.1f~%.1f rms%.2f", r.min, r.max, r.rms);
+        _hal->displayDrawString(0, 52, buf, HAL_FONT_SMALL);
+    }
+
+    _hal->displayShow();
+}
+
+#endif
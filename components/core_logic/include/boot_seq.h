@@ -0,0 +1,43 @@
+#ifndef BOOT_SEQ_H
+#define BOOT_SEQ_H
+
+#include "hal_interface.h"
+#include "psu_bus.h"
+#include "cmd_registry.h"
+
+struct BootReport {
+    HalBootTimes hal;
+    uint32_t probeMs;   // 從開始偵測到收到 PSU 回應 (或逾時)
+    uint32_t totalMs;   // 開機到偵測結束 (tick)
+    uint16_t probes;    // 查詢輪數 (每輪查詢所有尚未回應的模塊)
+    bool psuFound;
+};
+
+// 開機流程: 主動偵測 PSU 模塊，收到主模塊 (module 0) 的有效狀態回應就繼續，
+// 取代固定的 3 秒等待
+// 並聯時所有模塊共用 CAN 接收佇列，經由 PsuBus 接收並依位址分派，其他模塊的回應不會被丟棄
+class BootSequencer {
+public:
+    BootSequencer(IHardwareHAL* hal, PsuBus* bus);
+
+    // bus->begin() 之後呼叫; 回傳是否偵測到主模塊
+    bool run(uint32_t timeoutMs = BOOT_PROBE_TIMEOUT_MS);
+
+    const BootReport& report() const { return _report; }
+    void printReport();
+
+    // GET:BOOT -> 開機時間分析
+    void registerCommands(CmdRegistry& reg);
+
+private:
+    IHardwareHAL* _hal;
+    PsuBus* _bus;
+    BootReport _report;
+
+    void probeAll();
+
+    int formatReport(char* buf, size_t size) const;
+    static CmdResult cmdGetBoot(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef CAN_HEALTH_H
+#define CAN_HEALTH_H
+
+#include "hal_interface.h"
+#include "cmd_registry.h"
+#include "config_common.h"
+
+// CAN Bus 健康監控
+// - 週期性讀取 HAL 的 CAN 統計 (TEC/REC、仲裁失敗、佇列水位...)
+// - 每秒計算訊框數 / 位元組數與匯流排使用率，共用匯流排接近飽和時可提早發現
+// - bus-off 時自動啟動復原
+class CanHealth {
+public:
+    CanHealth(IHardwareHAL* hal);
+
+    void setAutoRecovery(bool enable) { _autoRecovery = enable; }
+    void loop();
+    uint32_t nextDeadline() const;
+
+    const HalCanStats& stats() const { return _stats; }
+    uint32_t framesPerSec() const { return _fps; }
+    uint32_t bytesPerSec() const { return _bps; }
+    uint32_t loadPermille() const { return _loadPermille; } // 匯流排使用率 (0.1%)
+    uint32_t recoveries() const { return _recoveries; }
+    bool isSaturated() const { return _loadPermille >= CAN_LOAD_WARN_PERMILLE; }
+    bool isHealthy() const; // 執行中且錯誤計數低於 warning (96)
+
+    // RUN / WARN / PASSIVE / BUSOFF / RECOV / STOP
+    const char* stateName() const;
+
+    // GET:CAN, CAN:RECOVER
+    void registerCommands(CmdRegistry& reg);
+
+private:
+    IHardwareHAL* _hal;
+    HalCanStats _stats;
+    bool _autoRecovery;
+    uint32_t _lastPoll;
+    uint32_t _lastRate;
+    uint32_t _busOffSince;
+    bool _busOff;
+    uint32_t _recoveries;
+
+    // 上一次計算流量時的累計值
+    uint32_t _prevFrames;
+    uint32_t _prevBytes;
+    uint32_t _fps;
+    uint32_t _bps;
+    uint32_t _loadPermille;
+
+    static const uint32_t RATE_INTERVAL_MS = 1000;
+    // 29-bit ID 訊框不含資料的位元數 (SOF..EOF + 3 bit 訊框間隔，不計 bit stuffing)
+    static const uint32_t EXT_FRAME_OVERHEAD_BITS = 67;
+
+    void poll(uint32_t now);
+    void updateRates(uint32_t now);
+
+    static CmdResult cmdGetCan(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdRecover(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef CHARGE_CTRL_H
+#define CHARGE_CTRL_H
+
+#include "hal_interface.h"
+#include "psu_protocol.h"
+#include "output_ctrl.h"
+#include "cmd_registry.h"
+#include "config_common.h"
+
+enum ChargeState {
+    CHG_IDLE = 0,
+    CHG_PRECHARGE,  // 深度放電: 小電流充到 prechargeV
+    CHG_CC,         // 定電流
+    CHG_CV,         // 定電壓，等待電流下降到截止電流
+    CHG_FLOAT,      // 浮充 (floatV = 0 時不進入)
+    CHG_DONE,
+    CHG_FAULT
+};
+
+// 結束原因
+enum ChargeEnd {
+    CHG_END_NONE = 0,
+    CHG_END_TAPER,   // 電流低於截止電流
+    CHG_END_AH,      // 達到充電量上限
+    CHG_END_TIME,    // 達到時間上限
+    CHG_END_STOP     // 手動停止
+};
+
+enum ChargeFault {
+    CHG_FAULT_NONE = 0,
+    CHG_FAULT_OV,        // 輸出電壓超過上限
+    CHG_FAULT_OC,        // 輸出電流超過設定值
+    CHG_FAULT_PSU,       // 模塊回報關機
+    CHG_FAULT_COMM,      // 模塊沒有回應
+    CHG_FAULT_PRECHARGE  // 預充逾時 (電池可能損壞)
+};
+
+struct ChargeParams {
+    float cvVolts;        // CV 電壓
+    float ccAmps;         // CC 電流
+    float taperAmps;      // 截止電流
+    float floatVolts;     // 浮充電壓 (0 = 充飽後關機)
+    float floatAmps;
+    float prechargeVolts; // 低於此電壓先預充 (0 = 不預充)
+    float prechargeAmps;
+    float maxAh;          // 0 = 不限制
+    uint32_t maxMinutes;  // 0 = 不限制 (不含浮充)，最多 CHARGE_MAX_MINUTES
+    float ovVolts;        // 過電壓上限 (0 = cvVolts x CHARGE_OV_RATIO)
+};
+
+// CC/CV 充電狀態機
+// 每次收到模塊狀態回報 (QUERY_INTERVAL_MS) 執行一次，以實測 voltageOut / currentOut 判斷，
+// 安全限制 (過電壓、過電流、模塊故障、通訊逾時) 只依電氣量判斷，不需要溫度感測器
+// 充電期間擁有輸出 (OutputControl)，均流 / 曲線執行中不能開始; 充電量取自主模塊的 EnergyMeter
+class ChargeController {
+public:
+    // psu: 量測與設定值的主模塊; 結束與保護跳脫經由 out 關閉所有並聯模塊
+    ChargeController(IHardwareHAL* hal, PowerProtocol* psu, OutputControl* out);
+
+    ChargeParams& params() { return _params; }
+    bool start(); // 參數無效或輸出被其他控制器擁有時回傳 false
+    void stop();
+
+    void loop();
+    uint32_t nextDeadline() const;
+
+    ChargeState state() const { return _state; }
+    bool isActive() const { return _state >= CHG_PRECHARGE && _state <= CHG_FLOAT; }
+    float chargedAh() const;
+    static const char* stateName(ChargeState st);
+
+    // CHG:SET=cv,cc,taper[,floatV,floatI], CHG:PRE=V,I, CHG:LIM=Ah,minutes[,ovV],
+    // CHG:START, CHG:STOP, GET:CHG
+    void registerCommands(CmdRegistry& reg);
+
+private:
+    IHardwareHAL* _hal;
+    PowerProtocol* _psu;
+    OutputControl* _out;
+    ChargeParams _params;
+    ChargeState _state;
+    ChargeEnd _end;
+    ChargeFault _fault;
+
+    uint32_t _startTime;
+    uint32_t _stateTime;
+    uint32_t _lastSample;   // 上一次處理的狀態回報時間 (PowerStatus::lastUpdate)
+    uint64_t _mAhStart;     // 開始 / 結束時 EnergyMeter 的累計值
+    uint64_t _mAhEnd;
+    float _limitAmps;       // 目前設定的電流限制
+    uint8_t _taperCount;
+    uint8_t _ocCount;
+    uint8_t _offCount;
+    bool _seenRunning;      // 開始後模塊是否回報過運轉
+
+    void process(const PowerStatus& st, uint32_t now);
+    bool checkSafety(const PowerStatus& st, uint32_t now);
+    void enter(ChargeState st, float volts, float amps);
+    void finish(ChargeEnd reason);
+    void trip(ChargeFault fault);
+    void notify();
+    static void onStop(void* ctx);
+
+    static CmdResult cmdSet(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdPre(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdLim(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdStart(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdStop(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef CMD_REGISTRY_H
+#define CMD_REGISTRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 指令格式: NAME 或 NAME=arg1,arg2,...
+// 參數 schema (每個字元代表一個參數):
+//   'f' 定點數 (x1000, 見 fixed_point.h)
+//   'u' 無號整數
+//   '?' 之後的參數為選填
+// 例: "f" = 一個必填定點數, "uf?ff" = 整數 + 定點數 + 兩個選填定點數
+
+static const int CMD_MAX_ARGS = 6;
+
+struct CmdArgs {
+    uint8_t count;
+    int32_t v[CMD_MAX_ARGS]; // 'f': 定點 x1000, 'u': 整數值
+
+    float asFloat(int i) const { return v[i] / 1000.0f; }
+    uint32_t asUint(int i) const { return (uint32_t)v[i]; }
+};
+
+enum CmdResult {
+    CMD_OK = 0,
+    CMD_ERR_UNKNOWN,  // 未知指令
+    CMD_ERR_ARGS,     // 參數格式錯誤 / 數量不符
+    CMD_ERR_RANGE,    // 參數超出範圍
+    CMD_ERR_STATE,    // 目前狀態不允許此指令
+    CMD_ERR_FULL      // 緩衝區 / 表格已滿
+};
+
+// 回傳 CMD_OK 時，reply 內容 (不含 \r\n) 會被送出; reply 為空字串則不回應
+typedef CmdResult (*CmdHandler)(void* ctx, const CmdArgs& args, char* reply, size_t replySize);
+
+// 指令表: 依名稱排序，二分搜尋分派
+// 其他模組可在初始化時呼叫 add() 註冊自己的指令
+class CmdRegistry {
+public:
+    CmdRegistry();
+
+    // name 與 schema 必須是靜態字串 (不會複製)
+    // 表格已滿或名稱重複時回傳 false，並記錄在 rejected() / firstRejected()
+    bool add(const char* name, const char* schema, CmdHandler handler, void* ctx);
+
+    // 解析並執行一行指令 (line 會被修改)
+    // 結果 (ACK 或 ERR:...) 寫入 reply; 空行回傳 CMD_OK 且 reply 為空
+    CmdResult dispatch(char* line, char* reply, size_t replySize);
+
+    static const char* resultName(CmdResult r);
+
+    int count() const { return _count; }
+    static int capacity() { return MAX_COMMANDS; }
+
+    // 註冊失敗的次數與第一個失敗的名稱: 啟動時檢查，指令不會被靜默丟棄
+    int rejected() const { return _rejected; }
+    const char* firstRejected() const { return _firstRejected; }
+
+private:
+    struct Entry {
+        const char* name;
+        const char* schema;
+        CmdHandler handler;
+        void* ctx;
+    };
+
+    static const int MAX_COMMANDS = 48;
+    Entry _entries[MAX_COMMANDS];
+    int _count;
+    int _rejected;
+    const char* _firstRejected;
+
+    const Entry* find(const char* name) const;
+    bool reject(const char* name);
+    static bool parseArgs(const char* schema, char* argStr, CmdArgs& args);
+};
+
+#endif // CMD_REGISTRY_H
@@ -1,10 +1,78 @@
 #ifndef CONFIG_COMMON_H
 #define CONFIG_COMMON_H
 
+// PSU 通訊協議 (編譯時選擇，見 psu_policy.h)
+#define PSU_BACKEND_LM_V2          1   // 聯明 V2.0
+#define PSU_BACKEND                PSU_BACKEND_LM_V2
+
 #define PSU_ADDRESS     1
 #define SOFT_START_INITIAL_CURRENT 10.0f
 #define SOFT_START_STEP_CURRENT    10.0f
 #define DEFAULT_TARGET_VOLTAGE     100.0f
 #define DEFAULT_TARGET_CURRENT     6.0f
 
+// 並聯模塊: 位址從 PSU_ADDRESS 起連續編號
+#define PSU_MAX_MODULES            4
+#define PSU_MODULE_COUNT           1
+#define PSU_MODULE_CAPACITY_A      60.0f   // 單一模塊額定電流 (LM100-6000AL)
+
+// 均流控制: 每 SHARE_REBALANCE_MS 依實測電流修正分配，
+// 超過 SHARE_STALE_MS 沒有狀態回報視為故障並立即重新分配
+#define SHARE_REBALANCE_MS         1000
+#define SHARE_STALE_MS             250
+
+// CAN Bus 健康監控: 每 CAN_HEALTH_POLL_MS 讀取一次狀態，每秒計算流量
+// bus-off 後等待 CAN_RECOVERY_DELAY_MS 再自動復原 (避免故障的匯流排上反覆 bus-off)
+// 匯流排使用率超過 CAN_LOAD_WARN_PERMILLE (0.1%) 視為飽和
+#define CAN_HEALTH_POLL_MS         100
+#define CAN_RECOVERY_DELAY_MS      1000
+#define CAN_LOAD_WARN_PERMILLE     700
+
+// 電壓/電流曲線 (Profile) 最大步驟數
+#define PROFILE_MAX_STEPS          32
+
+// 充電控制 (CC/CV)
+// - 電壓達到 CV 設定值的 CHARGE_CV_ENTRY_RATIO 且電流開始下降時進入 CV
+// - CV 階段電流連續 CHARGE_TAPER_SAMPLES 次 (狀態回報) 低於截止電流即結束
+// - 電流超過限制值 x CHARGE_OC_RATIO + 1 A 連續 CHARGE_FAULT_SAMPLES 次視為過電流
+// - 超過 CHARGE_COMM_TIMEOUT_MS 沒有狀態回報立即停止
+// - 開機後模塊回報關機的判定延後到第一次回報運轉或 CHARGE_STARTUP_MS 之後 (模塊啟動時間)
+// - 時間上限最多 CHARGE_MAX_MINUTES (tick 為 32-bit ms，約 49 天回繞)
+#define CHARGE_CV_ENTRY_RATIO      0.99f
+#define CHARGE_TAPER_SAMPLES       10
+#define CHARGE_OC_RATIO            1.2f
+#define CHARGE_OV_RATIO            1.05f   // 未設定過電壓上限時使用 CV 電壓 x 此比例
+#define CHARGE_FAULT_SAMPLES       3
+#define CHARGE_COMM_TIMEOUT_MS     1000
+#define CHARGE_PRECHARGE_TIMEOUT_MS (30UL * 60 * 1000)
+#define CHARGE_STARTUP_MS          5000
+#define CHARGE_MAX_MINUTES         (14UL * 24 * 60)
+
+// 電量累計: 相鄰兩個狀態訊框間隔超過 ENERGY_MAX_GAP_MS 不積分 (資料遺失)
+// 累計值每 ENERGY_SAVE_INTERVAL_MS 寫入一次 storage (有變化時)
+#define ENERGY_MAX_GAP_MS          1000
+#define ENERGY_SAVE_INTERVAL_MS    (5UL * 60 * 1000)
+
+// 滾動統計: 三個時間視窗 (可用 STAT:WIN 調整)，每個視窗最多保留 *_SAMPLES 個樣本 (2 的次方)
+// 狀態回報 10 Hz，所以 WINDOWn_SAMPLES x 100ms 就是該視窗可設定的最長時間
+// 第三個視窗必須是最大的，它的樣本數同時也是每個通道的原始樣本 ring 大小
+#define STATS_WINDOW1_MS           1000
+#define STATS_WINDOW2_MS           10000
+#define STATS_WINDOW3_MS           60000
+#define STATS_WINDOW1_SAMPLES      64
+#define STATS_WINDOW2_SAMPLES      256
+#define STATS_WINDOW3_SAMPLES      1024
+// 背景查詢 AC 輸入電壓的週期 (只進統計，不主動回報 AC=)
+#define STATS_AC_POLL_MS           1000
+
+// 開機偵測: 每 BOOT_PROBE_INTERVAL_MS 送一次狀態查詢，收到回應即繼續，
+// 超過 BOOT_PROBE_TIMEOUT_MS 仍無回應也繼續 (主迴圈會持續查詢)
+#define BOOT_PROBE_INTERVAL_MS     20
+#define BOOT_PROBE_TIMEOUT_MS      3000
+
+// 設定儲存: 最後一次修改後靜止 CONFIG_SAVE_DELAY_MS 才寫入，
+// 持續修改時最晚 CONFIG_SAVE_MAX_DELAY_MS 也會寫入一次
+#define CONFIG_SAVE_DELAY_MS       2000
+#define CONFIG_SAVE_MAX_DELAY_MS   10000
+
 #endif
\ No newline at end of file
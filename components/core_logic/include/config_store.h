@@ -0,0 +1,96 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include "hal_interface.h"
+#include "config_common.h"
+#include "cmd_registry.h"
+
+// 執行期設定 (預設值來自 config_common.h，儲存在 HAL storage)
+enum ConfigKey {
+    CFG_PSU_ADDRESS = 0,
+    CFG_TARGET_VOLTAGE,
+    CFG_TARGET_CURRENT,
+    CFG_SOFT_START_INITIAL,
+    CFG_SOFT_START_STEP,
+    CFG_KEY_COUNT
+};
+
+enum ConfigType {
+    CFG_TYPE_U32,
+    CFG_TYPE_FLOAT
+};
+
+struct ConfigDef {
+    const char* key;     // storage key (<= 15 字元)
+    const char* cmd;     // UART 指令名稱 (CFG:xxx=value)
+    ConfigType type;
+    uint32_t defU32;
+    float defFloat;
+};
+
+// CFG:xxx 指令寫入前呼叫，回傳 false 時指令回覆 CMD_ERR_STATE (例如控制器擁有輸出時的 CFG:V / CFG:I)
+typedef bool (*ConfigWriteGuard)(void* ctx, ConfigKey key);
+
+// 讀取全部快取在 RAM; 寫入會延遲合併 (debounce)，
+// 連續調整按鍵或 UART 設定不會每次都寫 flash
+class ConfigStore {
+public:
+    ConfigStore(IHardwareHAL* hal);
+
+    void begin();  // 從 storage 載入，不存在的 key 使用預設值
+    void loop();   // 處理延遲寫入，每次最多寫一個 key
+    uint32_t nextDeadline() const;
+
+    uint32_t getU32(ConfigKey key) const { return _values[key].u; }
+    float getFloat(ConfigKey key) const { return _values[key].f; }
+    void setU32(ConfigKey key, uint32_t value);
+    void setFloat(ConfigKey key, float value);
+
+    void resetDefaults();
+    void flush();        // 立即寫入所有變更
+    bool isDirty() const { return _dirty != 0; }
+
+    // 每次值改變時遞增，讓使用者判斷是否需要重新套用設定
+    uint32_t revision() const { return _revision; }
+    uint32_t commitCount() const { return _commits; }
+
+    static const ConfigDef& def(ConfigKey key);
+
+    // CFG:<NAME>=value, GET:CFG, CFG:SAVE, CFG:RESET
+    void registerCommands(CmdRegistry& reg);
+    void setWriteGuard(ConfigWriteGuard fn, void* ctx) { _guard = fn; _guardCtx = ctx; }
+
+private:
+    union Value {
+        uint32_t u;
+        float f;
+    };
+
+    struct CmdSlot {
+        ConfigStore* owner;
+        ConfigKey key;
+    };
+
+    IHardwareHAL* _hal;
+    Value _values[CFG_KEY_COUNT];
+    uint32_t _dirty;       // bit mask
+    uint32_t _firstDirty;  // 第一次變更時間
+    uint32_t _lastChange;  // 最後一次變更時間
+    bool _flushing;
+    uint32_t _revision;
+    uint32_t _commits;
+    CmdSlot _slots[CFG_KEY_COUNT];
+    ConfigWriteGuard _guard;
+    void* _guardCtx;
+
+    void markDirty(ConfigKey key);
+    void writeKey(ConfigKey key);
+    void commit();
+
+    static CmdResult cmdSet(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdSave(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdReset(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
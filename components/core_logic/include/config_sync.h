@@ -0,0 +1,39 @@
+#ifndef CONFIG_SYNC_H
+#define CONFIG_SYNC_H
+
+#include "config_store.h"
+#include "psu_protocol.h"
+#include "output_ctrl.h"
+
+// ConfigStore 與主模塊設定值的同步 (主迴圈在 serial.loop() 之後呼叫 loop())
+// - CFG:V / CFG:I / CFG:RESET 改變了儲存的 V/I -> 套用到 PSU
+// - 按鍵 / SET:V / SET:I 改變了 PSU 的設定值 -> 寫回 ConfigStore (延遲合併寫入)
+// - CFG:SS_INIT / CFG:SS_STEP -> 套用軟啟動參數 (控制器擁有輸出時也套用)
+// 均流、曲線或充電擁有輸出時設定值由控制器產生: 不套用也不寫回，CFG:V / CFG:I 被拒絕;
+// 控制器釋放輸出後保留它留下的設定值 (例如 PROF:ABORT 的 0 A、最後一個步驟的電壓) 並寫回 ConfigStore，
+// 不會重新套用儲存的 V/I
+class ConfigSync {
+public:
+    ConfigSync(ConfigStore* config, PowerProtocol* psu, OutputControl* out);
+
+    // 開機時 (config.begin() 與 bus.begin() 之後) 套用儲存的設定值，並安裝 CFG:V / CFG:I 的寫入保護
+    void begin();
+    void loop();
+
+private:
+    ConfigStore* _config;
+    PowerProtocol* _psu;
+    OutputControl* _out;
+    uint32_t _revision; // 上次同步時的 ConfigStore revision
+    float _volts;       // 上次同步時 ConfigStore 的 V/I (與 PSU 設定值相同)
+    float _amps;
+    float _ssInitial;
+    float _ssStep;
+    bool _owned;        // 上次同步時輸出被控制器擁有
+
+    void applySoftStart();
+    void storeSetpoints(const PowerStatus& st);
+    static bool guard(void* ctx, ConfigKey key);
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef ENERGY_LOG_H
+#define ENERGY_LOG_H
+
+#include "hal_interface.h"
+#include "psu_bus.h"
+#include "cmd_registry.h"
+
+// 電量紀錄: 所有模塊的輸出電能 / 電荷合計
+// - lifetime: 累計總量，不會被重設
+// - session: 上一次 ENERGY:RESET 之後的量
+// 兩者都儲存在 HAL storage，重新開機後接續累計
+// (開機後到上一次儲存之間的電量在斷電時會遺失，最多 ENERGY_SAVE_INTERVAL_MS)
+class EnergyLog {
+public:
+    EnergyLog(IHardwareHAL* hal, PsuBus* bus);
+
+    void begin();  // 從 storage 載入
+    void loop();   // 定期儲存
+    uint32_t nextDeadline() const;
+
+    uint64_t lifetimeMilliWh() const;
+    uint64_t lifetimeMilliAh() const;
+    uint64_t sessionMilliWh() const;
+    uint64_t sessionMilliAh() const;
+
+    void resetSession();
+    void save();
+
+    // GET:ENERGY, ENERGY:RESET, ENERGY:SAVE
+    void registerCommands(CmdRegistry& reg);
+
+private:
+    // storage 格式 (key "energy")
+    struct Record {
+        uint64_t lifeMilliWh;
+        uint64_t lifeMilliAh;
+        uint64_t sessionMilliWh;
+        uint64_t sessionMilliAh;
+    };
+
+    IHardwareHAL* _hal;
+    PsuBus* _bus;
+    Record _saved;        // 上一次儲存 (或載入) 的值
+    uint64_t _baseWh;     // 當時各模塊開機後累計的合計
+    uint64_t _baseAh;
+    uint32_t _lastSave;
+
+    uint64_t busMilliWh() const;
+    uint64_t busMilliAh() const;
+
+    static CmdResult cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdReset(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdSave(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
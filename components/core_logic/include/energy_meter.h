@@ -0,0 +1,45 @@
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <stdint.h>
+#include "config_common.h"
+
+// 電能 / 電荷積分器 (每個狀態訊框呼叫一次)
+// - 以訊框接收時間戳做梯形積分，原始單位 (0.1 V / 0.1 A) 直接相乘，全程整數運算
+// - 64-bit 定點累加: 未滿 1 mWh / 1 mAh 的部分留在餘數，滿一單位才進位到整數計數，
+//   整數計數以 mWh 為單位，實際上不會溢位
+class EnergyMeter {
+public:
+    EnergyMeter() { reset(); }
+
+    void reset();
+    // rawV / rawI: 訊框原始值 (0.1 V / 0.1 A); timestampUs: 接收時間 (溢位回繞)
+    void addSample(uint16_t rawV, uint16_t rawI, uint32_t timestampUs);
+
+    uint64_t milliWattHours() const { return _mWh; }
+    uint64_t milliAmpHours() const { return _mAh; }
+    uint32_t samples() const { return _samples; }
+    uint32_t gaps() const { return _gaps; } // 間隔過長未積分的次數
+
+private:
+    bool _hasPrev;
+    uint16_t _prevV;
+    uint16_t _prevI;
+    uint32_t _prevTs;
+
+    uint64_t _mWh;
+    uint64_t _whFrac;
+    uint64_t _mAh;
+    uint64_t _ahFrac;
+    uint32_t _samples;
+    uint32_t _gaps;
+
+    // 梯形積分的單位:
+    //   電荷 (I0 + I1) x dt = 0.05 A·us  -> 1 mAh = 3.6e6 A·us = 7.2e7 單位
+    //   電能 (P0 + P1) x dt = 0.005 W·us -> 1 mWh = 3.6e6 W·us = 7.2e8 單位
+    static const uint64_t UNITS_PER_MAH = 72000000ULL;
+    static const uint64_t UNITS_PER_MWH = 720000000ULL;
+    static const uint32_t MAX_GAP_US = ENERGY_MAX_GAP_MS * 1000UL;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+// 不依賴 locale 的定點數解析 (取代 strtof)
+// "12.345" -> 12345 (scale = 1000)，小數超過 3 位時四捨五入
+// 成功回傳 true，*end 指向第一個未使用的字元
+// 溢位、沒有任何數字時回傳 false
+bool parseFixed(const char* str, int32_t* out, const char** end);
+
+// 無號整數 (十進位)
+bool parseUint(const char* str, uint32_t* out, const char** end);
+
+static const int32_t FIXED_SCALE = 1000;
+
+inline float fixedToFloat(int32_t v) { return v / (float)FIXED_SCALE; }
+
+#endif // FIXED_POINT_H
@@ -10,6 +10,66 @@ struct HalCanFrame {
     uint8_t data[8];
     uint8_t len;
     bool ext; // true for extended frame
+    uint32_t timestampUs; // 接收時間 (us，溢位回繞)，canReceive() 填入; 送出時忽略
+};
+
+// CAN 控制器狀態 (對應 TWAI 驅動狀態)
+enum HalCanState {
+    HAL_CAN_STOPPED = 0,
+    HAL_CAN_RUNNING,
+    HAL_CAN_BUS_OFF,
+    HAL_CAN_RECOVERING
+};
+
+// CAN Bus 健康資訊，計數器自驅動啟動後累計 (溢位回繞)
+struct HalCanStats {
+    HalCanState state;
+    uint32_t bitrate;         // bit/s
+    uint16_t txErrorCounter;  // TEC (>= 128 error passive, 256 bus-off)
+    uint16_t rxErrorCounter;  // REC
+    uint32_t arbLost;         // 仲裁失敗次數
+    uint32_t busErrors;       // bit/stuff/form/ACK 錯誤
+    uint32_t rxMissed;        // RX queue 滿而丟棄的訊框
+    uint32_t rxOverrun;       // 硬體 FIFO 溢位
+    uint32_t txFailed;        // 傳送失敗 (含 bus-off 時被丟棄)
+    uint32_t busOffCount;     // 進入 bus-off 的次數
+    uint32_t txFrames;        // 成功送出 / 收到的訊框與資料位元組
+    uint32_t rxFrames;
+    uint32_t txBytes;
+    uint32_t rxBytes;
+    uint16_t rxQueueLen;      // 目前佇列長度
+    uint16_t txQueueLen;
+    uint16_t rxQueueHigh;     // 佇列長度最高水位
+    uint16_t txQueueHigh;
+    uint16_t rxQueueSize;     // 佇列容量
+    uint16_t txQueueSize;
+};
+
+// Tick 比較 (處理 uint32_t 溢位回繞): a 是否早於 b
+inline bool halTickBefore(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+// 兩個期限中較早者 (組合各模組的 nextDeadline())
+inline uint32_t halTickMin(uint32_t a, uint32_t b) {
+    return halTickBefore(a, b) ? a : b;
+}
+
+// waitEvents() 回傳的事件 (bit mask)，0 表示等到期限
+enum HalEvent {
+    HAL_EVT_CAN    = 1u << 0,  // 收到 CAN 訊框或匯流排狀態改變
+    HAL_EVT_UART   = 1u << 1,  // 收到完整一行 (換行字元)
+    HAL_EVT_BUTTON = 1u << 2   // 按鍵電位改變
+};
+
+// 各硬體初始化階段耗時 (us)，由 BootSequencer 回報開機時間分析
+struct HalBootTimes {
+    uint32_t gpioUs;
+    uint32_t canUs;
+    uint32_t uartUs;
+    uint32_t storageUs;
+    uint32_t displayUs; // 顯示器初始化可能在背景進行，尚未完成時為 0
+    uint32_t initUs;    // init() 本身的總耗時 (不含背景工作)
 };
 
 // 定義按鍵索引
@@ -19,16 +79,35 @@ enum HalButton {
     BTN_DOWN
 };
 
+// 顯示字型 slot: HAL 實作在初始化時註冊字型並快取解析後的字型資訊，
+// 繪圖時只切換 slot，不會每個字串重新解析字型標頭
+enum HalFont {
+    HAL_FONT_SMALL = 0,
+    HAL_FONT_LARGE = 1,
+    HAL_FONT_COUNT
+};
+
+struct HalFontMetrics {
+    int8_t ascent;    // 基線以上的高度 (大寫 A)
+    int8_t descent;   // 基線以下 (通常為負值)
+    int8_t maxWidth;  // 最寬字元的寬度
+    int8_t maxHeight; // 字元框的總高度
+};
+
 // HAL 介面定義
 class IHardwareHAL {
 public:
     virtual ~IHardwareHAL() {}
 
     virtual void init() = 0; 
+    virtual void getBootTimes(HalBootTimes& out) = 0;
 
     // System
     virtual uint32_t getTickCount() = 0; // 回傳毫秒 (ms)
     virtual void delayMs(uint32_t ms) = 0;
+    // 阻塞直到有事件發生或 getTickCount() 到達 deadline，回傳 HalEvent mask
+    // 期間發生的事件會累積，下一次呼叫立即回傳 (不會遺失)
+    virtual uint32_t waitEvents(uint32_t deadline) = 0;
 
     // GPIO
     virtual bool readButton(HalButton btn) = 0; // 回傳 true 表示按下 (處理 Active Low)
@@ -36,16 +115,30 @@ public:
     // CAN Bus
     virtual bool canSend(const HalCanFrame& frame) = 0;
     virtual bool canReceive(HalCanFrame& frame) = 0;
+    // 讀取狀態時一併處理驅動的 alert (例如 bus-off 復原完成後重新啟動控制器)
+    virtual void canGetStats(HalCanStats& out) = 0;
+    // 從 bus-off 開始復原 (需等待 128 x 11 個隱性位元)，非 bus-off 狀態回傳 false
+    virtual bool canRecover() = 0;
 
     // UART (Serial)
     virtual void uartSend(const char* str) = 0;
     virtual int uartRead() = 0; // 回傳 -1 表示無資料
     virtual int uartAvailable() = 0;
 
+    // Storage (Key/Value, ESP32: NVS, Host: 檔案)
+    // key 最長 15 字元; 讀取時 key 不存在或長度不符回傳 false
+    // storageWrite() 只寫入暫存，storageCommit() 才真正寫入 flash
+    virtual bool storageRead(const char* key, void* buf, size_t len) = 0;
+    virtual bool storageWrite(const char* key, const void* buf, size_t len) = 0;
+    virtual bool storageCommit() = 0;
+
     // Display (OLED) - 簡化版介面
     virtual void displayClear() = 0;
-    virtual void displayDrawString(int x, int y, const char* str, int fontSize) = 0; // fontSize: 0=Small, 1=Large
+    virtual void displayDrawString(int x, int y, const char* str, int fontSize) = 0; // fontSize: HalFont slot
     virtual void displayShow() = 0;
+    // 文字量測 (版面配置用，不需要試畫; 顯示器尚未就緒時也可呼叫)
+    virtual int displayTextWidth(const char* str, int fontSize) = 0;
+    virtual void displayFontMetrics(int fontSize, HalFontMetrics& out) = 0;
 };
 
 #endif // HAL_INTERFACE_H
\ No newline at end of file
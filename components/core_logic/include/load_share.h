@@ -0,0 +1,58 @@
+#ifndef LOAD_SHARE_H
+#define LOAD_SHARE_H
+
+#include "hal_interface.h"
+#include "output_ctrl.h"
+#include "cmd_registry.h"
+
+// 並聯模塊均流控制
+// - 總電流目標依各模塊額定容量比例分配
+// - 每 SHARE_REBALANCE_MS 依實測電流微調 (積分修正)，讓各模塊負載率一致
+// - 只分配給運轉中的模塊; 模塊故障 (狀態顯示關機或超過 SHARE_STALE_MS 無回報) 時同一個 loop 內重新分配
+// - 啟用期間擁有輸出 (OutputControl)，powerOffAll() 時自動停用
+class LoadShare {
+public:
+    LoadShare(IHardwareHAL* hal, OutputControl* out);
+
+    void setCapacity(int idx, float amps);
+    bool setTarget(float volts, float totalAmps); // 啟用均流並開啟所有模塊; 其他控制器擁有輸出時回傳 false
+    void disable();
+    bool isEnabled() const { return _enabled; }
+
+    void loop(); // 在 bus.loop() 之後呼叫
+    uint32_t nextDeadline() const;
+
+    float limitOf(int idx) const { return _limit[idx]; }
+    bool isHealthy(int idx) const { return (_healthy >> idx) & 1; }
+    float availableAmps() const; // 健康模塊的容量總和
+
+    // SHARE:I=total[,volts], SHARE:OFF, GET:SHARE
+    void registerCommands(CmdRegistry& reg);
+
+private:
+    IHardwareHAL* _hal;
+    OutputControl* _out;
+    PsuBus* _bus;
+    bool _enabled;
+    float _volts;
+    float _totalAmps;
+    float _capacity[PSU_MAX_MODULES];
+    float _limit[PSU_MAX_MODULES];
+    float _trim[PSU_MAX_MODULES];
+    uint32_t _healthy;    // bit mask
+    uint32_t _lastRebalance;
+
+    static const float TRIM_GAIN;      // 每次修正的比例
+    static const float TRIM_MAX_RATIO; // 修正量上限 (相對基準分配)
+
+    uint32_t checkHealth(uint32_t now) const;
+    void distribute(bool useMeasured);
+    void apply();
+    static void onStop(void* ctx);
+
+    static CmdResult cmdShare(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdShareOff(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdGetShare(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
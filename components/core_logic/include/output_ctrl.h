@@ -0,0 +1,44 @@
+#ifndef OUTPUT_CTRL_H
+#define OUTPUT_CTRL_H
+
+#include "psu_bus.h"
+
+// 輸出的擁有者: 同一時間只有一個控制器可以產生設定值
+enum OutputOwner {
+    OUT_OWNER_NONE = 0,
+    OUT_OWNER_SHARE,    // LoadShare 均流
+    OUT_OWNER_PROFILE,  // ProfileSequencer 曲線
+    OUT_OWNER_CHARGER   // ChargeController 充電
+};
+
+// 控制器被 powerOffAll() 中止時的通知 (只重設自己的狀態，不可再送出設定值)
+typedef void (*OutputStopFn)(void* ctx);
+
+// 並聯模塊的輸出控制
+// - powerOffAll(): OFF 指令、按鍵、充電保護都經由這裡關閉 bus 上的每一台模塊，
+//   並先通知目前的擁有者停止，避免關機後又被控制器寫入設定值
+// - powerOnAll(): ON 指令、按鍵、SHARE:I 開啟 bus 上的每一台模塊 (只開主模塊時均流會分配給沒有輸出的模塊)
+class OutputControl {
+public:
+    OutputControl(PsuBus* bus);
+
+    // 成功取得 (或已經擁有) 時回傳 true; 其他控制器擁有時回傳 false
+    bool acquire(OutputOwner who, OutputStopFn onStop, void* ctx);
+    void release(OutputOwner who);
+    OutputOwner owner() const { return _owner; }
+    bool isFree() const { return _owner == OUT_OWNER_NONE; }
+    static const char* ownerName(OutputOwner who);
+
+    void powerOffAll();
+    void powerOnAll();
+
+    PsuBus* bus() { return _bus; }
+
+private:
+    PsuBus* _bus;
+    OutputOwner _owner;
+    OutputStopFn _onStop;
+    void* _stopCtx;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef PROFILE_SEQ_H
+#define PROFILE_SEQ_H
+
+#include "hal_interface.h"
+#include "psu_protocol.h"
+#include "output_ctrl.h"
+#include "cmd_registry.h"
+#include "config_common.h"
+
+// 步驟結束條件
+enum ProfileCond {
+    PROF_COND_TIME = 0,    // 經過 durationMs
+    PROF_COND_V_ABOVE,     // 輸出電壓 >= condValue (durationMs 為逾時，0 = 不逾時)
+    PROF_COND_I_BELOW      // 輸出電流 <= condValue (durationMs 為逾時，0 = 不逾時)
+};
+
+struct ProfileStep {
+    uint32_t durationMs;
+    float volts;
+    float amps;
+    uint8_t cond;          // ProfileCond
+    float condValue;
+};
+
+enum ProfileState {
+    PROF_EMPTY = 0,  // 沒有步驟
+    PROF_READY,      // 已載入，等待 PROF:RUN
+    PROF_RUNNING,
+    PROF_PAUSED,
+    PROF_DONE,
+    PROF_ABORTED
+};
+
+// 電壓/電流曲線序列器
+// 由主機上傳步驟表後在控制器上依時間執行 (透過 PowerProtocol::setOutput)，
+// 步驟時間以步驟開始的時間點累加計算，不受 UART / 主機延遲影響，也不會累積誤差
+// 執行中 (RUNNING / PAUSED) 擁有輸出 (OutputControl)，充電 / 均流期間不能開始
+class ProfileSequencer {
+public:
+    ProfileSequencer(IHardwareHAL* hal, PowerProtocol* psu, OutputControl* out);
+
+    // 只有在非執行中 (RUNNING / PAUSED) 時可以修改步驟表
+    bool clear();
+    bool addStep(const ProfileStep& step);
+
+    bool start(uint32_t loops); // loops = 0 表示無限循環; 輸出被其他控制器擁有時回傳 false
+    bool pause();
+    bool resume();
+    void abort();               // 電流設為 0，保留電壓設定
+
+    void loop();
+    uint32_t nextDeadline() const;
+
+    ProfileState state() const { return _state; }
+    bool isActive() const { return _state == PROF_RUNNING || _state == PROF_PAUSED; }
+    int stepIndex() const { return _step; }
+    int stepCount() const { return _count; }
+    uint32_t loopIndex() const { return _loop; }
+    static const char* stateName(ProfileState st);
+
+    // PROF:ADD=ms,V,I[,cond,value], PROF:CLR, PROF:RUN[=loops], PROF:PAUSE, PROF:RESUME,
+    // PROF:ABORT, GET:PROF
+    void registerCommands(CmdRegistry& reg);
+
+private:
+    IHardwareHAL* _hal;
+    PowerProtocol* _psu;
+    OutputControl* _out;
+    ProfileStep _steps[PROFILE_MAX_STEPS];
+    int _count;
+    ProfileState _state;
+    int _step;
+    uint32_t _loop;
+    uint32_t _loops;
+    uint32_t _stepStart;   // 目前步驟開始時間 (tick)
+    uint32_t _pausedAt;
+
+    void enterStep(int idx, uint32_t at);
+    bool stepDone(const ProfileStep& st, uint32_t now, uint32_t* end) const;
+    void notify(const char* event);
+    static void onStop(void* ctx);
+
+    static CmdResult cmdAdd(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdClear(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdRun(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdPause(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdResume(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdAbort(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef PSU_BUS_H
+#define PSU_BUS_H
+
+#include "hal_interface.h"
+#include "psu_protocol.h"
+
+// 同一條 CAN Bus 上的多台模塊
+// 統一接收 CAN 訊框並依位址分派給對應的 PowerProtocol
+// 其他模組 (OutputControl、BootSequencer...) 持有 PsuBus*; loop() 經由 IHardwareHAL 的 vtable
+// 主迴圈改用 PsuBusT<具體 HAL>，熱路徑的 CAN 接收與 tick 直接呼叫 (見下方)
+class PsuBus {
+public:
+    PsuBus(IHardwareHAL* hal);
+
+    // 回傳的指標在 PsuBus 生命週期內有效; 已滿時回傳 NULL
+    PowerProtocol* addModule();
+    // 初始化所有模塊，位址為 baseAddr, baseAddr+1, ...
+    void begin(uint8_t baseAddr);
+    void loop() { pump(_hal); }
+
+    int count() const { return _count; }
+    PowerProtocol* module(int idx) { return (idx >= 0 && idx < _count) ? &_modules[idx] : NULL; }
+    const PowerProtocol* module(int idx) const { return (idx >= 0 && idx < _count) ? &_modules[idx] : NULL; }
+
+    uint32_t nextDeadline() const { return deadlineAfter(_hal->getTickCount()); }
+    uint32_t unmatchedFrames() const { return _unmatched; }
+
+protected:
+    // 1. CAN Receive: 由協議 policy 從 ID 取出位址
+    // 2. 各模塊的定時工作
+    template <class HAL>
+    void pump(HAL* hal) {
+        HalCanFrame frame;
+        uint32_t now = hal->getTickCount();
+        while (hal->canReceive(frame)) dispatch(frame, now);
+        for (int i = 0; i < _count; i++) _modules[i].service(now);
+    }
+    void dispatch(const HalCanFrame& frame, uint32_t now);
+    uint32_t deadlineAfter(uint32_t now) const;
+
+private:
+    IHardwareHAL* _hal;
+    PowerProtocol _modules[PSU_MAX_MODULES];
+    int _count;
+    int8_t _byAddr[PsuPolicy::ADDR_COUNT];  // 模塊位址 -> 模塊索引, -1 表示無
+    uint32_t _unmatched;
+};
+
+// 以具體 HAL 類別具現化的 bus (例: PsuBusT<Esp32HAL>，由 main 選擇)
+// HAL 宣告為 final 時 loop() / nextDeadline() 的 HAL 呼叫為直接呼叫 (定義可見時 inline)
+// 模擬 / 測試使用 PsuBus 或 PsuBusT<IHardwareHAL>，可替換任意 HAL
+template <class HAL>
+class PsuBusT : public PsuBus {
+public:
+    PsuBusT(HAL* hal) : PsuBus(hal), _hw(hal) {}
+
+    void loop() { pump(_hw); }
+    uint32_t nextDeadline() const { return deadlineAfter(_hw->getTickCount()); }
+
+private:
+    HAL* _hw;
+};
+
+#endif
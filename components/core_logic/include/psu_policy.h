@@ -0,0 +1,44 @@
+#ifndef PSU_POLICY_H
+#define PSU_POLICY_H
+
+#include "hal_interface.h"
+#include "config_common.h"
+
+// PSU 通訊協議 policy (編譯時選擇，沒有虛擬呼叫)
+// PowerProtocol / PsuBus 只透過 PsuPolicy 的 static inline 函數編碼 / 解碼 CAN 訊框，
+// 其餘模組 (AppUI、SerialCmd、LoadShare...) 只看到與廠牌無關的 PowerProtocol
+//
+// 新增廠牌時實作一個具有相同 static 成員的 struct，並在下方加上 PSU_BACKEND 分支:
+//   ADDR_COUNT                               位址數量 (PsuBus 分派表大小)
+//   uint8_t addressOf(uint32_t id)           回應訊框的模塊位址 (0 .. ADDR_COUNT-1)
+//   void encodeQueryStatus(addr, frame)      查詢輸出狀態
+//   void encodeQueryInput(addr, frame)       查詢 AC 輸入電壓
+//   void encodeSetOutput(addr, V, A, frame)  設定電壓 / 電流
+//   void encodePower(addr, on, frame)        開 / 關機
+//   bool decode(addr, frame, msg)            不屬於 addr 的訊框回傳 false
+
+// 解碼後的訊息，數值一律轉成以下固定單位
+enum PsuMsgType {
+    PSU_MSG_OTHER = 0,   // 屬於此模塊但不需處理
+    PSU_MSG_STATUS,      // rawV (0.1 V)、rawI (0.1 A)、hwOff
+    PSU_MSG_POWER_ACK,   // ok
+    PSU_MSG_SET_ACK,     // ok
+    PSU_MSG_INPUT        // rawV (1/32 V)
+};
+
+struct PsuMsg {
+    PsuMsgType type;
+    uint16_t rawV;
+    uint16_t rawI;
+    bool hwOff;
+    bool ok;
+};
+
+#if PSU_BACKEND == PSU_BACKEND_LM_V2
+#include "psu_policy_lm_v2.h"
+typedef LmV2Policy PsuPolicy;
+#else
+#error "Unknown PSU_BACKEND"
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef PSU_POLICY_LM_V2_H
+#define PSU_POLICY_LM_V2_H
+
+// 請 include "psu_policy.h"，由 PSU_BACKEND 選擇
+#ifndef PSU_POLICY_H
+#error "Include psu_policy.h instead of psu_policy_lm_v2.h"
+#endif
+
+#include <string.h>
+
+// 聯明 V2.0 CAN 協議 (29-bit ID = 基底 + 位址，位址在低 7 bits)
+struct LmV2Policy {
+    static const int ADDR_COUNT = 128;
+
+    static const uint32_t ID_CMD_SET     = 0x1907C080;
+    static const uint32_t ID_CMD_QUERY   = 0x1907C080;
+    static const uint32_t ID_RESP_STATUS = 0x1807C080;
+    static const uint32_t ID_CMD_QUERY_IN  = 0x1907A080;
+    static const uint32_t ID_RESP_INPUT    = 0x1807A080;
+
+    static inline uint8_t addressOf(uint32_t id) { return (uint8_t)(id & 0x7F); }
+
+    static inline void encodeQueryStatus(uint8_t addr, HalCanFrame& frame) {
+        header(frame, ID_CMD_QUERY + addr);
+        frame.data[0] = 0x01;
+    }
+
+    static inline void encodeQueryInput(uint8_t addr, HalCanFrame& frame) {
+        header(frame, ID_CMD_QUERY_IN + addr);
+        frame.data[0] = 0x31;
+    }
+
+    // 電流 / 電壓以 mA / mV 傳送 (24 / 32 bits, big-endian)
+    static inline void encodeSetOutput(uint8_t addr, float voltageV, float currentA, HalCanFrame& frame) {
+        header(frame, ID_CMD_SET + addr);
+        uint32_t iVal = (uint32_t)(currentA * 1000);
+        uint32_t vVal = (uint32_t)(voltageV * 1000);
+
+        frame.data[0] = 0x00;
+        frame.data[1] = (iVal >> 16) & 0xFF;
+        frame.data[2] = (iVal >> 8) & 0xFF;
+        frame.data[3] = iVal & 0xFF;
+        frame.data[4] = (vVal >> 24) & 0xFF;
+        frame.data[5] = (vVal >> 16) & 0xFF;
+        frame.data[6] = (vVal >> 8) & 0xFF;
+        frame.data[7] = vVal & 0xFF;
+    }
+
+    static inline void encodePower(uint8_t addr, bool on, HalCanFrame& frame) {
+        header(frame, ID_CMD_SET + addr);
+        frame.data[0] = 0x02; // CMD=2
+        frame.data[7] = on ? 0x55 : 0xAA;
+    }
+
+    static inline bool decode(uint8_t addr, const HalCanFrame& frame, PsuMsg& msg) {
+        msg.type = PSU_MSG_OTHER;
+        if (frame.id == ID_RESP_STATUS + addr) {
+            uint8_t cmdType = frame.data[0];
+            if (cmdType == 0x01) {
+                msg.type = PSU_MSG_STATUS;
+                msg.rawI = (frame.data[2] << 8) | frame.data[3];
+                msg.rawV = (frame.data[4] << 8) | frame.data[5];
+                msg.hwOff = (frame.data[7] & 0x01);
+            } else if (cmdType == 0x02) {
+                msg.type = PSU_MSG_POWER_ACK;
+                msg.ok = (frame.data[1] != 0);
+            } else {
+                msg.type = PSU_MSG_SET_ACK;
+                msg.ok = (frame.data[0] != 0);
+            }
+            return true;
+        }
+        if (frame.id == ID_RESP_INPUT + addr) {
+            if (frame.data[0] == 0x31) {
+                msg.type = PSU_MSG_INPUT;
+                msg.rawV = (frame.data[2] << 8) | frame.data[3];
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static inline void header(HalCanFrame& frame, uint32_t id) {
+        frame.id = id;
+        frame.len = 8;
+        frame.ext = true;
+        memset(frame.data, 0, 8);
+    }
+};
+
+#endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "hal_interface.h"
 #include "config_common.h"
+#include "psu_policy.h"
+#include "energy_meter.h"
 #include <string.h> // for memset
 
 struct PowerStatus {
@@ -20,25 +22,60 @@ struct PowerStatus {
     uint32_t lastUpdate;
 };
 
+// 每個量測訊框的原始值 (交給 setSampleListener() 註冊的監聽者，例如滾動統計)
+struct PsuSample {
+    bool input;           // true: AC 輸入電壓 (rawV 單位 1/32 V, rawI 無效); false: 輸出 (0.1 V / 0.1 A)
+    uint16_t rawV;
+    uint16_t rawI;
+    uint32_t timestampUs; // 訊框接收時間
+};
+typedef void (*PsuSampleListener)(void* ctx, const PsuSample& sample);
+
+// 單一模塊的協議狀態; CAN 接收由 PsuBus 統一處理後分派 (單一模塊時 bus 上只有一台)
+// 接收路徑不呼叫 HAL (時間由 bus 傳入)，只有送出訊框 (設定值變化、100 ms 查詢) 經由 IHardwareHAL
 class PowerProtocol {
 public:
-    PowerProtocol(IHardwareHAL* hal);
+    PowerProtocol(IHardwareHAL* hal = NULL);
     void init(uint8_t addr);
-    void loop();
+
+    // now: bus 本次 loop 讀取的 tick (ms)
+    bool handleFrame(const HalCanFrame& frame, uint32_t now); // 不屬於此模塊時回傳 false
+    void service(uint32_t now);  // 軟啟動與週期查詢
     
     void setOutput(float voltageV, float currentA);
     void setPower(bool on);
+    void setSoftStart(float initialA, float stepA) { _softStartInitial = initialA; _softStartStep = stepA; }
+    uint8_t getAddress() const { return _addr; }
     void queryInputVoltage();
+    void probe() { queryStatus(); } // 開機偵測: 立即送出狀態查詢
+    bool hasResponded() const { return _responded; }
+    // 最近 timeoutMs 內是否收到狀態回報
+    bool isOnline(uint32_t now, uint32_t timeoutMs) const {
+        return _responded && (now - _status.lastUpdate) < timeoutMs;
+    }
     void clearInputFlag() { _status.newInputVoltage = false; }
     
     PowerStatus getStatus() const { return _status; }
+    // 開機後的輸出電能 / 電荷累計 (每個狀態訊框積分)
+    const EnergyMeter& energy() const { return _energy; }
+    // 每收到一筆輸出 / 輸入電壓量測就呼叫一次 (只支援一個監聽者)
+    void setSampleListener(PsuSampleListener fn, void* ctx) { _listener = fn; _listenerCtx = ctx; }
+
+    // 下一次 service() 需要執行定時工作的時間點 (ms, 絕對 tick)
+    uint32_t nextDeadline() const;
+
+    static const uint32_t QUERY_INTERVAL_MS = 100;
 
 private:
     IHardwareHAL* _hal;
     uint8_t _addr;
     PowerStatus _status;
+    EnergyMeter _energy;
+    PsuSampleListener _listener;
+    void* _listenerCtx;
     
     bool _startupCheckDone;
+    bool _responded;
     uint32_t _lastQueryTime;
     
     // Soft Start
@@ -47,17 +84,15 @@ private:
     float _targetAmps;
     float _rampingAmps;
     uint32_t _lastRampTime;
+    float _softStartInitial;
+    float _softStartStep;
 
-    // CAN IDs
-    static const uint32_t ID_CMD_SET     = 0x1907C080;
-    static const uint32_t ID_CMD_QUERY   = 0x1907C080;
-    static const uint32_t ID_RESP_STATUS = 0x1807C080;
-    static const uint32_t ID_CMD_QUERY_IN  = 0x1907A080;
-    static const uint32_t ID_RESP_INPUT    = 0x1807A080;
+    static const uint32_t RAMP_INTERVAL_MS  = 100;
 
     void queryStatus();
     void sendSetCommand(float voltage, float current);
-    void parseFrame(const HalCanFrame& frame);
+    void applyMessage(const PsuMsg& msg, uint32_t timestampUs, uint32_t now);
+    void notifySample(bool input, uint16_t rawV, uint16_t rawI, uint32_t timestampUs);
 };
 
 #endif
\ No newline at end of file
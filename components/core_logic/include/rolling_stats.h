@@ -0,0 +1,74 @@
+#ifndef ROLLING_STATS_H
+#define ROLLING_STATS_H
+
+#include <stdint.h>
+#include "config_common.h"
+
+// 單一通道的滾動統計 (min / max / mean / RMS / ripple)，同時維護 STATS_WINDOWS 個時間視窗
+// - 原始整數樣本存在一個 ring，所有視窗共用
+// - 每個視窗: 累計和 / 平方和 + 單調 deque 求 min/max，每個樣本 O(1) (攤銷)，不重新計算
+// - 視窗以時間淘汰 (expire)，樣本數達到容量時也淘汰最舊的樣本
+class RollingStats {
+public:
+    static const int STATS_WINDOWS = 3;
+
+    struct Result {
+        uint16_t count;
+        float min;
+        float max;
+        float mean;
+        float rms;
+        float ripple;  // 峰對峰值 (max - min)
+    };
+
+    // scale: 原始值 x scale = 工程單位 (例如 0.1 V)
+    explicit RollingStats(float scale);
+
+    void reset();
+    void add(uint16_t raw, uint32_t nowMs);
+    // 淘汰超過視窗時間的樣本 (沒有新樣本時也要定期呼叫)
+    void expire(uint32_t nowMs);
+
+    // 變更視窗時間並清空該視窗
+    void setWindow(int w, uint32_t ms);
+    uint32_t windowMs(int w) const { return _win[w].lengthMs; }
+    uint16_t windowCapacity(int w) const { return _win[w].cap; }
+
+    // 視窗內沒有樣本時回傳 false
+    bool get(int w, Result& out) const;
+
+private:
+    static const uint16_t RING_SIZE = STATS_WINDOW3_SAMPLES;
+    static const uint16_t RING_MASK = RING_SIZE - 1;
+    static const int POOL_SIZE = STATS_WINDOW1_SAMPLES + STATS_WINDOW2_SAMPLES + STATS_WINDOW3_SAMPLES;
+
+    // deque 存放樣本序號 (uint16 回繞)；head / tail 也是回繞計數器，以 cap - 1 遮罩
+    struct Window {
+        uint32_t lengthMs;
+        uint16_t cap;
+        uint16_t count;
+        uint16_t base;   // 在 _pool 中的位置: [base, base+cap) 為 max deque (值遞減)，其後 cap 個為 min deque (值遞增)
+        uint16_t maxHead, maxTail;
+        uint16_t minHead, minTail;
+        uint32_t sum;
+        uint64_t sumSq;
+    };
+
+    float _scale;
+    uint16_t _seq;                // 下一個樣本的序號
+    uint16_t _raw[RING_SIZE];
+    uint32_t _time[RING_SIZE];
+    Window _win[STATS_WINDOWS];
+    uint16_t _pool[2 * POOL_SIZE];
+
+    void clearWindow(Window& w);
+    void popOldest(Window& w);
+    void pushBack(Window& w, uint16_t seq, uint16_t raw);
+    uint16_t rawAt(uint16_t seq) const { return _raw[seq & RING_MASK]; }
+    uint16_t* maxQ(Window& w) { return &_pool[w.base]; }
+    uint16_t* minQ(Window& w) { return &_pool[w.base + w.cap]; }
+    const uint16_t* maxQ(const Window& w) const { return &_pool[w.base]; }
+    const uint16_t* minQ(const Window& w) const { return &_pool[w.base + w.cap]; }
+};
+
+#endif
\ No newline at end of file
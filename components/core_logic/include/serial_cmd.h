@@ -3,24 +3,50 @@
 
 #include "hal_interface.h"
 #include "psu_protocol.h"
+#include "output_ctrl.h"
+#include "cmd_registry.h"
 
-class SerialCmd {
+// HAL: UART 使用的 HAL 類別 (與 AppUIT 相同)
+// - SerialCmd (= SerialCmdT<IHardwareHAL>): 透過 vtable 呼叫，core_logic 內已具現化 (serial_cmd.cpp)
+// - SerialCmdT<具體 HAL>: 直接呼叫; 使用者 include "serial_cmd_impl.h" 具現化
+template <class HAL>
+class SerialCmdT {
 public:
-    SerialCmd(IHardwareHAL* hal, PowerProtocol* psu);
+    // psu: 設定與回報的主模塊; ON / OFF 經由 out 開啟 / 關閉所有並聯模塊
+    SerialCmdT(HAL* hal, PowerProtocol* psu, OutputControl* out);
     void begin();
     void loop();
+    uint32_t nextDeadline() const { return _lastReportTime + REPORT_INTERVAL_MS; }
+
+    // 其他模組透過這裡註冊自己的 UART 指令
+    CmdRegistry& registry() { return _registry; }
 
 private:
-    IHardwareHAL* _hal;
+    HAL* _hal;
     PowerProtocol* _psu;
+    OutputControl* _out;
+    CmdRegistry _registry;
     
     static const int BUF_SIZE = 64;
+    static const uint32_t REPORT_INTERVAL_MS = 100;
     char _inputBuffer[BUF_SIZE];
     int _bufIndex;
+    bool _overflow;
+    bool _acRequested; // GET:AC 之後等待回應
     uint32_t _lastReportTime;
 
     void processCommand(char* cmd);
     void sendPeriodicReport();
+
+    // 內建指令
+    static CmdResult cmdOn(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdOff(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdSetV(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdSetI(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdGetAc(void* ctx, const CmdArgs& args, char* reply, size_t size);
 };
 
+extern template class SerialCmdT<IHardwareHAL>;
+typedef SerialCmdT<IHardwareHAL> SerialCmd;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+#ifndef SERIAL_CMD_IMPL_H
+#define SERIAL_CMD_IMPL_H
+
+// SerialCmdT 的成員定義: 只由具現化的編譯單元 include (core_logic 的 serial_cmd.cpp、選用具體 HAL 的 main)
+#include "serial_cmd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+template <class HAL>
+SerialCmdT<HAL>::SerialCmdT(HAL* hal, PowerProtocol* psu, OutputControl* out)
+    : _hal(hal), _psu(psu), _out(out), _bufIndex(0), _overflow(false), _acRequested(false), _lastReportTime(0) {
+    memset(_inputBuffer, 0, BUF_SIZE);
+
+    _registry.add("ON",     "",  cmdOn,    this);
+    _registry.add("OFF",    "",  cmdOff,   this);
+    _registry.add("SET:V",  "f", cmdSetV,  this);
+    _registry.add("SET:I",  "f", cmdSetI,  this);
+    _registry.add("GET:AC", "",  cmdGetAc, this);
+}
+
+template <class HAL>
+void SerialCmdT<HAL>::begin() {
+    // UART init is handled by HAL
+}
+
+template <class HAL>
+void SerialCmdT<HAL>::loop() {
+    // 1. Receive Char
+    while (_hal->uartAvailable()) {
+        int c = _hal->uartRead();
+        if (c != -1) {
+            if (c == '\n') {
+                _inputBuffer[_bufIndex] = '\0';
+                // Remove \r if present
+                if (_bufIndex > 0 && _inputBuffer[_bufIndex-1] == '\r') {
+                    _inputBuffer[_bufIndex-1] = '\0';
+                }
+                if (_overflow) {
+                    _hal->uartSend("ERR:OVERFLOW\r\n");
+                } else {
+                    processCommand(_inputBuffer);
+                }
+                _bufIndex = 0;
+                _overflow = false;
+            } else if (_bufIndex < BUF_SIZE - 1) {
+                _inputBuffer[_bufIndex++] = (char)c;
+            } else {
+                _overflow = true;
+            }
+        }
+    }
+
+    // 2. Periodic Report
+    if (_hal->getTickCount() - _lastReportTime >= REPORT_INTERVAL_MS) {
+        sendPeriodicReport();
+        _lastReportTime = _hal->getTickCount();
+    }
+
+    // AC 電壓也會被統計模組在背景查詢，只有 GET:AC 要求過才回報
+    if (_psu->getStatus().newInputVoltage) {
+        if (_acRequested) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "AC=%.1f\r\n", _psu->getStatus().inputVoltage);
+            _hal->uartSend(buf);
+            _acRequested = false;
+        }
+        _psu->clearInputFlag();
+    }
+}
+
+template <class HAL>
+void SerialCmdT<HAL>::sendPeriodicReport() {
+    PowerStatus st = _psu->getStatus();
+    char buf[64];
+    snprintf(buf, sizeof(buf), "V=%.1f,I=%.1f\r\n", st.voltageOut, st.currentOut);
+    _hal->uartSend(buf);
+}
+
+template <class HAL>
+void SerialCmdT<HAL>::processCommand(char* cmd) {
+    char reply[192]; // GET:CAN 等診斷回應較長
+    _registry.dispatch(cmd, reply, sizeof(reply) - 2);
+    if (reply[0] != '\0') {
+        strcat(reply, "\r\n");
+        _hal->uartSend(reply);
+    }
+}
+
+template <class HAL>
+CmdResult SerialCmdT<HAL>::cmdOn(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    SerialCmdT* self = (SerialCmdT*)ctx;
+    (void)args;
+    self->_out->powerOnAll();
+    snprintf(reply, size, "CMD_ACK:ON");
+    return CMD_OK;
+}
+
+template <class HAL>
+CmdResult SerialCmdT<HAL>::cmdOff(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    SerialCmdT* self = (SerialCmdT*)ctx;
+    (void)args;
+    self->_out->powerOffAll();
+    snprintf(reply, size, "CMD_ACK:OFF");
+    return CMD_OK;
+}
+
+template <class HAL>
+CmdResult SerialCmdT<HAL>::cmdSetV(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    SerialCmdT* self = (SerialCmdT*)ctx;
+    if (args.v[0] < 0) return CMD_ERR_RANGE;
+    if (!self->_out->isFree()) return CMD_ERR_STATE; // 設定值由均流 / 曲線 / 充電控制
+    float v = args.asFloat(0);
+    self->_psu->setOutput(v, self->_psu->getStatus().currentSet);
+    snprintf(reply, size, "CMD_ACK:SET_V:%.1f", v);
+    return CMD_OK;
+}
+
+template <class HAL>
+CmdResult SerialCmdT<HAL>::cmdSetI(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    SerialCmdT* self = (SerialCmdT*)ctx;
+    if (args.v[0] < 0) return CMD_ERR_RANGE;
+    if (!self->_out->isFree()) return CMD_ERR_STATE;
+    float i = args.asFloat(0);
+    self->_psu->setOutput(self->_psu->getStatus().voltageSet, i);
+    snprintf(reply, size, "CMD_ACK:SET_I:%.1f", i);
+    return CMD_OK;
+}
+
+template <class HAL>
+CmdResult SerialCmdT<HAL>::cmdGetAc(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    SerialCmdT* self = (SerialCmdT*)ctx;
+    (void)args;
+    self->_psu->queryInputVoltage();
+    self->_acRequested = true;
+    snprintf(reply, size, "CMD_ACK:QUERY_AC");
+    return CMD_OK;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TELEMETRY_STATS_H
+#define TELEMETRY_STATS_H
+
+#include "hal_interface.h"
+#include "psu_protocol.h"
+#include "rolling_stats.h"
+#include "cmd_registry.h"
+#include "config_common.h"
+
+enum StatsChannel {
+    STAT_VOUT = 0,
+    STAT_IOUT,
+    STAT_VIN,      // AC 輸入電壓 (背景每 STATS_AC_POLL_MS 查詢一次)
+    STAT_CHANNELS
+};
+
+// 遙測滾動統計: 輸出電壓 / 電流與 AC 輸入電壓在 1s / 10s / 60s (預設) 視窗內的
+// min / max / mean / RMS / ripple，不需要把每個原始樣本傳到 PC 就能看漣波與穩定度
+// - 樣本直接來自 PowerProtocol 的量測訊框 (原始整數值)，不受主迴圈延遲影響
+// - 約 34 KB，請配置為 static，不要放在 task stack 上
+class TelemetryStats {
+public:
+    TelemetryStats(IHardwareHAL* hal, PowerProtocol* psu);
+
+    void begin();  // 註冊 PSU 量測監聽者
+    void loop();   // 淘汰過期樣本、AC 背景查詢、週期回報
+    uint32_t nextDeadline() const;
+
+    const RollingStats& channel(StatsChannel c) const { return _ch[c]; }
+    static const char* channelName(StatsChannel c);
+
+    // GET:STAT[=視窗], STAT:WIN=視窗,秒, STAT:AUTO=ms
+    void registerCommands(CmdRegistry& reg);
+
+private:
+    IHardwareHAL* _hal;
+    PowerProtocol* _psu;
+    RollingStats _ch[STAT_CHANNELS];
+    uint32_t _lastAcPoll;
+    uint32_t _autoMs;       // 0 = 不主動回報
+    uint32_t _autoWindow;
+    uint32_t _lastAuto;
+
+    static void onSample(void* ctx, const PsuSample& sample);
+    void formatWindow(int w, char* buf, size_t size) const;
+
+    static CmdResult cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdWindow(void* ctx, const CmdArgs& args, char* reply, size_t size);
+    static CmdResult cmdAuto(void* ctx, const CmdArgs& args, char* reply, size_t size);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "boot_seq.h"
+#include <stdio.h>
+#include <string.h>
+
+BootSequencer::BootSequencer(IHardwareHAL* hal, PsuBus* bus)
+    : _hal(hal), _bus(bus) {
+    memset(&_report, 0, sizeof(_report));
+}
+
+// 查詢還沒有回應的模塊
+void BootSequencer::probeAll() {
+    for (int i = 0; i < _bus->count(); i++) {
+        PowerProtocol* m = _bus->module(i);
+        if (!m->hasResponded()) m->probe();
+    }
+}
+
+bool BootSequencer::run(uint32_t timeoutMs) {
+    _hal->getBootTimes(_report.hal);
+
+    PowerProtocol* psu = _bus->module(0);
+    uint32_t start = _hal->getTickCount();
+    uint32_t lastProbe = start;
+    probeAll();
+    _report.probes = 1;
+
+    while (psu && !psu->hasResponded()) {
+        uint32_t now = _hal->getTickCount();
+        if (now - start >= timeoutMs) break;
+
+        if (now - lastProbe >= BOOT_PROBE_INTERVAL_MS) {
+            probeAll();
+            _report.probes++;
+            lastProbe = now;
+        }
+        _bus->loop();
+        if (!psu->hasResponded()) {
+            // 等待 CAN 回應或下一次查詢 / 逾時，回應到達時立即繼續
+            _hal->waitEvents(halTickMin(lastProbe + BOOT_PROBE_INTERVAL_MS, start + timeoutMs));
+        }
+    }
+
+    uint32_t end = _hal->getTickCount();
+    _report.probeMs = end - start;
+    _report.totalMs = end;
+    _report.psuFound = psu && psu->hasResponded();
+
+    // 顯示器可能在偵測期間於背景完成初始化，重新讀取一次
+    _hal->getBootTimes(_report.hal);
+    return _report.psuFound;
+}
+
+int BootSequencer::formatReport(char* buf, size_t size) const {
+    const HalBootTimes& h = _report.hal;
+    return snprintf(buf, size, "BOOT:GPIO=%lu,CAN=%lu,UART=%lu,NVS=%lu,OLED=%lu,INIT=%lu,PROBE=%lu,N=%u,TOTAL=%lu,PSU=%s",
+                    (unsigned long)(h.gpioUs / 1000), (unsigned long)(h.canUs / 1000),
+                    (unsigned long)(h.uartUs / 1000), (unsigned long)(h.storageUs / 1000),
+                    (unsigned long)(h.displayUs / 1000),
+                    (unsigned long)(h.initUs / 1000), (unsigned long)_report.probeMs,
+                    (unsigned)_report.probes, (unsigned long)_report.totalMs,
+                    _report.psuFound ? "OK" : "TIMEOUT");
+}
+
+void BootSequencer::printReport() {
+    char buf[128];
+    formatReport(buf, sizeof(buf) - 2);
+    strcat(buf, "\r\n");
+    _hal->uartSend(buf);
+}
+
+void BootSequencer::registerCommands(CmdRegistry& reg) {
+    reg.add("GET:BOOT", "", cmdGetBoot, this);
+}
+
+CmdResult BootSequencer::cmdGetBoot(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ((BootSequencer*)ctx)->formatReport(reply, size);
+    return CMD_OK;
+}
@@ -0,0 +1,117 @@
+#include "can_health.h"
+#include <stdio.h>
+#include <string.h>
+
+CanHealth::CanHealth(IHardwareHAL* hal)
+    : _hal(hal), _autoRecovery(true), _lastPoll(0), _lastRate(0),
+      _busOffSince(0), _busOff(false), _recoveries(0),
+      _prevFrames(0), _prevBytes(0), _fps(0), _bps(0), _loadPermille(0) {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void CanHealth::loop() {
+    uint32_t now = _hal->getTickCount();
+    if (now - _lastPoll < CAN_HEALTH_POLL_MS) return;
+    _lastPoll = now;
+    poll(now);
+}
+
+uint32_t CanHealth::nextDeadline() const {
+    return _lastPoll + CAN_HEALTH_POLL_MS;
+}
+
+void CanHealth::poll(uint32_t now) {
+    _hal->canGetStats(_stats);
+
+    // 1. 流量統計
+    if (now - _lastRate >= RATE_INTERVAL_MS) {
+        updateRates(now);
+    }
+
+    // 2. bus-off 自動復原: 進入 bus-off 後等待一段時間才復原，
+    //    匯流排本身故障 (短路 / 無終端) 時不會每 100ms 反覆 bus-off
+    if (_stats.state != HAL_CAN_BUS_OFF) {
+        _busOff = false;
+        return;
+    }
+    if (!_busOff) {
+        _busOff = true;
+        _busOffSince = now;
+    }
+    if (_autoRecovery && now - _busOffSince >= CAN_RECOVERY_DELAY_MS) {
+        if (_hal->canRecover()) _recoveries++;
+        _busOffSince = now;
+    }
+}
+
+void CanHealth::updateRates(uint32_t now) {
+    uint32_t elapsed = now - _lastRate;
+    uint32_t frames = _stats.txFrames + _stats.rxFrames;
+    uint32_t bytes = _stats.txBytes + _stats.rxBytes;
+    _lastRate = now;
+
+    uint32_t dFrames = frames - _prevFrames;
+    uint32_t dBytes = bytes - _prevBytes;
+    _prevFrames = frames;
+    _prevBytes = bytes;
+    if (elapsed == 0) return;
+
+    _fps = (uint32_t)((uint64_t)dFrames * 1000 / elapsed);
+    _bps = (uint32_t)((uint64_t)dBytes * 1000 / elapsed);
+    if (_stats.bitrate > 0) {
+        uint64_t bits = (uint64_t)dFrames * EXT_FRAME_OVERHEAD_BITS + (uint64_t)dBytes * 8;
+        _loadPermille = (uint32_t)(bits * 1000 * 1000 / ((uint64_t)_stats.bitrate * elapsed));
+    }
+}
+
+bool CanHealth::isHealthy() const {
+    return _stats.state == HAL_CAN_RUNNING && _stats.txErrorCounter < 96 && _stats.rxErrorCounter < 96;
+}
+
+const char* CanHealth::stateName() const {
+    switch (_stats.state) {
+        case HAL_CAN_BUS_OFF:    return "BUSOFF";
+        case HAL_CAN_RECOVERING: return "RECOV";
+        case HAL_CAN_STOPPED:    return "STOP";
+        case HAL_CAN_RUNNING:    break;
+    }
+    uint16_t worst = (_stats.txErrorCounter > _stats.rxErrorCounter) ? _stats.txErrorCounter : _stats.rxErrorCounter;
+    if (worst >= 128) return "PASSIVE";
+    if (worst >= 96) return "WARN";
+    return "RUN";
+}
+
+// --- UART Commands ---
+
+void CanHealth::registerCommands(CmdRegistry& reg) {
+    reg.add("GET:CAN",     "", cmdGetCan,  this);
+    reg.add("CAN:RECOVER", "", cmdRecover, this);
+}
+
+// CAN:ST=RUN,TEC=0,REC=0,ARB=0,BERR=0,MISS=0,OVR=0,TXF=0,BOFF=0,RCV=0,FPS=20,BPS=160,LOAD=11.2,RXQ=1/16,TXQ=1/8
+CmdResult CanHealth::cmdGetCan(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    CanHealth* self = (CanHealth*)ctx;
+    self->_hal->canGetStats(self->_stats);
+    const HalCanStats& s = self->_stats;
+    snprintf(reply, size,
+             "CAN:ST=%s,TEC=%u,REC=%u,ARB=%lu,BERR=%lu,MISS=%lu,OVR=%lu,TXF=%lu,BOFF=%lu,RCV=%lu,"
+             "FPS=%lu,BPS=%lu,LOAD=%lu.%lu,RXQ=%u/%u,TXQ=%u/%u",
+             self->stateName(), s.txErrorCounter, s.rxErrorCounter,
+             (unsigned long)s.arbLost, (unsigned long)s.busErrors, (unsigned long)s.rxMissed,
+             (unsigned long)s.rxOverrun, (unsigned long)s.txFailed, (unsigned long)s.busOffCount,
+             (unsigned long)self->_recoveries, (unsigned long)self->_fps, (unsigned long)self->_bps,
+             (unsigned long)(self->_loadPermille / 10), (unsigned long)(self->_loadPermille % 10),
+             s.rxQueueHigh, s.rxQueueSize, s.txQueueHigh, s.txQueueSize);
+    return CMD_OK;
+}
+
+// 手動復原 (不等待 CAN_RECOVERY_DELAY_MS)
+CmdResult CanHealth::cmdRecover(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    CanHealth* self = (CanHealth*)ctx;
+    if (!self->_hal->canRecover()) return CMD_ERR_STATE;
+    self->_recoveries++;
+    snprintf(reply, size, "CMD_ACK:CAN_RECOVER");
+    return CMD_OK;
+}
@@ -0,0 +1,290 @@
+#include "charge_ctrl.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* END_NAMES[] = { "NONE", "TAPER", "AH", "TIME", "STOP" };
+static const char* FAULT_NAMES[] = { "NONE", "OV", "OC", "PSU", "COMM", "PRECHARGE" };
+
+ChargeController::ChargeController(IHardwareHAL* hal, PowerProtocol* psu, OutputControl* out)
+    : _hal(hal), _psu(psu), _out(out), _state(CHG_IDLE), _end(CHG_END_NONE), _fault(CHG_FAULT_NONE),
+      _startTime(0), _stateTime(0), _lastSample(0), _mAhStart(0), _mAhEnd(0), _limitAmps(0),
+      _taperCount(0), _ocCount(0), _offCount(0), _seenRunning(false) {
+    memset(&_params, 0, sizeof(_params));
+    _params.cvVolts = DEFAULT_TARGET_VOLTAGE;
+    _params.ccAmps = DEFAULT_TARGET_CURRENT;
+    _params.taperAmps = DEFAULT_TARGET_CURRENT * 0.1f;
+}
+
+bool ChargeController::start() {
+    if (isActive() || _params.cvVolts <= 0 || _params.ccAmps <= 0) return false;
+    if (!_out->acquire(OUT_OWNER_CHARGER, onStop, this)) return false;
+
+    uint32_t now = _hal->getTickCount();
+    PowerStatus st = _psu->getStatus();
+    _startTime = now;
+    _lastSample = st.lastUpdate; // 只處理開始之後的狀態回報
+    _mAhStart = _psu->energy().milliAmpHours();
+    _mAhEnd = _mAhStart;
+    _offCount = 0;
+    _seenRunning = false;
+    _end = CHG_END_NONE;
+    _fault = CHG_FAULT_NONE;
+
+    if (_params.prechargeVolts > 0 && st.voltageOut < _params.prechargeVolts) {
+        enter(CHG_PRECHARGE, _params.cvVolts, _params.prechargeAmps);
+    } else {
+        enter(CHG_CC, _params.cvVolts, _params.ccAmps);
+    }
+    // 軟啟動仍由 PowerProtocol 處理 (等待接觸器吸合後才爬升到設定電流)
+    if (!st.isOn) _psu->setPower(true);
+    return true;
+}
+
+void ChargeController::stop() {
+    if (!isActive()) return;
+    _end = CHG_END_STOP;
+    _state = CHG_DONE;
+    _mAhEnd = _psu->energy().milliAmpHours();
+    _out->powerOffAll();
+    notify();
+}
+
+// 其他來源 (OFF 指令 / 按鍵) 已關閉所有模塊: 視為手動停止
+void ChargeController::onStop(void* ctx) {
+    ChargeController* self = (ChargeController*)ctx;
+    if (!self->isActive()) return;
+    self->_end = CHG_END_STOP;
+    self->_state = CHG_DONE;
+    self->_mAhEnd = self->_psu->energy().milliAmpHours();
+    self->notify();
+}
+
+// 結束後固定在結束時的值 (之後手動開機的電量不計入)
+float ChargeController::chargedAh() const {
+    uint64_t mAh = isActive() ? _psu->energy().milliAmpHours() : _mAhEnd;
+    return (float)(mAh - _mAhStart) / 1000.0f;
+}
+
+void ChargeController::enter(ChargeState st, float volts, float amps) {
+    _state = st;
+    _stateTime = _hal->getTickCount();
+    _limitAmps = amps;
+    _taperCount = 0;
+    _ocCount = 0;
+    _psu->setOutput(volts, amps);
+    notify();
+}
+
+void ChargeController::finish(ChargeEnd reason) {
+    _end = reason;
+    // 只有正常充飽 (電流截止) 才進入浮充; 達到 Ah / 時間上限表示異常，直接關機
+    if (reason == CHG_END_TAPER && _params.floatVolts > 0) {
+        enter(CHG_FLOAT, _params.floatVolts, _params.floatAmps > 0 ? _params.floatAmps : _params.ccAmps);
+        return;
+    }
+    _psu->setOutput(_params.cvVolts, 0.0f);
+    _state = CHG_DONE;
+    _mAhEnd = _psu->energy().milliAmpHours();
+    _out->powerOffAll();
+    notify();
+}
+
+void ChargeController::trip(ChargeFault fault) {
+    _fault = fault;
+    _state = CHG_FAULT;
+    _mAhEnd = _psu->energy().milliAmpHours();
+    _out->powerOffAll();
+    notify();
+}
+
+void ChargeController::loop() {
+    if (!isActive()) return;
+    uint32_t now = _hal->getTickCount();
+    PowerStatus st = _psu->getStatus();
+
+    if (st.lastUpdate != _lastSample) {
+        process(st, now);
+        _lastSample = st.lastUpdate;
+        return;
+    }
+
+    // 沒有新的狀態回報: 模塊失聯時不能繼續充電
+    uint32_t ref = halTickBefore(_lastSample, _startTime) ? _startTime : _lastSample;
+    if (now - ref >= CHARGE_COMM_TIMEOUT_MS) trip(CHG_FAULT_COMM);
+}
+
+uint32_t ChargeController::nextDeadline() const {
+    if (!isActive()) return _hal->getTickCount() + CHARGE_COMM_TIMEOUT_MS;
+    uint32_t ref = halTickBefore(_lastSample, _startTime) ? _startTime : _lastSample;
+    return ref + CHARGE_COMM_TIMEOUT_MS;
+}
+
+bool ChargeController::checkSafety(const PowerStatus& st, uint32_t now) {
+    float ov = (_params.ovVolts > 0) ? _params.ovVolts : _params.cvVolts * CHARGE_OV_RATIO;
+    if (st.voltageOut > ov) {
+        trip(CHG_FAULT_OV);
+        return false;
+    }
+
+    // 電流與模塊狀態需連續數次異常才判定 (開機與設定值切換時的暫態)
+    _ocCount = (st.currentOut > _limitAmps * CHARGE_OC_RATIO + 1.0f) ? _ocCount + 1 : 0;
+    if (_ocCount >= CHARGE_FAULT_SAMPLES) {
+        trip(CHG_FAULT_OC);
+        return false;
+    }
+    // 開機指令送出後模塊需要啟動時間，這段期間回報關機是正常的
+    if (st.hwRunning) _seenRunning = true;
+    bool starting = !_seenRunning && now - _startTime < CHARGE_STARTUP_MS;
+    _offCount = (st.isOn && !st.hwRunning && !starting) ? _offCount + 1 : 0;
+    if (_offCount >= CHARGE_FAULT_SAMPLES) {
+        trip(CHG_FAULT_PSU);
+        return false;
+    }
+    return true;
+}
+
+void ChargeController::process(const PowerStatus& st, uint32_t now) {
+    if (!checkSafety(st, now)) return;
+
+    if (_state != CHG_FLOAT) {
+        if (_params.maxAh > 0 && chargedAh() >= _params.maxAh) {
+            finish(CHG_END_AH);
+            return;
+        }
+        if (_params.maxMinutes > 0 && now - _startTime >= (uint64_t)_params.maxMinutes * 60000ULL) {
+            finish(CHG_END_TIME);
+            return;
+        }
+    }
+
+    switch (_state) {
+        case CHG_PRECHARGE:
+            if (st.voltageOut >= _params.prechargeVolts) {
+                enter(CHG_CC, _params.cvVolts, _params.ccAmps);
+            } else if (now - _stateTime >= CHARGE_PRECHARGE_TIMEOUT_MS) {
+                trip(CHG_FAULT_PRECHARGE);
+            }
+            break;
+
+        case CHG_CC:
+            // 模塊本身是 CC/CV 電源: 電壓到達設定值後電流自然下降
+            if (st.voltageOut >= _params.cvVolts * CHARGE_CV_ENTRY_RATIO &&
+                st.currentOut < _params.ccAmps * 0.95f) {
+                _state = CHG_CV;
+                _stateTime = now;
+                _taperCount = 0;
+                notify();
+            }
+            break;
+
+        case CHG_CV:
+            _taperCount = (st.currentOut <= _params.taperAmps) ? _taperCount + 1 : 0;
+            if (_taperCount >= CHARGE_TAPER_SAMPLES) finish(CHG_END_TAPER);
+            break;
+
+        default:
+            break;
+    }
+}
+
+const char* ChargeController::stateName(ChargeState st) {
+    switch (st) {
+        case CHG_IDLE:      return "IDLE";
+        case CHG_PRECHARGE: return "PRE";
+        case CHG_CC:        return "CC";
+        case CHG_CV:        return "CV";
+        case CHG_FLOAT:     return "FLOAT";
+        case CHG_DONE:      return "DONE";
+        case CHG_FAULT:     return "FAULT";
+    }
+    return "?";
+}
+
+// 狀態改變時主動回報: CHG:ST=..,AH=..,END=..,ERR=..
+void ChargeController::notify() {
+    char buf[80];
+    snprintf(buf, sizeof(buf), "CHG:ST=%s,AH=%.3f,END=%s,ERR=%s\r\n", stateName(_state), chargedAh(),
+             END_NAMES[_end], FAULT_NAMES[_fault]);
+    _hal->uartSend(buf);
+}
+
+// --- UART Commands ---
+
+void ChargeController::registerCommands(CmdRegistry& reg) {
+    reg.add("CHG:SET",   "fff?ff", cmdSet,   this);
+    reg.add("CHG:PRE",   "ff",     cmdPre,   this);
+    reg.add("CHG:LIM",   "fu?f",   cmdLim,   this);
+    reg.add("CHG:START", "",       cmdStart, this);
+    reg.add("CHG:STOP",  "",       cmdStop,  this);
+    reg.add("GET:CHG",   "",       cmdGet,   this);
+}
+
+// CHG:SET=cv,cc,taper[,floatV,floatI]
+CmdResult ChargeController::cmdSet(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    ChargeController* self = (ChargeController*)ctx;
+    if (args.count == 4) return CMD_ERR_ARGS;
+    for (int i = 0; i < args.count; i++) {
+        if (args.v[i] < 0) return CMD_ERR_RANGE;
+    }
+    if (args.v[0] == 0 || args.v[1] == 0 || args.v[2] >= args.v[1]) return CMD_ERR_RANGE;
+    if (self->isActive()) return CMD_ERR_STATE;
+
+    ChargeParams& p = self->_params;
+    p.cvVolts = args.asFloat(0);
+    p.ccAmps = args.asFloat(1);
+    p.taperAmps = args.asFloat(2);
+    p.floatVolts = (args.count > 3) ? args.asFloat(3) : 0.0f;
+    p.floatAmps = (args.count > 4) ? args.asFloat(4) : 0.0f;
+    snprintf(reply, size, "CMD_ACK:CHG_SET:%.1fV,%.1fA,%.1fA", p.cvVolts, p.ccAmps, p.taperAmps);
+    return CMD_OK;
+}
+
+// CHG:PRE=V,I (V = 0 關閉預充)
+CmdResult ChargeController::cmdPre(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    ChargeController* self = (ChargeController*)ctx;
+    if (args.v[0] < 0 || args.v[1] < 0) return CMD_ERR_RANGE;
+    if (self->isActive()) return CMD_ERR_STATE;
+    self->_params.prechargeVolts = args.asFloat(0);
+    self->_params.prechargeAmps = args.asFloat(1);
+    snprintf(reply, size, "CMD_ACK:CHG_PRE:%.1fV,%.1fA", args.asFloat(0), args.asFloat(1));
+    return CMD_OK;
+}
+
+// CHG:LIM=Ah,minutes[,ovV] (0 = 不限制 / 使用預設)
+CmdResult ChargeController::cmdLim(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    ChargeController* self = (ChargeController*)ctx;
+    if (args.v[0] < 0 || (args.count > 2 && args.v[2] < 0)) return CMD_ERR_RANGE;
+    if (args.asUint(1) > CHARGE_MAX_MINUTES) return CMD_ERR_RANGE;
+    if (self->isActive()) return CMD_ERR_STATE;
+    self->_params.maxAh = args.asFloat(0);
+    self->_params.maxMinutes = args.asUint(1);
+    self->_params.ovVolts = (args.count > 2) ? args.asFloat(2) : 0.0f;
+    snprintf(reply, size, "CMD_ACK:CHG_LIM:%.1fAh,%lumin", self->_params.maxAh,
+             (unsigned long)self->_params.maxMinutes);
+    return CMD_OK;
+}
+
+CmdResult ChargeController::cmdStart(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args; (void)reply; (void)size; // 由 notify() 回報狀態
+    return ((ChargeController*)ctx)->start() ? CMD_OK : CMD_ERR_STATE;
+}
+
+CmdResult ChargeController::cmdStop(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args; (void)reply; (void)size;
+    ChargeController* self = (ChargeController*)ctx;
+    if (!self->isActive()) return CMD_ERR_STATE;
+    self->stop();
+    return CMD_OK;
+}
+
+// CHG:ST=CV,V=..,I=..,AH=..,T=秒,END=..,ERR=..
+CmdResult ChargeController::cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ChargeController* self = (ChargeController*)ctx;
+    PowerStatus st = self->_psu->getStatus();
+    uint32_t t = (self->_state == CHG_IDLE) ? 0 : (self->_hal->getTickCount() - self->_startTime) / 1000;
+    snprintf(reply, size, "CHG:ST=%s,V=%.1f,I=%.1f,AH=%.3f,T=%lu,END=%s,ERR=%s",
+             stateName(self->_state), st.voltageOut, st.currentOut, self->chargedAh(), (unsigned long)t,
+             END_NAMES[self->_end], FAULT_NAMES[self->_fault]);
+    return CMD_OK;
+}
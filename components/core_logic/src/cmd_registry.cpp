@@ -0,0 +1,117 @@
+#include "cmd_registry.h"
+#include "fixed_point.h"
+#include <stdio.h>
+#include <string.h>
+
+CmdRegistry::CmdRegistry() : _count(0), _rejected(0), _firstRejected(NULL) {
+    memset(_entries, 0, sizeof(_entries));
+}
+
+bool CmdRegistry::add(const char* name, const char* schema, CmdHandler handler, void* ctx) {
+    if (!name || !handler || _count >= MAX_COMMANDS) return reject(name);
+    // 重複註冊: 先查表，插入時的搬移不可在中途放棄 (會遺失最後一筆)
+    if (find(name)) return reject(name);
+
+    // 插入排序，維持名稱遞增
+    int pos = _count;
+    while (pos > 0 && strcmp(_entries[pos - 1].name, name) > 0) {
+        _entries[pos] = _entries[pos - 1];
+        pos--;
+    }
+
+    _entries[pos].name = name;
+    _entries[pos].schema = schema ? schema : "";
+    _entries[pos].handler = handler;
+    _entries[pos].ctx = ctx;
+    _count++;
+    return true;
+}
+
+bool CmdRegistry::reject(const char* name) {
+    if (_rejected == 0) _firstRejected = name ? name : "?";
+    _rejected++;
+    return false;
+}
+
+const CmdRegistry::Entry* CmdRegistry::find(const char* name) const {
+    int lo = 0;
+    int hi = _count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(_entries[mid].name, name);
+        if (cmp == 0) return &_entries[mid];
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return NULL;
+}
+
+bool CmdRegistry::parseArgs(const char* schema, char* argStr, CmdArgs& args) {
+    args.count = 0;
+    bool optional = false;
+    const char* p = argStr;
+
+    for (const char* s = schema; *s; s++) {
+        if (*s == '?') { optional = true; continue; }
+
+        if (!p || *p == '\0') {
+            if (optional) return true;
+            return false; // 缺少必填參數
+        }
+        if (args.count >= CMD_MAX_ARGS) return false;
+
+        const char* end = NULL;
+        if (*s == 'f') {
+            int32_t v;
+            if (!parseFixed(p, &v, &end)) return false;
+            args.v[args.count++] = v;
+        } else if (*s == 'u') {
+            uint32_t v;
+            if (!parseUint(p, &v, &end) || v > INT32_MAX) return false;
+            args.v[args.count++] = (int32_t)v;
+        } else {
+            return false;
+        }
+
+        if (*end == ',') p = end + 1;
+        else if (*end == '\0') p = NULL;
+        else return false; // 數字後有多餘字元
+    }
+    // 參數比 schema 多 (或結尾多一個逗號)
+    return p == NULL;
+}
+
+CmdResult CmdRegistry::dispatch(char* line, char* reply, size_t replySize) {
+    reply[0] = '\0';
+    if (line[0] == '\0') return CMD_OK;
+
+    char* argStr = strchr(line, '=');
+    if (argStr) *argStr++ = '\0';
+
+    CmdResult res;
+    const Entry* e = find(line);
+    if (!e) {
+        res = CMD_ERR_UNKNOWN;
+    } else {
+        CmdArgs args;
+        if (!parseArgs(e->schema, argStr, args)) res = CMD_ERR_ARGS;
+        else res = e->handler(e->ctx, args, reply, replySize);
+    }
+
+    if (res != CMD_OK) {
+        snprintf(reply, replySize, "ERR:%s:%s", resultName(res), line);
+    }
+    return res;
+}
+
+const char* CmdRegistry::resultName(CmdResult r) {
+    switch (r) {
+        case CMD_OK:          return "OK";
+        case CMD_ERR_UNKNOWN: return "UNKNOWN";
+        case CMD_ERR_ARGS:    return "ARGS";
+        case CMD_ERR_RANGE:   return "RANGE";
+        case CMD_ERR_STATE:   return "STATE";
+        case CMD_ERR_FULL:    return "FULL";
+    }
+    return "?";
+}
@@ -0,0 +1,172 @@
+#include "config_store.h"
+#include <stdio.h>
+#include <string.h>
+
+static const ConfigDef CONFIG_DEFS[CFG_KEY_COUNT] = {
+    { "psu_addr", "CFG:ADDR",    CFG_TYPE_U32,   PSU_ADDRESS, 0.0f },
+    { "target_v", "CFG:V",       CFG_TYPE_FLOAT, 0, DEFAULT_TARGET_VOLTAGE },
+    { "target_i", "CFG:I",       CFG_TYPE_FLOAT, 0, DEFAULT_TARGET_CURRENT },
+    { "ss_init",  "CFG:SS_INIT", CFG_TYPE_FLOAT, 0, SOFT_START_INITIAL_CURRENT },
+    { "ss_step",  "CFG:SS_STEP", CFG_TYPE_FLOAT, 0, SOFT_START_STEP_CURRENT },
+};
+
+const ConfigDef& ConfigStore::def(ConfigKey key) {
+    return CONFIG_DEFS[key];
+}
+
+ConfigStore::ConfigStore(IHardwareHAL* hal)
+    : _hal(hal), _dirty(0), _firstDirty(0), _lastChange(0),
+      _flushing(false), _revision(0), _commits(0), _guard(NULL), _guardCtx(NULL) {
+    for (int i = 0; i < CFG_KEY_COUNT; i++) {
+        _slots[i].owner = this;
+        _slots[i].key = (ConfigKey)i;
+        if (CONFIG_DEFS[i].type == CFG_TYPE_FLOAT) _values[i].f = CONFIG_DEFS[i].defFloat;
+        else _values[i].u = CONFIG_DEFS[i].defU32;
+    }
+}
+
+void ConfigStore::begin() {
+    for (int i = 0; i < CFG_KEY_COUNT; i++) {
+        Value v;
+        if (_hal->storageRead(CONFIG_DEFS[i].key, &v, sizeof(v))) {
+            _values[i] = v;
+        }
+    }
+    _dirty = 0;
+    _revision++;
+}
+
+void ConfigStore::resetDefaults() {
+    for (int i = 0; i < CFG_KEY_COUNT; i++) {
+        Value v;
+        if (CONFIG_DEFS[i].type == CFG_TYPE_FLOAT) v.f = CONFIG_DEFS[i].defFloat;
+        else v.u = CONFIG_DEFS[i].defU32;
+        if (_values[i].u != v.u) {
+            _values[i] = v;
+            markDirty((ConfigKey)i);
+        }
+    }
+}
+
+void ConfigStore::setU32(ConfigKey key, uint32_t value) {
+    if (_values[key].u == value) return;
+    _values[key].u = value;
+    markDirty(key);
+}
+
+void ConfigStore::setFloat(ConfigKey key, float value) {
+    if (_values[key].f == value) return;
+    _values[key].f = value;
+    markDirty(key);
+}
+
+void ConfigStore::markDirty(ConfigKey key) {
+    uint32_t now = _hal->getTickCount();
+    if (_dirty == 0) _firstDirty = now;
+    _dirty |= (1u << key);
+    _lastChange = now;
+    _revision++;
+}
+
+void ConfigStore::writeKey(ConfigKey key) {
+    _hal->storageWrite(CONFIG_DEFS[key].key, &_values[key], sizeof(Value));
+    _dirty &= ~(1u << key);
+}
+
+void ConfigStore::commit() {
+    _hal->storageCommit();
+    _commits++;
+    _flushing = false;
+}
+
+void ConfigStore::loop() {
+    if (!_flushing) {
+        if (_dirty == 0) return;
+        uint32_t now = _hal->getTickCount();
+        if (now - _lastChange < CONFIG_SAVE_DELAY_MS &&
+            now - _firstDirty < CONFIG_SAVE_MAX_DELAY_MS) return;
+        _flushing = true;
+    }
+
+    // 每次只寫一個 key，避免單次 loop 卡住太久
+    for (int i = 0; i < CFG_KEY_COUNT; i++) {
+        if (_dirty & (1u << i)) {
+            writeKey((ConfigKey)i);
+            return;
+        }
+    }
+    commit();
+}
+
+uint32_t ConfigStore::nextDeadline() const {
+    uint32_t now = _hal->getTickCount();
+    if (_flushing) return now; // 寫入中: 每次 loop 寫一個 key
+    if (_dirty == 0) return now + CONFIG_SAVE_MAX_DELAY_MS;
+    return halTickMin(_lastChange + CONFIG_SAVE_DELAY_MS, _firstDirty + CONFIG_SAVE_MAX_DELAY_MS);
+}
+
+void ConfigStore::flush() {
+    if (_dirty == 0 && !_flushing) return;
+    for (int i = 0; i < CFG_KEY_COUNT; i++) {
+        if (_dirty & (1u << i)) writeKey((ConfigKey)i);
+    }
+    commit();
+}
+
+// --- UART Commands ---
+
+void ConfigStore::registerCommands(CmdRegistry& reg) {
+    for (int i = 0; i < CFG_KEY_COUNT; i++) {
+        reg.add(CONFIG_DEFS[i].cmd, CONFIG_DEFS[i].type == CFG_TYPE_FLOAT ? "f" : "u", cmdSet, &_slots[i]);
+    }
+    reg.add("GET:CFG",   "", cmdGet,   this);
+    reg.add("CFG:SAVE",  "", cmdSave,  this);
+    reg.add("CFG:RESET", "", cmdReset, this);
+}
+
+CmdResult ConfigStore::cmdSet(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    CmdSlot* slot = (CmdSlot*)ctx;
+    const ConfigDef& d = CONFIG_DEFS[slot->key];
+    ConfigStore* self = slot->owner;
+    if (self->_guard && !self->_guard(self->_guardCtx, slot->key)) return CMD_ERR_STATE;
+    if (d.type == CFG_TYPE_FLOAT) {
+        if (args.v[0] < 0) return CMD_ERR_RANGE;
+        slot->owner->setFloat(slot->key, args.asFloat(0));
+        snprintf(reply, size, "CMD_ACK:%s:%.3f", d.cmd, args.asFloat(0));
+    } else {
+        if (slot->key == CFG_PSU_ADDRESS && args.asUint(0) > 0x7F) return CMD_ERR_RANGE;
+        slot->owner->setU32(slot->key, args.asUint(0));
+        snprintf(reply, size, "CMD_ACK:%s:%lu", d.cmd, (unsigned long)args.asUint(0));
+    }
+    return CMD_OK;
+}
+
+CmdResult ConfigStore::cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ConfigStore* self = (ConfigStore*)ctx;
+    int n = snprintf(reply, size, "CFG:");
+    for (int i = 0; i < CFG_KEY_COUNT && n > 0 && (size_t)n < size; i++) {
+        const char* name = CONFIG_DEFS[i].cmd + 4; // 去掉 "CFG:"
+        const char* sep = (i + 1 < CFG_KEY_COUNT) ? "," : "";
+        if (CONFIG_DEFS[i].type == CFG_TYPE_FLOAT) {
+            n += snprintf(reply + n, size - n, "%s=%.3f%s", name, self->_values[i].f, sep);
+        } else {
+            n += snprintf(reply + n, size - n, "%s=%lu%s", name, (unsigned long)self->_values[i].u, sep);
+        }
+    }
+    return CMD_OK;
+}
+
+CmdResult ConfigStore::cmdSave(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ((ConfigStore*)ctx)->flush();
+    snprintf(reply, size, "CMD_ACK:CFG_SAVE");
+    return CMD_OK;
+}
+
+CmdResult ConfigStore::cmdReset(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ((ConfigStore*)ctx)->resetDefaults();
+    snprintf(reply, size, "CMD_ACK:CFG_RESET");
+    return CMD_OK;
+}
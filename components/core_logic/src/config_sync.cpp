@@ -0,0 +1,62 @@
+#include "config_sync.h"
+
+ConfigSync::ConfigSync(ConfigStore* config, PowerProtocol* psu, OutputControl* out)
+    : _config(config), _psu(psu), _out(out), _revision(0), _volts(0), _amps(0),
+      _ssInitial(0), _ssStep(0), _owned(false) {}
+
+void ConfigSync::begin() {
+    _config->setWriteGuard(guard, _out);
+    _ssInitial = -1.0f; // 強制套用
+    applySoftStart();
+    _volts = _config->getFloat(CFG_TARGET_VOLTAGE);
+    _amps = _config->getFloat(CFG_TARGET_CURRENT);
+    _psu->setOutput(_volts, _amps);
+    _owned = !_out->isFree();
+    _revision = _config->revision();
+}
+
+void ConfigSync::loop() {
+    if (_config->revision() != _revision) applySoftStart();
+
+    PowerStatus st = _psu->getStatus();
+    if (!_out->isFree()) {
+        _owned = true;
+    } else if (_owned) {
+        // 控制器剛釋放輸出: 它留下的設定值就是目前的設定值
+        _owned = false;
+        storeSetpoints(st);
+    } else if (_config->getFloat(CFG_TARGET_VOLTAGE) != _volts || _config->getFloat(CFG_TARGET_CURRENT) != _amps) {
+        // 儲存的值被 CFG:V / CFG:I / CFG:RESET 改變
+        float v = _config->getFloat(CFG_TARGET_VOLTAGE);
+        float i = _config->getFloat(CFG_TARGET_CURRENT);
+        if (v != st.voltageSet || i != st.currentSet) _psu->setOutput(v, i);
+    } else if (st.voltageSet != _volts || st.currentSet != _amps) {
+        // PSU 的設定值被按鍵 / SET:V / SET:I 改變
+        storeSetpoints(st);
+    }
+
+    _volts = _config->getFloat(CFG_TARGET_VOLTAGE);
+    _amps = _config->getFloat(CFG_TARGET_CURRENT);
+    _revision = _config->revision();
+    _config->loop();
+}
+
+void ConfigSync::applySoftStart() {
+    float initial = _config->getFloat(CFG_SOFT_START_INITIAL);
+    float step = _config->getFloat(CFG_SOFT_START_STEP);
+    if (initial == _ssInitial && step == _ssStep) return;
+    _ssInitial = initial;
+    _ssStep = step;
+    _psu->setSoftStart(initial, step);
+}
+
+void ConfigSync::storeSetpoints(const PowerStatus& st) {
+    _config->setFloat(CFG_TARGET_VOLTAGE, st.voltageSet);
+    _config->setFloat(CFG_TARGET_CURRENT, st.currentSet);
+}
+
+// CFG:V / CFG:I 只能在沒有控制器擁有輸出時修改
+bool ConfigSync::guard(void* ctx, ConfigKey key) {
+    if (key != CFG_TARGET_VOLTAGE && key != CFG_TARGET_CURRENT) return true;
+    return ((const OutputControl*)ctx)->isFree();
+}
@@ -0,0 +1,118 @@
+#include "energy_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* STORAGE_KEY = "energy";
+
+EnergyLog::EnergyLog(IHardwareHAL* hal, PsuBus* bus)
+    : _hal(hal), _bus(bus), _baseWh(0), _baseAh(0), _lastSave(0) {
+    memset(&_saved, 0, sizeof(_saved));
+}
+
+void EnergyLog::begin() {
+    if (!_hal->storageRead(STORAGE_KEY, &_saved, sizeof(_saved))) {
+        memset(&_saved, 0, sizeof(_saved));
+    }
+    _baseWh = busMilliWh();
+    _baseAh = busMilliAh();
+    _lastSave = _hal->getTickCount();
+}
+
+uint64_t EnergyLog::busMilliWh() const {
+    uint64_t sum = 0;
+    for (int i = 0; i < _bus->count(); i++) sum += _bus->module(i)->energy().milliWattHours();
+    return sum;
+}
+
+uint64_t EnergyLog::busMilliAh() const {
+    uint64_t sum = 0;
+    for (int i = 0; i < _bus->count(); i++) sum += _bus->module(i)->energy().milliAmpHours();
+    return sum;
+}
+
+uint64_t EnergyLog::lifetimeMilliWh() const { return _saved.lifeMilliWh + (busMilliWh() - _baseWh); }
+uint64_t EnergyLog::lifetimeMilliAh() const { return _saved.lifeMilliAh + (busMilliAh() - _baseAh); }
+uint64_t EnergyLog::sessionMilliWh() const { return _saved.sessionMilliWh + (busMilliWh() - _baseWh); }
+uint64_t EnergyLog::sessionMilliAh() const { return _saved.sessionMilliAh + (busMilliAh() - _baseAh); }
+
+void EnergyLog::save() {
+    uint64_t wh = busMilliWh();
+    uint64_t ah = busMilliAh();
+    _saved.lifeMilliWh += wh - _baseWh;
+    _saved.lifeMilliAh += ah - _baseAh;
+    _saved.sessionMilliWh += wh - _baseWh;
+    _saved.sessionMilliAh += ah - _baseAh;
+    _baseWh = wh;
+    _baseAh = ah;
+
+    _hal->storageWrite(STORAGE_KEY, &_saved, sizeof(_saved));
+    _hal->storageCommit();
+    _lastSave = _hal->getTickCount();
+}
+
+void EnergyLog::resetSession() {
+    save(); // 先把目前的量計入 lifetime
+    _saved.sessionMilliWh = 0;
+    _saved.sessionMilliAh = 0;
+    _hal->storageWrite(STORAGE_KEY, &_saved, sizeof(_saved));
+    _hal->storageCommit();
+}
+
+void EnergyLog::loop() {
+    uint32_t now = _hal->getTickCount();
+    if (now - _lastSave < ENERGY_SAVE_INTERVAL_MS) return;
+    // 沒有變化時不寫 flash
+    if (busMilliWh() == _baseWh && busMilliAh() == _baseAh) {
+        _lastSave = now;
+        return;
+    }
+    save();
+}
+
+uint32_t EnergyLog::nextDeadline() const {
+    return _lastSave + ENERGY_SAVE_INTERVAL_MS;
+}
+
+// --- UART Commands ---
+
+void EnergyLog::registerCommands(CmdRegistry& reg) {
+    reg.add("GET:ENERGY",   "", cmdGet,   this);
+    reg.add("ENERGY:RESET", "", cmdReset, this);
+    reg.add("ENERGY:SAVE",  "", cmdSave,  this);
+}
+
+// 定點輸出 x.yyy (避免 64-bit 轉 float 損失精度)
+static int formatMilli(char* buf, size_t size, uint64_t milli) {
+    return snprintf(buf, size, "%llu.%03u", (unsigned long long)(milli / 1000), (unsigned)(milli % 1000));
+}
+
+// ENERGY:WH=..,AH=..,LIFE_WH=..,LIFE_AH=..,GAPS=..
+CmdResult EnergyLog::cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    EnergyLog* self = (EnergyLog*)ctx;
+    char wh[24], ah[24], lwh[24], lah[24];
+    formatMilli(wh, sizeof(wh), self->sessionMilliWh());
+    formatMilli(ah, sizeof(ah), self->sessionMilliAh());
+    formatMilli(lwh, sizeof(lwh), self->lifetimeMilliWh());
+    formatMilli(lah, sizeof(lah), self->lifetimeMilliAh());
+
+    uint32_t gaps = 0;
+    for (int i = 0; i < self->_bus->count(); i++) gaps += self->_bus->module(i)->energy().gaps();
+    snprintf(reply, size, "ENERGY:WH=%s,AH=%s,LIFE_WH=%s,LIFE_AH=%s,GAPS=%lu", wh, ah, lwh, lah,
+             (unsigned long)gaps);
+    return CMD_OK;
+}
+
+CmdResult EnergyLog::cmdReset(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ((EnergyLog*)ctx)->resetSession();
+    snprintf(reply, size, "CMD_ACK:ENERGY_RESET");
+    return CMD_OK;
+}
+
+CmdResult EnergyLog::cmdSave(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ((EnergyLog*)ctx)->save();
+    snprintf(reply, size, "CMD_ACK:ENERGY_SAVE");
+    return CMD_OK;
+}
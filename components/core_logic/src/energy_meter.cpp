@@ -0,0 +1,43 @@
+#include "energy_meter.h"
+
+void EnergyMeter::reset() {
+    _hasPrev = false;
+    _prevV = 0;
+    _prevI = 0;
+    _prevTs = 0;
+    _mWh = 0;
+    _whFrac = 0;
+    _mAh = 0;
+    _ahFrac = 0;
+    _samples = 0;
+    _gaps = 0;
+}
+
+void EnergyMeter::addSample(uint16_t rawV, uint16_t rawI, uint32_t timestampUs) {
+    _samples++;
+    uint32_t dt = timestampUs - _prevTs;
+
+    if (_hasPrev && dt <= MAX_GAP_US) {
+        // 單次增量上限: (65535 x 65535 x 2) x 1e6 ≈ 8.6e15，遠小於 2^64
+        uint64_t q = (uint64_t)((uint32_t)_prevI + rawI) * dt;
+        uint64_t e = ((uint64_t)_prevV * _prevI + (uint64_t)rawV * rawI) * dt;
+
+        _ahFrac += q;
+        if (_ahFrac >= UNITS_PER_MAH) {
+            _mAh += _ahFrac / UNITS_PER_MAH;
+            _ahFrac %= UNITS_PER_MAH;
+        }
+        _whFrac += e;
+        if (_whFrac >= UNITS_PER_MWH) {
+            _mWh += _whFrac / UNITS_PER_MWH;
+            _whFrac %= UNITS_PER_MWH;
+        }
+    } else if (_hasPrev) {
+        _gaps++; // 訊框遺失: 這段時間的電量未知，從這個訊框重新開始
+    }
+
+    _hasPrev = true;
+    _prevV = rawV;
+    _prevI = rawI;
+    _prevTs = timestampUs;
+}
@@ -0,0 +1,65 @@
+#include "fixed_point.h"
+
+bool parseUint(const char* str, uint32_t* out, const char** end) {
+    const char* p = str;
+    uint32_t val = 0;
+    bool digits = false;
+
+    while (*p >= '0' && *p <= '9') {
+        uint32_t d = (uint32_t)(*p - '0');
+        if (val > (UINT32_MAX - d) / 10) return false;
+        val = val * 10 + d;
+        digits = true;
+        p++;
+    }
+    if (!digits) return false;
+
+    *out = val;
+    if (end) *end = p;
+    return true;
+}
+
+bool parseFixed(const char* str, int32_t* out, const char** end) {
+    const char* p = str;
+    bool neg = false;
+    if (*p == '+' || *p == '-') {
+        neg = (*p == '-');
+        p++;
+    }
+
+    // 以 int64 累加，最後再檢查是否超出 int32 範圍
+    int64_t val = 0;
+    bool digits = false;
+    while (*p >= '0' && *p <= '9') {
+        val = val * 10 + (*p - '0');
+        if (val > (int64_t)INT32_MAX * 10) return false;
+        digits = true;
+        p++;
+    }
+    val *= FIXED_SCALE;
+
+    if (*p == '.') {
+        p++;
+        int32_t scale = FIXED_SCALE / 10;
+        while (*p >= '0' && *p <= '9') {
+            if (scale > 0) {
+                val += (*p - '0') * scale;
+                scale /= 10;
+            } else if (scale == 0) {
+                // 第 4 位小數決定四捨五入，其後的位數忽略
+                if (*p >= '5') val += 1;
+                scale = -1;
+            }
+            digits = true;
+            p++;
+        }
+    }
+    if (!digits) return false;
+
+    if (neg) val = -val;
+    if (val > INT32_MAX || val < INT32_MIN) return false;
+
+    *out = (int32_t)val;
+    if (end) *end = p;
+    return true;
+}
@@ -0,0 +1,216 @@
+#include "load_share.h"
+#include <stdio.h>
+#include <string.h>
+
+const float LoadShare::TRIM_GAIN = 0.5f;
+const float LoadShare::TRIM_MAX_RATIO = 0.2f;
+
+LoadShare::LoadShare(IHardwareHAL* hal, OutputControl* out)
+    : _hal(hal), _out(out), _bus(out->bus()), _enabled(false), _volts(0), _totalAmps(0),
+      _healthy(0), _lastRebalance(0) {
+    for (int i = 0; i < PSU_MAX_MODULES; i++) {
+        _capacity[i] = PSU_MODULE_CAPACITY_A;
+        _limit[i] = 0;
+        _trim[i] = 0;
+    }
+}
+
+void LoadShare::setCapacity(int idx, float amps) {
+    if (idx < 0 || idx >= PSU_MAX_MODULES) return;
+    _capacity[idx] = (amps > 0) ? amps : 0;
+    if (_enabled) {
+        distribute(false);
+        apply();
+    }
+}
+
+bool LoadShare::setTarget(float volts, float totalAmps) {
+    if (!_out->acquire(OUT_OWNER_SHARE, onStop, this)) return false;
+    // 關機的模塊一併開機; 開始運轉 (狀態回報) 後由 loop() 的健康檢查重新分配
+    if (!_enabled) _out->powerOnAll();
+    _volts = volts;
+    _totalAmps = (totalAmps > 0) ? totalAmps : 0;
+    _enabled = true;
+    _healthy = checkHealth(_hal->getTickCount());
+    memset(_trim, 0, sizeof(_trim));
+    distribute(false);
+    apply();
+    _lastRebalance = _hal->getTickCount();
+    return true;
+}
+
+void LoadShare::disable() {
+    _enabled = false;
+    _out->release(OUT_OWNER_SHARE);
+}
+
+// 模塊已由 OutputControl 關機，只停止送出設定值
+void LoadShare::onStop(void* ctx) {
+    ((LoadShare*)ctx)->_enabled = false;
+}
+
+float LoadShare::availableAmps() const {
+    float sum = 0;
+    for (int i = 0; i < _bus->count(); i++) {
+        if (isHealthy(i)) sum += _capacity[i];
+    }
+    return sum;
+}
+
+uint32_t LoadShare::checkHealth(uint32_t now) const {
+    uint32_t mask = 0;
+    for (int i = 0; i < _bus->count(); i++) {
+        const PowerProtocol* m = _bus->module(i);
+        if (!m->isOnline(now, SHARE_STALE_MS)) continue;
+        // 沒有運轉的模塊 (未開機、尚未回報運轉或故障) 不分配電流
+        if (!m->getStatus().hwRunning) continue;
+        mask |= (1u << i);
+    }
+    return mask;
+}
+
+void LoadShare::loop() {
+    if (!_enabled) return;
+    uint32_t now = _hal->getTickCount();
+
+    // 1. 健康狀態改變: 立即以容量比例重新分配 (不等待下一次修正週期)
+    uint32_t healthy = checkHealth(now);
+    if (healthy != _healthy) {
+        _healthy = healthy;
+        memset(_trim, 0, sizeof(_trim));
+        distribute(false);
+        apply();
+        _lastRebalance = now;
+        return;
+    }
+
+    // 2. 週期性依實測電流修正
+    if (now - _lastRebalance >= SHARE_REBALANCE_MS) {
+        _lastRebalance = now;
+        distribute(true);
+        apply();
+    }
+}
+
+uint32_t LoadShare::nextDeadline() const {
+    uint32_t now = _hal->getTickCount();
+    if (!_enabled) return now + SHARE_REBALANCE_MS;
+
+    // 健康的模塊超過 SHARE_STALE_MS 沒有回報時要立即重新分配
+    uint32_t deadline = _lastRebalance + SHARE_REBALANCE_MS;
+    for (int i = 0; i < _bus->count(); i++) {
+        if (isHealthy(i)) deadline = halTickMin(deadline, _bus->module(i)->getStatus().lastUpdate + SHARE_STALE_MS);
+    }
+    return deadline;
+}
+
+void LoadShare::distribute(bool useMeasured) {
+    int n = _bus->count();
+    float sumCap = availableAmps();
+    float total = (_totalAmps < sumCap) ? _totalAmps : sumCap;
+
+    if (useMeasured && sumCap > 0) {
+        // 實測負載率 u_i = I_i / C_i，往平均值 (總電流 / 總容量) 修正
+        // sum(C_i * (u - u_i)) = 0，修正量總和為零，不會改變總電流
+        float load = 0;
+        for (int i = 0; i < n; i++) {
+            if (isHealthy(i)) load += _bus->module(i)->getStatus().currentOut;
+        }
+        if (load > 0.5f) {
+            float meanU = load / sumCap;
+            for (int i = 0; i < n; i++) {
+                if (!isHealthy(i) || _capacity[i] <= 0) continue;
+                float base = total * _capacity[i] / sumCap;
+                float u = _bus->module(i)->getStatus().currentOut / _capacity[i];
+                _trim[i] += TRIM_GAIN * (meanU - u) * _capacity[i];
+                float maxTrim = base * TRIM_MAX_RATIO;
+                if (_trim[i] > maxTrim) _trim[i] = maxTrim;
+                if (_trim[i] < -maxTrim) _trim[i] = -maxTrim;
+            }
+        }
+    }
+
+    float sum = 0;
+    for (int i = 0; i < n; i++) {
+        if (!isHealthy(i) || sumCap <= 0) {
+            _limit[i] = 0;
+            continue;
+        }
+        float lim = total * _capacity[i] / sumCap + _trim[i];
+        if (lim < 0) lim = 0;
+        if (lim > _capacity[i]) lim = _capacity[i];
+        _limit[i] = lim;
+        sum += lim;
+    }
+
+    // 限幅後總和可能偏離目標: 依剩餘容量 (不足時) 或目前分配 (過多時) 比例補正
+    float diff = total - sum;
+    if (diff > 0.01f || diff < -0.01f) {
+        float weight = 0;
+        for (int i = 0; i < n; i++) {
+            if (isHealthy(i)) weight += (diff > 0) ? (_capacity[i] - _limit[i]) : _limit[i];
+        }
+        if (weight > 0) {
+            for (int i = 0; i < n; i++) {
+                if (!isHealthy(i)) continue;
+                float w = (diff > 0) ? (_capacity[i] - _limit[i]) : _limit[i];
+                _limit[i] += diff * w / weight;
+            }
+        }
+    }
+}
+
+void LoadShare::apply() {
+    for (int i = 0; i < _bus->count(); i++) {
+        PowerProtocol* m = _bus->module(i);
+        PowerStatus st = m->getStatus();
+        float d = st.currentSet - _limit[i];
+        if (st.voltageSet != _volts || d > 0.05f || d < -0.05f) {
+            m->setOutput(_volts, _limit[i]);
+        }
+    }
+}
+
+// --- UART Commands ---
+
+void LoadShare::registerCommands(CmdRegistry& reg) {
+    reg.add("SHARE:I",   "f?f", cmdShare,    this);
+    reg.add("SHARE:OFF", "",    cmdShareOff, this);
+    reg.add("GET:SHARE", "",    cmdGetShare, this);
+}
+
+CmdResult LoadShare::cmdShare(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    LoadShare* self = (LoadShare*)ctx;
+    if (args.v[0] < 0) return CMD_ERR_RANGE;
+    float volts = self->_volts;
+    if (args.count > 1) {
+        if (args.v[1] < 0) return CMD_ERR_RANGE;
+        volts = args.asFloat(1);
+    } else if (!self->_enabled && self->_bus->count() > 0) {
+        volts = self->_bus->module(0)->getStatus().voltageSet;
+    }
+    if (!self->setTarget(volts, args.asFloat(0))) return CMD_ERR_STATE;
+    snprintf(reply, size, "CMD_ACK:SHARE:%.1fA@%.1fV", self->_totalAmps, volts);
+    return CMD_OK;
+}
+
+CmdResult LoadShare::cmdShareOff(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ((LoadShare*)ctx)->disable();
+    snprintf(reply, size, "CMD_ACK:SHARE_OFF");
+    return CMD_OK;
+}
+
+// SHARE:EN=1,T=120.0,AV=180.0,M0=40.0/39.8/OK,M1=...
+CmdResult LoadShare::cmdGetShare(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    LoadShare* self = (LoadShare*)ctx;
+    int n = snprintf(reply, size, "SHARE:EN=%d,T=%.1f,AV=%.1f",
+                     self->_enabled ? 1 : 0, self->_totalAmps, self->availableAmps());
+    for (int i = 0; i < self->_bus->count() && n > 0 && (size_t)n < size; i++) {
+        PowerStatus st = self->_bus->module(i)->getStatus();
+        n += snprintf(reply + n, size - n, ",M%d=%.1f/%.1f/%s", i, self->_limit[i], st.currentOut,
+                      self->isHealthy(i) ? "OK" : "FAULT");
+    }
+    return CMD_OK;
+}
@@ -0,0 +1,51 @@
+#include "output_ctrl.h"
+
+OutputControl::OutputControl(PsuBus* bus)
+    : _bus(bus), _owner(OUT_OWNER_NONE), _onStop(NULL), _stopCtx(NULL) {}
+
+bool OutputControl::acquire(OutputOwner who, OutputStopFn onStop, void* ctx) {
+    if (_owner != OUT_OWNER_NONE && _owner != who) return false;
+    _owner = who;
+    _onStop = onStop;
+    _stopCtx = ctx;
+    return true;
+}
+
+void OutputControl::release(OutputOwner who) {
+    if (_owner != who) return;
+    _owner = OUT_OWNER_NONE;
+    _onStop = NULL;
+    _stopCtx = NULL;
+}
+
+const char* OutputControl::ownerName(OutputOwner who) {
+    switch (who) {
+        case OUT_OWNER_NONE:    return "NONE";
+        case OUT_OWNER_SHARE:   return "SHARE";
+        case OUT_OWNER_PROFILE: return "PROF";
+        case OUT_OWNER_CHARGER: return "CHG";
+    }
+    return "?";
+}
+
+void OutputControl::powerOffAll() {
+    // 先解除擁有者再通知: 擁有者在通知中呼叫 release() 沒有作用
+    OutputStopFn onStop = _onStop;
+    void* ctx = _stopCtx;
+    release(_owner);
+    if (onStop) onStop(ctx);
+
+    for (int i = 0; i < _bus->count(); i++) {
+        _bus->module(i)->setPower(false);
+    }
+}
+
+// 已在運轉的模塊不重送 (開機指令會重新開始軟啟動);
+// 已下令開機但回報關機的模塊 (故障後) 重新送出開機
+void OutputControl::powerOnAll() {
+    for (int i = 0; i < _bus->count(); i++) {
+        PowerProtocol* m = _bus->module(i);
+        PowerStatus st = m->getStatus();
+        if (!st.isOn || !st.hwRunning) m->setPower(true);
+    }
+}
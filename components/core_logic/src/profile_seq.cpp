@@ -0,0 +1,229 @@
+#include "profile_seq.h"
+#include <stdio.h>
+#include <string.h>
+
+ProfileSequencer::ProfileSequencer(IHardwareHAL* hal, PowerProtocol* psu, OutputControl* out)
+    : _hal(hal), _psu(psu), _out(out), _count(0), _state(PROF_EMPTY), _step(0),
+      _loop(0), _loops(1), _stepStart(0), _pausedAt(0) {
+    memset(_steps, 0, sizeof(_steps));
+}
+
+bool ProfileSequencer::clear() {
+    if (isActive()) return false;
+    _count = 0;
+    _step = 0;
+    _state = PROF_EMPTY;
+    return true;
+}
+
+bool ProfileSequencer::addStep(const ProfileStep& step) {
+    if (isActive() || _count >= PROFILE_MAX_STEPS) return false;
+    _steps[_count++] = step;
+    _state = PROF_READY;
+    return true;
+}
+
+bool ProfileSequencer::start(uint32_t loops) {
+    if (_count == 0 || isActive()) return false;
+    if (!_out->acquire(OUT_OWNER_PROFILE, onStop, this)) return false;
+    _loops = loops;
+    _loop = 0;
+    _state = PROF_RUNNING;
+    enterStep(0, _hal->getTickCount());
+    notify("RUN");
+    return true;
+}
+
+bool ProfileSequencer::pause() {
+    if (_state != PROF_RUNNING) return false;
+    _pausedAt = _hal->getTickCount();
+    _state = PROF_PAUSED;
+    notify("PAUSE");
+    return true;
+}
+
+bool ProfileSequencer::resume() {
+    if (_state != PROF_PAUSED) return false;
+    // 暫停期間不計入步驟時間，輸出維持暫停時的設定值
+    _stepStart += _hal->getTickCount() - _pausedAt;
+    _state = PROF_RUNNING;
+    notify("RESUME");
+    return true;
+}
+
+void ProfileSequencer::abort() {
+    if (!isActive()) return;
+    _psu->setOutput(_psu->getStatus().voltageSet, 0.0f);
+    _state = PROF_ABORTED;
+    _out->release(OUT_OWNER_PROFILE);
+    notify("ABORT");
+}
+
+// 所有模塊已由 OutputControl 關機 (OFF 指令 / 按鍵): 視為中止，不再送出設定值
+void ProfileSequencer::onStop(void* ctx) {
+    ProfileSequencer* self = (ProfileSequencer*)ctx;
+    if (!self->isActive()) return;
+    self->_state = PROF_ABORTED;
+    self->notify("ABORT");
+}
+
+void ProfileSequencer::enterStep(int idx, uint32_t at) {
+    _step = idx;
+    _stepStart = at;
+    _psu->setOutput(_steps[idx].volts, _steps[idx].amps);
+}
+
+// end: 步驟的結束時間。時間到期時為預定時間 (不累積 loop 延遲)，條件成立時為偵測到的時間
+bool ProfileSequencer::stepDone(const ProfileStep& st, uint32_t now, uint32_t* end) const {
+    uint32_t elapsed = now - _stepStart;
+    if ((st.cond == PROF_COND_TIME || st.durationMs > 0) && elapsed >= st.durationMs) {
+        *end = _stepStart + st.durationMs;
+        return true;
+    }
+    if (st.cond == PROF_COND_TIME) return false;
+
+    // 只採用步驟開始之後的狀態回報，避免用前一步驟的量測值判斷
+    PowerStatus ps = _psu->getStatus();
+    if (halTickBefore(ps.lastUpdate, _stepStart)) return false;
+
+    bool met = (st.cond == PROF_COND_V_ABOVE) ? (ps.voltageOut >= st.condValue)
+                                              : (ps.currentOut <= st.condValue);
+    *end = now;
+    return met;
+}
+
+void ProfileSequencer::loop() {
+    if (_state != PROF_RUNNING) return;
+    uint32_t now = _hal->getTickCount();
+
+    // loop 延遲時可能一次跨過數個短步驟; 最多前進一輪，避免全部 0 ms 時無限循環
+    for (int n = 0; n <= _count && _state == PROF_RUNNING; n++) {
+        uint32_t end;
+        if (!stepDone(_steps[_step], now, &end)) break;
+
+        int next = _step + 1;
+        if (next >= _count) {
+            _loop++;
+            if (_loops != 0 && _loop >= _loops) {
+                _state = PROF_DONE;
+                _out->release(OUT_OWNER_PROFILE);
+                notify("DONE");
+                return;
+            }
+            next = 0;
+            notify("LOOP");
+        }
+        enterStep(next, end);
+    }
+}
+
+uint32_t ProfileSequencer::nextDeadline() const {
+    uint32_t now = _hal->getTickCount();
+    const ProfileStep& st = _steps[_step];
+    // 量測條件由 CAN 狀態回報 (事件) 觸發檢查，只有逾時需要期限
+    if (_state != PROF_RUNNING || (st.cond != PROF_COND_TIME && st.durationMs == 0)) {
+        return now + PowerProtocol::QUERY_INTERVAL_MS;
+    }
+    return _stepStart + st.durationMs;
+}
+
+const char* ProfileSequencer::stateName(ProfileState st) {
+    switch (st) {
+        case PROF_EMPTY:   return "EMPTY";
+        case PROF_READY:   return "READY";
+        case PROF_RUNNING: return "RUN";
+        case PROF_PAUSED:  return "PAUSE";
+        case PROF_DONE:    return "DONE";
+        case PROF_ABORTED: return "ABORT";
+    }
+    return "?";
+}
+
+// 狀態改變時主動回報: PROF:<事件>,STEP=目前/總數,LOOP=已完成次數
+void ProfileSequencer::notify(const char* event) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "PROF:%s,STEP=%d/%d,LOOP=%lu\r\n", event, _step + 1, _count,
+             (unsigned long)_loop);
+    _hal->uartSend(buf);
+}
+
+// --- UART Commands ---
+
+void ProfileSequencer::registerCommands(CmdRegistry& reg) {
+    reg.add("PROF:ADD",    "uff?uf", cmdAdd,    this);
+    reg.add("PROF:CLR",    "",       cmdClear,  this);
+    reg.add("PROF:RUN",    "?u",     cmdRun,    this);
+    reg.add("PROF:PAUSE",  "",       cmdPause,  this);
+    reg.add("PROF:RESUME", "",       cmdResume, this);
+    reg.add("PROF:ABORT",  "",       cmdAbort,  this);
+    reg.add("GET:PROF",    "",       cmdGet,    this);
+}
+
+// PROF:ADD=ms,V,I[,cond,value]
+CmdResult ProfileSequencer::cmdAdd(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    ProfileSequencer* self = (ProfileSequencer*)ctx;
+    if (args.count != 3 && args.count != 5) return CMD_ERR_ARGS;
+    if (args.v[1] < 0 || args.v[2] < 0) return CMD_ERR_RANGE;
+
+    ProfileStep st;
+    st.durationMs = args.asUint(0);
+    st.volts = args.asFloat(1);
+    st.amps = args.asFloat(2);
+    st.cond = PROF_COND_TIME;
+    st.condValue = 0;
+    if (args.count == 5) {
+        if (args.asUint(3) > PROF_COND_I_BELOW || args.v[4] < 0) return CMD_ERR_RANGE;
+        st.cond = (uint8_t)args.asUint(3);
+        st.condValue = args.asFloat(4);
+    }
+
+    if (self->isActive()) return CMD_ERR_STATE;
+    if (!self->addStep(st)) return CMD_ERR_FULL;
+    snprintf(reply, size, "CMD_ACK:PROF_ADD:%d", self->_count);
+    return CMD_OK;
+}
+
+CmdResult ProfileSequencer::cmdClear(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    if (!((ProfileSequencer*)ctx)->clear()) return CMD_ERR_STATE;
+    snprintf(reply, size, "CMD_ACK:PROF_CLR");
+    return CMD_OK;
+}
+
+CmdResult ProfileSequencer::cmdRun(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)reply; (void)size; // 由 notify() 回報 PROF:RUN
+    ProfileSequencer* self = (ProfileSequencer*)ctx;
+    if (!self->start(args.count > 0 ? args.asUint(0) : 1)) return CMD_ERR_STATE;
+    return CMD_OK;
+}
+
+CmdResult ProfileSequencer::cmdPause(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args; (void)reply; (void)size;
+    return ((ProfileSequencer*)ctx)->pause() ? CMD_OK : CMD_ERR_STATE;
+}
+
+CmdResult ProfileSequencer::cmdResume(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args; (void)reply; (void)size;
+    return ((ProfileSequencer*)ctx)->resume() ? CMD_OK : CMD_ERR_STATE;
+}
+
+CmdResult ProfileSequencer::cmdAbort(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args; (void)reply; (void)size;
+    ProfileSequencer* self = (ProfileSequencer*)ctx;
+    if (!self->isActive()) return CMD_ERR_STATE;
+    self->abort();
+    return CMD_OK;
+}
+
+// PROF:ST=RUN,STEP=2/5,LOOP=0/3,T=1200/5000  (LOOP 總數 0 = 無限循環)
+CmdResult ProfileSequencer::cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    (void)args;
+    ProfileSequencer* self = (ProfileSequencer*)ctx;
+    uint32_t now = (self->_state == PROF_PAUSED) ? self->_pausedAt : self->_hal->getTickCount();
+    uint32_t elapsed = self->isActive() ? now - self->_stepStart : 0;
+    snprintf(reply, size, "PROF:ST=%s,STEP=%d/%d,LOOP=%lu/%lu,T=%lu/%lu",
+             stateName(self->_state), self->_count ? self->_step + 1 : 0, self->_count,
+             (unsigned long)self->_loop, (unsigned long)self->_loops, (unsigned long)elapsed,
+             (unsigned long)(self->_count ? self->_steps[self->_step].durationMs : 0));
+    return CMD_OK;
+}
@@ -0,0 +1,34 @@
+#include "psu_bus.h"
+
+PsuBus::PsuBus(IHardwareHAL* hal) : _hal(hal), _count(0), _unmatched(0) {
+    memset(_byAddr, -1, sizeof(_byAddr));
+}
+
+PowerProtocol* PsuBus::addModule() {
+    if (_count >= PSU_MAX_MODULES) return NULL;
+    _modules[_count] = PowerProtocol(_hal);
+    return &_modules[_count++];
+}
+
+void PsuBus::begin(uint8_t baseAddr) {
+    memset(_byAddr, -1, sizeof(_byAddr));
+    for (int i = 0; i < _count; i++) {
+        uint8_t addr = (uint8_t)((baseAddr + i) % PsuPolicy::ADDR_COUNT);
+        _modules[i].init(addr);
+        _byAddr[addr] = (int8_t)i;
+    }
+}
+
+void PsuBus::dispatch(const HalCanFrame& frame, uint32_t now) {
+    int8_t idx = _byAddr[PsuPolicy::addressOf(frame.id)];
+    if (idx < 0 || !_modules[idx].handleFrame(frame, now)) _unmatched++;
+}
+
+uint32_t PsuBus::deadlineAfter(uint32_t now) const {
+    uint32_t deadline = now + PowerProtocol::QUERY_INTERVAL_MS;
+    for (int i = 0; i < _count; i++) {
+        uint32_t d = _modules[i].nextDeadline();
+        if (halTickBefore(d, deadline)) deadline = d;
+    }
+    return deadline;
+}
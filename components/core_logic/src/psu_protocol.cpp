@@ -1,6 +1,6 @@
 #include "psu_protocol.h"
 
-PowerProtocol::PowerProtocol(IHardwareHAL* hal) : _hal(hal) {}
+PowerProtocol::PowerProtocol(IHardwareHAL* hal) : _hal(hal), _listener(NULL), _listenerCtx(NULL) {}
 
 void PowerProtocol::init(uint8_t addr) {
     _addr = addr;
@@ -13,27 +13,28 @@ void PowerProtocol::init(uint8_t addr) {
     _status.currentSet = _targetAmps;
 
     _startupCheckDone = false;
+    _responded = false;
     _softStartActive = false;
     _lastQueryTime = 0;
     _lastRampTime = 0;
+    _softStartInitial = SOFT_START_INITIAL_CURRENT;
+    _softStartStep = SOFT_START_STEP_CURRENT;
 }
 
-void PowerProtocol::loop() {
-    HalCanFrame frame;
-    
-    // 1. CAN Receive
-    while (_hal->canReceive(frame)) {
-        parseFrame(frame);
-    }
-
-    uint32_t now = _hal->getTickCount();
+bool PowerProtocol::handleFrame(const HalCanFrame& frame, uint32_t now) {
+    PsuMsg msg;
+    if (!PsuPolicy::decode(_addr, frame, msg)) return false;
+    applyMessage(msg, frame.timestampUs, now);
+    return true;
+}
 
-    // 2. Soft Start
+void PowerProtocol::service(uint32_t now) {
+    // 1. Soft Start
     if (_status.isOn && _softStartActive) {
         if (_status.currentOut > 1.0f) {
-            if (now - _lastRampTime >= 100) {
+            if (now - _lastRampTime >= RAMP_INTERVAL_MS) {
                 _lastRampTime = now;
-                _rampingAmps += SOFT_START_STEP_CURRENT;
+                _rampingAmps += _softStartStep;
 
                 if (_rampingAmps >= _targetAmps) {
                     _rampingAmps = _targetAmps;
@@ -47,13 +48,24 @@ void PowerProtocol::loop() {
         }
     }
 
-    // 3. Periodic Query (100ms)
-    if (now - _lastQueryTime >= 100) {
+    // 2. Periodic Query (100ms)
+    if (now - _lastQueryTime >= QUERY_INTERVAL_MS) {
         queryStatus();
         _lastQueryTime = now;
     }
 }
 
+uint32_t PowerProtocol::nextDeadline() const {
+    uint32_t deadline = _lastQueryTime + QUERY_INTERVAL_MS;
+
+    // 軟啟動只有在偵測到負載電流後才會依時間爬升，否則由狀態回報觸發
+    if (_status.isOn && _softStartActive && _status.currentOut > 1.0f) {
+        uint32_t ramp = _lastRampTime + RAMP_INTERVAL_MS;
+        if (halTickBefore(ramp, deadline)) deadline = ramp;
+    }
+    return deadline;
+}
+
 void PowerProtocol::setOutput(float voltageV, float currentA) {
     _targetVolts = voltageV;
     _targetAmps = currentA;
@@ -67,34 +79,13 @@ void PowerProtocol::setOutput(float voltageV, float currentA) {
 
 void PowerProtocol::sendSetCommand(float voltageV, float currentA) {
     HalCanFrame frame;
-    frame.id = ID_CMD_SET + _addr;
-    frame.len = 8;
-    frame.ext = true;
-
-    uint32_t iVal = (uint32_t)(currentA * 1000);
-    uint32_t vVal = (uint32_t)(voltageV * 1000);
-
-    frame.data[0] = 0x00;
-    frame.data[1] = (iVal >> 16) & 0xFF;
-    frame.data[2] = (iVal >> 8) & 0xFF;
-    frame.data[3] = iVal & 0xFF;
-    frame.data[4] = (vVal >> 24) & 0xFF;
-    frame.data[5] = (vVal >> 16) & 0xFF;
-    frame.data[6] = (vVal >> 8) & 0xFF;
-    frame.data[7] = vVal & 0xFF;
-
+    PsuPolicy::encodeSetOutput(_addr, voltageV, currentA, frame);
     _hal->canSend(frame);
 }
 
 void PowerProtocol::setPower(bool on) {
     HalCanFrame frame;
-    frame.id = ID_CMD_SET + _addr;
-    frame.len = 8;
-    frame.ext = true;
-    memset(frame.data, 0, 8);
-    
-    frame.data[0] = 0x02; // CMD=2
-    frame.data[7] = on ? 0x55 : 0xAA;
+    PsuPolicy::encodePower(_addr, on, frame);
     _hal->canSend(frame);
 
     _status.isOn = on;
@@ -105,7 +96,7 @@ void PowerProtocol::setPower(bool on) {
         if (_targetAmps <= 0.1f) {
              _rampingAmps = 0.0f; 
         } else {
-             _rampingAmps = (_targetAmps > SOFT_START_INITIAL_CURRENT) ? SOFT_START_INITIAL_CURRENT : _targetAmps;
+             _rampingAmps = (_targetAmps > _softStartInitial) ? _softStartInitial : _targetAmps;
         }
         _lastRampTime = _hal->getTickCount();
         sendSetCommand(_targetVolts, _rampingAmps);
@@ -117,61 +108,56 @@ void PowerProtocol::setPower(bool on) {
 
 void PowerProtocol::queryStatus() {
     HalCanFrame frame;
-    frame.id = ID_CMD_QUERY + _addr;
-    frame.len = 8;
-    frame.ext = true;
-    memset(frame.data, 0, 8);
-    frame.data[0] = 0x01;
+    PsuPolicy::encodeQueryStatus(_addr, frame);
     _hal->canSend(frame);
 }
 
 void PowerProtocol::queryInputVoltage() {
     HalCanFrame frame;
-    frame.id = ID_CMD_QUERY_IN + _addr;
-    frame.len = 8;
-    frame.ext = true;
-    memset(frame.data, 0, 8);
-    frame.data[0] = 0x31;
+    PsuPolicy::encodeQueryInput(_addr, frame);
     _hal->canSend(frame);
 }
 
-void PowerProtocol::parseFrame(const HalCanFrame& frame) {
-    if (frame.id == (ID_RESP_STATUS + _addr)) {
-        uint8_t cmdType = frame.data[0];
-
-        if (cmdType == 0x01) { 
-            uint16_t rawI = (frame.data[2] << 8) | frame.data[3];
-            uint16_t rawV = (frame.data[4] << 8) | frame.data[5];
-
-            _status.currentOut = rawI / 10.0f;
-            _status.voltageOut = rawV / 10.0f;
-            
-            bool hwIsOff = (frame.data[7] & 0x01);
-            _status.hwRunning = !hwIsOff;
-
-            if (!_startupCheckDone) {
-                if (hwIsOff) {
-                    setPower(true); 
-                } else {
-                    _status.isOn = true;
-                    _status.hwRunning = true;
-                    _softStartActive = false; 
-                    _targetVolts = _status.voltageOut;
-                }
-                _startupCheckDone = true; 
-            } 
-            _status.lastUpdate = _hal->getTickCount();
-        } else if (cmdType == 0x02) {
-            _status.powerCmdSuccess = (frame.data[1] != 0);
-        } else {
-            _status.setCmdSuccess = (frame.data[0] != 0);
-        }
-    }
-    else if (frame.id == (ID_RESP_INPUT + _addr)) {
-        if (frame.data[0] == 0x31) {
-            uint16_t rawInput = (frame.data[2] << 8) | frame.data[3];
-            _status.inputVoltage = rawInput / 32.0f;
-            _status.newInputVoltage = true;
-        }
+void PowerProtocol::applyMessage(const PsuMsg& msg, uint32_t timestampUs, uint32_t now) {
+    if (msg.type == PSU_MSG_STATUS) {
+        _status.currentOut = msg.rawI / 10.0f;
+        _status.voltageOut = msg.rawV / 10.0f;
+        _energy.addSample(msg.rawV, msg.rawI, timestampUs);
+        notifySample(false, msg.rawV, msg.rawI, timestampUs);
+
+        bool hwIsOff = msg.hwOff;
+        _status.hwRunning = !hwIsOff;
+
+        if (!_startupCheckDone) {
+            if (hwIsOff) {
+                setPower(true); 
+            } else {
+                _status.isOn = true;
+                _status.hwRunning = true;
+                _softStartActive = false; 
+                _targetVolts = _status.voltageOut;
+            }
+            _startupCheckDone = true; 
+        } 
+        _status.lastUpdate = now;
+        _responded = true;
+    } else if (msg.type == PSU_MSG_POWER_ACK) {
+        _status.powerCmdSuccess = msg.ok;
+    } else if (msg.type == PSU_MSG_SET_ACK) {
+        _status.setCmdSuccess = msg.ok;
+    } else if (msg.type == PSU_MSG_INPUT) {
+        _status.inputVoltage = msg.rawV / 32.0f;
+        _status.newInputVoltage = true;
+        notifySample(true, msg.rawV, 0, timestampUs);
     }
+}
+
+void PowerProtocol::notifySample(bool input, uint16_t rawV, uint16_t rawI, uint32_t timestampUs) {
+    if (!_listener) return;
+    PsuSample sample;
+    sample.input = input;
+    sample.rawV = rawV;
+    sample.rawI = rawI;
+    sample.timestampUs = timestampUs;
+    _listener(_listenerCtx, sample);
 }
\ No newline at end of file
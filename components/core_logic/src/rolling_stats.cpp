@@ -0,0 +1,107 @@
+#include "rolling_stats.h"
+#include <math.h>
+
+static_assert((STATS_WINDOW1_SAMPLES & (STATS_WINDOW1_SAMPLES - 1)) == 0 &&
+              (STATS_WINDOW2_SAMPLES & (STATS_WINDOW2_SAMPLES - 1)) == 0 &&
+              (STATS_WINDOW3_SAMPLES & (STATS_WINDOW3_SAMPLES - 1)) == 0,
+              "STATS_WINDOWn_SAMPLES must be powers of two");
+static_assert(STATS_WINDOW1_SAMPLES <= STATS_WINDOW3_SAMPLES && STATS_WINDOW2_SAMPLES <= STATS_WINDOW3_SAMPLES,
+              "STATS_WINDOW3_SAMPLES sizes the sample ring and must be the largest");
+
+RollingStats::RollingStats(float scale) : _scale(scale) {
+    static const uint32_t lengths[STATS_WINDOWS] = { STATS_WINDOW1_MS, STATS_WINDOW2_MS, STATS_WINDOW3_MS };
+    static const uint16_t caps[STATS_WINDOWS] = { STATS_WINDOW1_SAMPLES, STATS_WINDOW2_SAMPLES, STATS_WINDOW3_SAMPLES };
+
+    uint16_t base = 0;
+    for (int i = 0; i < STATS_WINDOWS; i++) {
+        _win[i].lengthMs = lengths[i];
+        _win[i].cap = caps[i];
+        _win[i].base = base;
+        base += 2 * caps[i];
+    }
+    reset();
+}
+
+void RollingStats::reset() {
+    _seq = 0;
+    for (int i = 0; i < STATS_WINDOWS; i++) clearWindow(_win[i]);
+}
+
+void RollingStats::clearWindow(Window& w) {
+    w.count = 0;
+    w.maxHead = w.maxTail = 0;
+    w.minHead = w.minTail = 0;
+    w.sum = 0;
+    w.sumSq = 0;
+}
+
+void RollingStats::setWindow(int w, uint32_t ms) {
+    if (w < 0 || w >= STATS_WINDOWS) return;
+    _win[w].lengthMs = ms;
+    clearWindow(_win[w]);
+}
+
+void RollingStats::popOldest(Window& w) {
+    // 視窗內的樣本永遠是最近的 count 個: 最舊的序號 = _seq - count
+    uint16_t oldest = (uint16_t)(_seq - w.count);
+    uint32_t v = rawAt(oldest);
+    w.sum -= v;
+    w.sumSq -= (uint64_t)v * v;
+    uint16_t mask = w.cap - 1;
+    if (w.maxHead != w.maxTail && maxQ(w)[w.maxHead & mask] == oldest) w.maxHead++;
+    if (w.minHead != w.minTail && minQ(w)[w.minHead & mask] == oldest) w.minHead++;
+    w.count--;
+}
+
+void RollingStats::pushBack(Window& w, uint16_t seq, uint16_t raw) {
+    uint16_t mask = w.cap - 1;
+    // 被新樣本「支配」的尾端不可能再成為 max / min
+    while (w.maxHead != w.maxTail && rawAt(maxQ(w)[(uint16_t)(w.maxTail - 1) & mask]) <= raw) w.maxTail--;
+    maxQ(w)[w.maxTail++ & mask] = seq;
+    while (w.minHead != w.minTail && rawAt(minQ(w)[(uint16_t)(w.minTail - 1) & mask]) >= raw) w.minTail--;
+    minQ(w)[w.minTail++ & mask] = seq;
+
+    w.sum += raw;
+    w.sumSq += (uint32_t)raw * raw;
+    w.count++;
+}
+
+void RollingStats::add(uint16_t raw, uint32_t nowMs) {
+    // 先淘汰: 寫入 ring 會覆蓋 RING_SIZE 個樣本之前的位置
+    for (int i = 0; i < STATS_WINDOWS; i++) {
+        if (_win[i].count == _win[i].cap) popOldest(_win[i]);
+    }
+
+    uint16_t seq = _seq;
+    _raw[seq & RING_MASK] = raw;
+    _time[seq & RING_MASK] = nowMs;
+    for (int i = 0; i < STATS_WINDOWS; i++) pushBack(_win[i], seq, raw);
+    _seq++;
+
+    expire(nowMs);
+}
+
+void RollingStats::expire(uint32_t nowMs) {
+    for (int i = 0; i < STATS_WINDOWS; i++) {
+        Window& w = _win[i];
+        while (w.count > 0 && nowMs - _time[(uint16_t)(_seq - w.count) & RING_MASK] >= w.lengthMs) {
+            popOldest(w);
+        }
+    }
+}
+
+bool RollingStats::get(int w, Result& out) const {
+    if (w < 0 || w >= STATS_WINDOWS || _win[w].count == 0) return false;
+    const Window& win = _win[w];
+    uint16_t mask = win.cap - 1;
+    uint16_t lo = rawAt(minQ(win)[win.minHead & mask]);
+    uint16_t hi = rawAt(maxQ(win)[win.maxHead & mask]);
+
+    out.count = win.count;
+    out.min = lo * _scale;
+    out.max = hi * _scale;
+    out.mean = (float)win.sum / win.count * _scale;
+    out.rms = sqrtf((float)win.sumSq / win.count) * _scale; // 相對誤差 ~1e-7，不需要 double
+    out.ripple = (hi - lo) * _scale;
+    return true;
+}
@@ -0,0 +1,120 @@
+#include "telemetry_stats.h"
+#include <stdio.h>
+#include <string.h>
+
+TelemetryStats::TelemetryStats(IHardwareHAL* hal, PowerProtocol* psu)
+    : _hal(hal), _psu(psu),
+      _ch{ RollingStats(0.1f), RollingStats(0.1f), RollingStats(1.0f / 32.0f) },
+      _lastAcPoll(0), _autoMs(0), _autoWindow(0), _lastAuto(0) {}
+
+void TelemetryStats::begin() {
+    _psu->setSampleListener(onSample, this);
+    _lastAcPoll = _hal->getTickCount();
+}
+
+void TelemetryStats::onSample(void* ctx, const PsuSample& sample) {
+    TelemetryStats* self = (TelemetryStats*)ctx;
+    uint32_t now = self->_hal->getTickCount();
+    if (sample.input) {
+        self->_ch[STAT_VIN].add(sample.rawV, now);
+    } else {
+        self->_ch[STAT_VOUT].add(sample.rawV, now);
+        self->_ch[STAT_IOUT].add(sample.rawI, now);
+    }
+}
+
+void TelemetryStats::loop() {
+    uint32_t now = _hal->getTickCount();
+    for (int c = 0; c < STAT_CHANNELS; c++) _ch[c].expire(now);
+
+    if (now - _lastAcPoll >= STATS_AC_POLL_MS) {
+        _lastAcPoll = now;
+        _psu->queryInputVoltage();
+    }
+
+    if (_autoMs > 0 && now - _lastAuto >= _autoMs) {
+        _lastAuto = now;
+        char buf[192];
+        formatWindow((int)_autoWindow, buf, sizeof(buf) - 2);
+        strcat(buf, "\r\n");
+        _hal->uartSend(buf);
+    }
+}
+
+uint32_t TelemetryStats::nextDeadline() const {
+    // 樣本淘汰只影響讀取結果，不需要自己的期限 (讀取前的 loop() 會先淘汰)
+    uint32_t deadline = _lastAcPoll + STATS_AC_POLL_MS;
+    if (_autoMs > 0) deadline = halTickMin(deadline, _lastAuto + _autoMs);
+    return deadline;
+}
+
+const char* TelemetryStats::channelName(StatsChannel c) {
+    switch (c) {
+        case STAT_VOUT: return "V";
+        case STAT_IOUT: return "I";
+        case STAT_VIN:  return "AC";
+        default:        return "?";
+    }
+}
+
+// STAT:W=10.0,V=N/min/mean/max/rms/pp,I=...,AC=...
+void TelemetryStats::formatWindow(int w, char* buf, size_t size) const {
+    uint32_t ms = _ch[STAT_VOUT].windowMs(w);
+    int n = snprintf(buf, size, "STAT:W=%lu.%lu", (unsigned long)(ms / 1000), (unsigned long)(ms % 1000 / 100));
+
+    for (int c = 0; c < STAT_CHANNELS && n > 0 && (size_t)n < size; c++) {
+        RollingStats::Result r;
+        if (_ch[c].get(w, r)) {
+            n += snprintf(buf + n, size - n, ",%s=%u/%.2f/%.2f/%.2f/%.2f/%.2f", channelName((StatsChannel)c),
+                          r.count, r.min, r.mean, r.max, r.rms, r.ripple);
+        } else {
+            n += snprintf(buf + n, size - n, ",%s=0", channelName((StatsChannel)c));
+        }
+    }
+}
+
+// --- UART Commands ---
+
+void TelemetryStats::registerCommands(CmdRegistry& reg) {
+    reg.add("GET:STAT",  "?u", cmdGet,    this);
+    reg.add("STAT:WIN",  "uf", cmdWindow, this);
+    reg.add("STAT:AUTO", "u?u", cmdAuto,  this);
+}
+
+// 視窗編號從 1 開始 (1 = 最短)
+CmdResult TelemetryStats::cmdGet(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    TelemetryStats* self = (TelemetryStats*)ctx;
+    uint32_t w = (args.count > 0) ? args.asUint(0) : 1;
+    if (w < 1 || w > RollingStats::STATS_WINDOWS) return CMD_ERR_RANGE;
+    self->formatWindow((int)w - 1, reply, size);
+    return CMD_OK;
+}
+
+// 視窗長度上限 = 視窗容量 x 狀態查詢週期 (超過時樣本數先滿，實際視窗會較短)
+CmdResult TelemetryStats::cmdWindow(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    TelemetryStats* self = (TelemetryStats*)ctx;
+    uint32_t w = args.asUint(0);
+    if (w < 1 || w > RollingStats::STATS_WINDOWS) return CMD_ERR_RANGE;
+    if (args.v[1] < 100) return CMD_ERR_RANGE;
+    uint32_t ms = (uint32_t)args.v[1]; // 定點 x1000 = ms
+    if (ms > self->_ch[STAT_VOUT].windowCapacity((int)w - 1) * PowerProtocol::QUERY_INTERVAL_MS) return CMD_ERR_RANGE;
+
+    for (int c = 0; c < STAT_CHANNELS; c++) self->_ch[c].setWindow((int)w - 1, ms);
+    snprintf(reply, size, "CMD_ACK:STAT_WIN:%lu:%.1f", (unsigned long)w, args.asFloat(1));
+    return CMD_OK;
+}
+
+// STAT:AUTO=ms[,視窗]，0 = 停止
+CmdResult TelemetryStats::cmdAuto(void* ctx, const CmdArgs& args, char* reply, size_t size) {
+    TelemetryStats* self = (TelemetryStats*)ctx;
+    uint32_t ms = args.asUint(0);
+    uint32_t w = (args.count > 1) ? args.asUint(1) : 1;
+    if (ms != 0 && ms < 100) return CMD_ERR_RANGE;
+    if (w < 1 || w > RollingStats::STATS_WINDOWS) return CMD_ERR_RANGE;
+
+    self->_autoMs = ms;
+    self->_autoWindow = w - 1;
+    self->_lastAuto = self->_hal->getTickCount();
+    snprintf(reply, size, "CMD_ACK:STAT_AUTO:%lu", (unsigned long)ms);
+    return CMD_OK;
+}
@@ -0,0 +1,104 @@
+#ifndef ESP32_HAL_H
+#define ESP32_HAL_H
+
+#include "hal_interface.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_timer.h>
+#include <nvs.h>
+#include <atomic>
+#include <u8g2.h>
+#include "u8g2_font_set.h"
+
+// ESP32 (ESP-IDF v5.x) 的 HAL 實作
+// 宣告放在公開標頭，main 以此類別具現化熱路徑模組 (PsuBusT<Esp32HAL>、AppUIT、SerialCmdT);
+// 實作在 src/hal_impl.cpp，實體由 getHal() 取得
+class Esp32HAL final : public IHardwareHAL {
+public:
+    // [重要] 建構子留空，不要在這裡做硬體初始化
+    Esp32HAL() {}
+
+    // [重要] 由 app_main 呼叫; I2C/OLED 初始化在背景 task 進行
+    void init() override;
+    void getBootTimes(HalBootTimes& out) override;
+
+    // System
+    // 熱路徑: 定義放在標頭，以 Esp32HAL 具現化的模組可以 inline
+    uint32_t getTickCount() override { return (uint32_t)(esp_timer_get_time() / 1000); }
+    void delayMs(uint32_t ms) override;
+    uint32_t waitEvents(uint32_t deadline) override;
+
+    // GPIO
+    bool readButton(HalButton btn) override;
+
+    // CAN
+    bool canSend(const HalCanFrame& frame) override;
+    bool canReceive(HalCanFrame& frame) override;
+    void canGetStats(HalCanStats& out) override;
+    bool canRecover() override;
+
+    // UART
+    void uartSend(const char* str) override;
+    int uartRead() override;
+    int uartAvailable() override;
+
+    // Storage (NVS)
+    bool storageRead(const char* key, void* buf, size_t len) override;
+    bool storageWrite(const char* key, const void* buf, size_t len) override;
+    bool storageCommit() override;
+
+    // Display (U8g2)
+    void displayClear() override;
+    void displayDrawString(int x, int y, const char* str, int fontSize) override;
+    void displayShow() override;
+    int displayTextWidth(const char* str, int fontSize) override;
+    void displayFontMetrics(int fontSize, HalFontMetrics& out) override;
+
+private:
+    u8g2_t _u8g2;
+    U8g2FontSet _fontSet; // 字型 slot、glyph 位移表與字形快取 (與 host 的 BenchHAL 共用)
+    // 顯示 RAM 的副本: SendBuffer 只送出與上次不同的 tile，數值更新時 I2C 傳輸量從 1 KB 降到數十 bytes
+    uint8_t _shadowRam[U8X8_SHADOW_RAM_SIZE(128 / 8, 64 / 8)];
+    HalBootTimes _bootTimes;
+    std::atomic<bool> _displayReady{false};
+    uint32_t _displayInitUs = 0;
+    nvs_handle_t _nvs = 0;
+
+    // CAN 統計 (只在主迴圈存取)
+    static const uint32_t CAN_BITRATE = 125000;
+    static const uint32_t CAN_RX_QUEUE_LEN = 16;
+    static const uint32_t CAN_TX_QUEUE_LEN = 8;
+    uint32_t _canTxFrames = 0;
+    uint32_t _canRxFrames = 0;
+    uint32_t _canTxBytes = 0;
+    uint32_t _canRxBytes = 0;
+    uint32_t _canRxHigh = 0;
+    uint32_t _canTxHigh = 0;
+    std::atomic<uint32_t> _canBusOffCount{0}; // alert task 寫入
+    bool _canRxDraining = false;
+
+    // --- 事件通知 ---
+    static const uint32_t EVT_ALL = HAL_EVT_CAN | HAL_EVT_UART | HAL_EVT_BUTTON;
+    static const uint32_t EVT_DEADLINE = 1u << 31; // 內部使用: 期限計時到期
+    TaskHandle_t _mainTask = NULL;
+    esp_timer_handle_t _wakeTimer = NULL;
+    QueueHandle_t _uartQueue = NULL;
+
+    static void wakeTimerCb(void* arg);
+    void notify(uint32_t evt);
+    static void buttonIsr(void* arg);
+    static void canAlertTask(void* arg);
+    static void uartEventTask(void* arg);
+
+    static void displayInitTask(void* arg);
+    void runDisplayInit();
+    void initGpio();
+    void initCan();
+    void initStorage();
+    void initUart();
+    void initI2cAndU8g2();
+};
+
+#endif // ESP32_HAL_H
@@ -1,4 +1,4 @@
-#include "hal_interface.h"
+#include "esp32_hal.h"
 #include "port_def.h"
 
 #include <driver/gpio.h>
@@ -6,10 +6,15 @@
 #include <driver/uart.h>
 #include <driver/i2c_master.h>
 #include <esp_timer.h>
+#include <nvs_flash.h>
+#include <nvs.h>
 #include <esp_rom_sys.h> // ESP-IDF v5.x 延遲函數
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_attr.h>
 #include <string.h>
+#include <atomic>
 #include <u8g2.h>
 
 // --- Global Handles for New I2C Driver ---
@@ -44,31 +49,58 @@ uint8_t u8x8_gpio_and_delay_esp32(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
 // 2. I2C Byte Callback (Adapted for ESP-IDF v5.x I2C Master)
 // U8g2 的傳輸模式是: Start -> Send Bytes... -> End
 // 新版 ESP-IDF 需要一次性傳輸，所以我們需要一個 Buffer
-#define I2C_BUFFER_SIZE 256
+// stream CAD 會把整個畫面 (位址設定 + 0x40 + 128x64/8 bytes) 放在同一筆傳輸，Buffer 必須容納 1037 bytes
+#define I2C_BUFFER_SIZE 1056
 static uint8_t i2c_buffer[I2C_BUFFER_SIZE];
 static size_t i2c_buffer_len = 0;
+static bool i2c_overflow = false; // 本次傳輸有資料放不下: 整筆不送出
+static bool i2c_failed = false;   // 有傳輸失敗，由 displayShow() 清除
+
+static void i2c_buffer_add(const uint8_t *data, size_t len) {
+    if (i2c_buffer_len + len > I2C_BUFFER_SIZE) {
+        i2c_overflow = true;
+        return;
+    }
+    memcpy(&i2c_buffer[i2c_buffer_len], data, len);
+    i2c_buffer_len += len;
+}
 
 uint8_t u8x8_byte_esp32_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr) {
     switch (msg) {
-        case U8X8_MSG_BYTE_SEND: {
+        case U8X8_MSG_BYTE_SEND:
             // 將資料暫存到 Buffer
-            uint8_t *data = (uint8_t *)arg_ptr;
-            if (i2c_buffer_len + arg_int < I2C_BUFFER_SIZE) {
-                memcpy(&i2c_buffer[i2c_buffer_len], data, arg_int);
-                i2c_buffer_len += arg_int;
+            i2c_buffer_add((uint8_t *)arg_ptr, arg_int);
+            break;
+        case U8X8_MSG_BYTE_SEND_SEGMENTS: {
+            // 一次收下多段資料 (I2C 不需要 DC)，省去每段一次的 callback
+            // 放不下時仍回傳 1 (回傳 0 代表不支援，u8x8 會改用 BYTE_SEND 重送)，在 END_TRANSFER 回報失敗
+            u8x8_segment_t *seg = (u8x8_segment_t *)arg_ptr;
+            for (uint8_t i = 0; i < arg_int; i++) {
+                i2c_buffer_add(seg[i].ptr, seg[i].len);
             }
             break;
         }
         case U8X8_MSG_BYTE_START_TRANSFER:
             // 開始傳輸前，清空 Buffer
             i2c_buffer_len = 0;
+            i2c_overflow = false;
             break;
             
         case U8X8_MSG_BYTE_END_TRANSFER:
             // 結束傳輸時，一次性發送 Buffer 內容
+            // 缺少部分位元組的傳輸會讓控制器的位址與畫面錯位，整筆放棄並回傳失敗
+            if (i2c_overflow) {
+                printf("HAL: I2C transfer exceeds %d bytes, dropped\n", I2C_BUFFER_SIZE);
+                i2c_buffer_len = 0;
+                i2c_failed = true;
+                return 0;
+            }
             if (g_oled_handle && i2c_buffer_len > 0) {
                 // 使用新版 API 發送
-                i2c_master_transmit(g_oled_handle, i2c_buffer, i2c_buffer_len, -1);
+                if (i2c_master_transmit(g_oled_handle, i2c_buffer, i2c_buffer_len, -1) != ESP_OK) {
+                    i2c_failed = true;
+                    return 0;
+                }
             }
             break;
             
@@ -83,199 +115,430 @@ uint8_t u8x8_byte_esp32_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
 
 // --- HAL Implementation ---
 
-class Esp32HAL : public IHardwareHAL {
-public:
-    // [重要] 建構子留空，不要在這裡做硬體初始化
-    Esp32HAL() {}
-
-    // [重要] 新增 init 實作，由 app_main 呼叫
-    void init() override {
-        printf("HAL: Init GPIO...\n");
-        initGpio();
-        
-        printf("HAL: Init CAN...\n");
-        initCan();
-        
-        printf("HAL: Init UART...\n");
-        initUart();
-        
-        printf("HAL: Init I2C & OLED...\n");
-        initI2cAndU8g2();
-        
-        printf("HAL: Init Done!\n");
-    }
+// [重要] 新增 init 實作，由 app_main 呼叫
+// I2C/OLED 初始化 (含多個 ms 等級的延遲) 放到背景 task，
+// 與 GPIO/CAN/UART 初始化及後續的 PSU 偵測重疊進行
+void Esp32HAL::init() {
+    int64_t t0 = esp_timer_get_time();
+    memset(&_bootTimes, 0, sizeof(_bootTimes));
+    // 字型標頭只解析一次，之後繪圖時直接切換 slot
+    _fontSet.begin();
+    // 事件通知的對象: 呼叫 init() 的任務 (app_main 主迴圈)
+    _mainTask = xTaskGetCurrentTaskHandle();
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = wakeTimerCb;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "evt_wake";
+    esp_timer_create(&timerArgs, &_wakeTimer);
 
-    // System
-    uint32_t getTickCount() override {
-        return (uint32_t)(esp_timer_get_time() / 1000);
+    printf("HAL: Init I2C & OLED (background)...\n");
+    if (xTaskCreate(displayInitTask, "oled_init", 4096, this, 5, NULL) != pdPASS) {
+        runDisplayInit(); // 建立 task 失敗時退回同步初始化
     }
 
-    void delayMs(uint32_t ms) override {
-        vTaskDelay(pdMS_TO_TICKS(ms));
-    }
+    int64_t t = esp_timer_get_time();
+    printf("HAL: Init GPIO...\n");
+    initGpio();
+    _bootTimes.gpioUs = (uint32_t)(esp_timer_get_time() - t);
+    
+    t = esp_timer_get_time();
+    printf("HAL: Init CAN...\n");
+    initCan();
+    _bootTimes.canUs = (uint32_t)(esp_timer_get_time() - t);
+    
+    t = esp_timer_get_time();
+    printf("HAL: Init UART...\n");
+    initUart();
+    _bootTimes.uartUs = (uint32_t)(esp_timer_get_time() - t);
 
-    // GPIO
-    bool readButton(HalButton btn) override {
-        gpio_num_t pin;
-        switch(btn) {
-            case BTN_SELECT: pin = PIN_BTN_SEL; break;
-            case BTN_UP:     pin = PIN_BTN_UP; break;
-            case BTN_DOWN:   pin = PIN_BTN_DOWN; break;
-            default: return false;
-        }
-        // Active Low
-        return gpio_get_level(pin) == 0;
-    }
+    t = esp_timer_get_time();
+    printf("HAL: Init NVS...\n");
+    initStorage();
+    _bootTimes.storageUs = (uint32_t)(esp_timer_get_time() - t);
 
-    // CAN
-    bool canSend(const HalCanFrame& frame) override {
-        twai_message_t msg;
-        msg.identifier = frame.id;
-        msg.extd = frame.ext;
-        msg.data_length_code = frame.len;
-        memcpy(msg.data, frame.data, frame.len);
-        return twai_transmit(&msg, 0) == ESP_OK;
+    _bootTimes.initUs = (uint32_t)(esp_timer_get_time() - t0);
+    printf("HAL: Init Done! (%lu us, OLED pending)\n", (unsigned long)_bootTimes.initUs);
+}
+
+void Esp32HAL::getBootTimes(HalBootTimes& out) {
+    out = _bootTimes;
+    out.displayUs = _displayReady ? _displayInitUs : 0;
+}
+
+// System
+void Esp32HAL::delayMs(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// 事件由 TWAI alert task、UART event task 與按鍵 GPIO ISR 以 task notification 送出
+// 期限由 esp_timer 單次計時喚醒 (us 解析度)，不受 FreeRTOS tick (預設 10 ms) 限制，
+// 曲線序列器等時間敏感的工作可以準時到 1 ms
+uint32_t Esp32HAL::waitEvents(uint32_t deadline) {
+    int64_t nowUs = esp_timer_get_time();
+    uint32_t nowMs = (uint32_t)(nowUs / 1000);
+    uint32_t bits = 0;
+    if (!halTickBefore(nowMs, deadline) || !_wakeTimer) {
+        xTaskNotifyWait(0, EVT_ALL | EVT_DEADLINE, &bits, 0);
+        return bits & EVT_ALL;
     }
+    int64_t wakeUs = ((nowUs / 1000) + (int32_t)(deadline - nowMs)) * 1000;
+    esp_timer_start_once(_wakeTimer, (uint64_t)(wakeUs - nowUs));
+    xTaskNotifyWait(0, EVT_ALL | EVT_DEADLINE, &bits, portMAX_DELAY);
+    // 事件先到時取消計時; 若計時剛好已觸發，下一次等待會多醒來一次 (無害)
+    esp_timer_stop(_wakeTimer);
+    return bits & EVT_ALL;
+}
 
-    bool canReceive(HalCanFrame& frame) override {
-        twai_message_t msg;
-        if (twai_receive(&msg, 0) == ESP_OK) {
-            frame.id = msg.identifier;
-            frame.ext = msg.extd;
-            frame.len = msg.data_length_code;
-            memcpy(frame.data, msg.data, msg.data_length_code);
-            return true;
-        }
-        return false;
+// GPIO
+bool Esp32HAL::readButton(HalButton btn) {
+    gpio_num_t pin;
+    switch(btn) {
+        case BTN_SELECT: pin = PIN_BTN_SEL; break;
+        case BTN_UP:     pin = PIN_BTN_UP; break;
+        case BTN_DOWN:   pin = PIN_BTN_DOWN; break;
+        default: return false;
     }
+    // Active Low
+    return gpio_get_level(pin) == 0;
+}
 
-    // UART
-    void uartSend(const char* str) override {
-        uart_write_bytes(CMD_UART_PORT, str, strlen(str));
+// CAN
+bool Esp32HAL::canSend(const HalCanFrame& frame) {
+    twai_message_t msg;
+    msg.identifier = frame.id;
+    msg.extd = frame.ext;
+    msg.data_length_code = frame.len;
+    memcpy(msg.data, frame.data, frame.len);
+    if (twai_transmit(&msg, 0) != ESP_OK) return false;
+    _canTxFrames++;
+    _canTxBytes += frame.len;
+    // 送出後立即取樣 TX 佇列長度 (只在送出時才可能增加)
+    twai_status_info_t info;
+    if (twai_get_status_info(&info) == ESP_OK && info.msgs_to_tx > _canTxHigh) {
+        _canTxHigh = info.msgs_to_tx;
     }
+    return true;
+}
 
-    int uartRead() override {
-        uint8_t data;
-        int len = uart_read_bytes(CMD_UART_PORT, &data, 1, 0);
-        if (len > 0) return data;
-        return -1;
+bool Esp32HAL::canReceive(HalCanFrame& frame) {
+    // 每一輪讀取的第一次呼叫取樣 RX 佇列長度 (此時佇列最長)
+    if (!_canRxDraining) {
+        twai_status_info_t info;
+        if (twai_get_status_info(&info) == ESP_OK && info.msgs_to_rx > _canRxHigh) {
+            _canRxHigh = info.msgs_to_rx;
+        }
     }
-    
-    int uartAvailable() override {
-        size_t size;
-        uart_get_buffered_data_len(CMD_UART_PORT, &size);
-        return (int)size;
+    twai_message_t msg;
+    if (twai_receive(&msg, 0) == ESP_OK) {
+        frame.id = msg.identifier;
+        frame.ext = msg.extd;
+        frame.len = msg.data_length_code;
+        memcpy(frame.data, msg.data, msg.data_length_code);
+        // TWAI 驅動沒有接收時間戳，以取出佇列的時間代替 (主迴圈由 RX alert 立即喚醒)
+        frame.timestampUs = (uint32_t)esp_timer_get_time();
+        _canRxFrames++;
+        _canRxBytes += msg.data_length_code;
+        _canRxDraining = true;
+        return true;
     }
+    _canRxDraining = false;
+    return false;
+}
 
-    // Display (U8g2)
-    void displayClear() override {
-        u8g2_ClearBuffer(&_u8g2);
+void Esp32HAL::canGetStats(HalCanStats& out) {
+    memset(&out, 0, sizeof(out));
+    twai_status_info_t info;
+    if (twai_get_status_info(&info) == ESP_OK) {
+        switch (info.state) {
+            case TWAI_STATE_RUNNING:    out.state = HAL_CAN_RUNNING; break;
+            case TWAI_STATE_BUS_OFF:    out.state = HAL_CAN_BUS_OFF; break;
+            case TWAI_STATE_RECOVERING: out.state = HAL_CAN_RECOVERING; break;
+            default:                    out.state = HAL_CAN_STOPPED; break;
+        }
+        out.txErrorCounter = (uint16_t)info.tx_error_counter;
+        out.rxErrorCounter = (uint16_t)info.rx_error_counter;
+        out.arbLost   = info.arb_lost_count;
+        out.busErrors = info.bus_error_count;
+        out.rxMissed  = info.rx_missed_count;
+        out.rxOverrun = info.rx_overrun_count;
+        out.txFailed  = info.tx_failed_count;
+        out.rxQueueLen = (uint16_t)info.msgs_to_rx;
+        out.txQueueLen = (uint16_t)info.msgs_to_tx;
+        if (info.msgs_to_rx > _canRxHigh) _canRxHigh = info.msgs_to_rx;
+        if (info.msgs_to_tx > _canTxHigh) _canTxHigh = info.msgs_to_tx;
     }
+    out.bitrate = CAN_BITRATE;
+    out.busOffCount = _canBusOffCount;
+    out.txFrames = _canTxFrames;
+    out.rxFrames = _canRxFrames;
+    out.txBytes = _canTxBytes;
+    out.rxBytes = _canRxBytes;
+    out.rxQueueHigh = (uint16_t)_canRxHigh;
+    out.txQueueHigh = (uint16_t)_canTxHigh;
+    out.rxQueueSize = CAN_RX_QUEUE_LEN;
+    out.txQueueSize = CAN_TX_QUEUE_LEN;
+}
+
+bool Esp32HAL::canRecover() {
+    return twai_initiate_recovery() == ESP_OK;
+}
+
+// UART
+void Esp32HAL::uartSend(const char* str) {
+    uart_write_bytes(CMD_UART_PORT, str, strlen(str));
+}
+
+int Esp32HAL::uartRead() {
+    uint8_t data;
+    int len = uart_read_bytes(CMD_UART_PORT, &data, 1, 0);
+    if (len > 0) return data;
+    return -1;
+}
+
+int Esp32HAL::uartAvailable() {
+    size_t size;
+    uart_get_buffered_data_len(CMD_UART_PORT, &size);
+    return (int)size;
+}
+
+// Storage (NVS)
+bool Esp32HAL::storageRead(const char* key, void* buf, size_t len) {
+    if (!_nvs) return false;
+    size_t size = len;
+    if (nvs_get_blob(_nvs, key, buf, &size) != ESP_OK) return false;
+    return size == len;
+}
+
+bool Esp32HAL::storageWrite(const char* key, const void* buf, size_t len) {
+    if (!_nvs) return false;
+    return nvs_set_blob(_nvs, key, buf, len) == ESP_OK;
+}
+
+bool Esp32HAL::storageCommit() {
+    if (!_nvs) return false;
+    return nvs_commit(_nvs) == ESP_OK;
+}
+
+// Display (U8g2)
+// 顯示器尚未在背景完成初始化前，忽略所有繪圖呼叫
+void Esp32HAL::displayClear() {
+    if (!_displayReady) return;
+    u8g2_ClearBuffer(&_u8g2);
+}
+
+void Esp32HAL::displayDrawString(int x, int y, const char* str, int fontSize) {
+    if (!_displayReady) return;
+    _fontSet.select(&_u8g2, fontSize);
+    // U8g2 座標系是 Baseline，這裡 +8 讓它行為接近左上角座標系
+    u8g2_DrawStr(&_u8g2, x, y + 8, str);
+}
+
+void Esp32HAL::displayShow() {
+    if (!_displayReady) return;
+    i2c_failed = false;
+    u8g2_SendBuffer(&_u8g2);
+    // 顯示 RAM 的副本已記錄為送出，傳輸失敗時作廢，下一次整個畫面重送
+    if (i2c_failed) u8g2_InvalidateShadowRAM(&_u8g2);
+}
+
+int Esp32HAL::displayTextWidth(const char* str, int fontSize) {
+    // 初始化期間 u8g2 由背景 task 使用; 兩個字型都是等寬字型，以最大字寬估算
+    if (!_displayReady) return (int)strlen(str) * _fontSet.info(fontSize).max_char_width;
+    _fontSet.select(&_u8g2, fontSize);
+    return u8g2_GetStrWidth(&_u8g2, str);
+}
+
+void Esp32HAL::displayFontMetrics(int fontSize, HalFontMetrics& out) {
+    _fontSet.metrics(fontSize, out);
+}
+
+void Esp32HAL::wakeTimerCb(void* arg) {
+    ((Esp32HAL*)arg)->notify(EVT_DEADLINE);
+}
+
+void Esp32HAL::notify(uint32_t evt) {
+    if (_mainTask) xTaskNotify(_mainTask, evt, eSetBits);
+}
 
-    void displayDrawString(int x, int y, const char* str, int fontSize) override {
-        if (fontSize == 0) {
-            u8g2_SetFont(&_u8g2, u8g2_font_6x10_tf);
-        } else {
-            u8g2_SetFont(&_u8g2, u8g2_font_profont17_tf);
+void IRAM_ATTR Esp32HAL::buttonIsr(void* arg) {
+    Esp32HAL* self = (Esp32HAL*)arg;
+    BaseType_t woken = pdFALSE;
+    if (self->_mainTask) xTaskNotifyFromISR(self->_mainTask, HAL_EVT_BUTTON, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// TWAI alert: 收到訊框、錯誤狀態改變時喚醒主迴圈
+// 同時計算 bus-off 次數，復原完成後重新啟動控制器
+void Esp32HAL::canAlertTask(void* arg) {
+    Esp32HAL* self = (Esp32HAL*)arg;
+    for (;;) {
+        uint32_t alerts = 0;
+        if (twai_read_alerts(&alerts, portMAX_DELAY) != ESP_OK) continue;
+        if (alerts & TWAI_ALERT_BUS_OFF) {
+            self->_canBusOffCount++;
+        }
+        if (alerts & TWAI_ALERT_BUS_RECOVERED) {
+            twai_start();
         }
-        // U8g2 座標系是 Baseline，這裡 +8 讓它行為接近左上角座標系
-        u8g2_DrawStr(&_u8g2, x, y + 8, str);
+        self->notify(HAL_EVT_CAN);
     }
+}
 
-    void displayShow() override {
-        u8g2_SendBuffer(&_u8g2);
+// UART pattern (換行) 偵測: 收到完整一行才喚醒主迴圈
+void Esp32HAL::uartEventTask(void* arg) {
+    Esp32HAL* self = (Esp32HAL*)arg;
+    uart_event_t ev;
+    for (;;) {
+        if (xQueueReceive(self->_uartQueue, &ev, portMAX_DELAY) != pdTRUE) continue;
+        switch (ev.type) {
+            case UART_PATTERN_DET:
+                uart_pattern_pop_pos(CMD_UART_PORT); // 不使用位置，只避免位置佇列填滿
+                self->notify(HAL_EVT_UART);
+                break;
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                uart_flush_input(CMD_UART_PORT);
+                xQueueReset(self->_uartQueue);
+                self->notify(HAL_EVT_UART);
+                break;
+            default:
+                break;
+        }
     }
+}
 
-private:
-    u8g2_t _u8g2;
-
-    void initGpio() {
-        gpio_config_t io_conf = {};
-        io_conf.intr_type = GPIO_INTR_DISABLE;
-        io_conf.mode = GPIO_MODE_INPUT;
-        io_conf.pin_bit_mask = (1ULL<<PIN_BTN_SEL) | (1ULL<<PIN_BTN_UP) | (1ULL<<PIN_BTN_DOWN);
-        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-        io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
-        gpio_config(&io_conf);
-    }
+void Esp32HAL::displayInitTask(void* arg) {
+    ((Esp32HAL*)arg)->runDisplayInit();
+    vTaskDelete(NULL);
+}
 
-    void initCan() {
-        twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(PIN_CAN_TX, PIN_CAN_RX, TWAI_MODE_NORMAL);
-        twai_timing_config_t t_config = TWAI_TIMING_CONFIG_125KBITS();
-        twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
-        twai_driver_install(&g_config, &t_config, &f_config);
-        twai_start();
-    }
+void Esp32HAL::runDisplayInit() {
+    int64_t t = esp_timer_get_time();
+    initI2cAndU8g2();
+    _displayInitUs = (uint32_t)(esp_timer_get_time() - t);
+    _displayReady = true;
+    printf("HAL: OLED ready (%lu us)\n", (unsigned long)_displayInitUs);
+}
 
-    void initUart() {
-        // 初始化 Command UART (UART2)
-        uart_config_t uart_config = {
-            .baud_rate = CMD_UART_BAUD,
-            .data_bits = UART_DATA_8_BITS,
-            .parity    = UART_PARITY_DISABLE,
-            .stop_bits = UART_STOP_BITS_1,
-            .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
-            .rx_flow_ctrl_thresh = 122,
-            .source_clk = UART_SCLK_DEFAULT,
-            // [修正] 完整初始化 flags 結構
-            .flags = {
-                .backup_before_sleep = 0, // 補上這個
-            }
-        };
-        
-        uart_driver_install(CMD_UART_PORT, 1024, 0, 0, NULL, 0);
-        uart_param_config(CMD_UART_PORT, &uart_config);
-        uart_set_pin(CMD_UART_PORT, CMD_UART_TX, CMD_UART_RX, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    }
+void Esp32HAL::initGpio() {
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_ANYEDGE; // 按下與放開都喚醒主迴圈
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = (1ULL<<PIN_BTN_SEL) | (1ULL<<PIN_BTN_UP) | (1ULL<<PIN_BTN_DOWN);
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    gpio_config(&io_conf);
 
-    void initI2cAndU8g2() {
-        // 1. New I2C Master Bus Init
-        i2c_master_bus_config_t i2c_mst_config = {
-            .i2c_port = I2C_PORT,
-            .sda_io_num = PIN_SDA,
-            .scl_io_num = PIN_SCL,
-            .clk_source = I2C_CLK_SRC_DEFAULT,
-            .glitch_ignore_cnt = 7,
-            .intr_priority = 0,
-            .trans_queue_depth = 0,
-            // [修正] 完整初始化 flags 結構
-            .flags = {
-                .enable_internal_pullup = 1,
-                .allow_pd = 0, // 補上這個 (Allow Power Down)
-            }
-        };
-
-        ESP_ERROR_CHECK(i2c_new_master_bus(&i2c_mst_config, &g_i2c_bus_handle));
-
-        // 2. Add OLED Device
-        i2c_device_config_t dev_cfg = {
-            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
-            .device_address = OLED_ADDR,
-            .scl_speed_hz = I2C_SPEED_HZ, // 這裡對應 port_def.h 的定義
-            .scl_wait_us = 0,             // 建議補上這個初始化
-            .flags = { .disable_ack_check = 0 }, // 建議補上這個初始化
-        };
-        ESP_ERROR_CHECK(i2c_master_bus_add_device(g_i2c_bus_handle, &dev_cfg, &g_oled_handle));
-
-        // 3. U8g2 Init
-        u8g2_Setup_ssd1306_i2c_128x64_noname_f(
-            &_u8g2,
-            U8G2_R0,
-            u8x8_byte_esp32_hw_i2c,
-            u8x8_gpio_and_delay_esp32
-        );
-
-        u8x8_SetI2CAddress(&_u8g2.u8x8, OLED_ADDR << 1);
-        u8g2_InitDisplay(&_u8g2);
-        u8g2_SetPowerSave(&_u8g2, 0);
-        
-        // 測試畫面
-        u8g2_ClearBuffer(&_u8g2);
-        u8g2_SetFont(&_u8g2, u8g2_font_6x10_tf);
-        u8g2_DrawStr(&_u8g2, 0, 10, "System Ready");
-        u8g2_SendBuffer(&_u8g2);
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add(PIN_BTN_SEL, buttonIsr, this);
+    gpio_isr_handler_add(PIN_BTN_UP, buttonIsr, this);
+    gpio_isr_handler_add(PIN_BTN_DOWN, buttonIsr, this);
+}
+
+void Esp32HAL::initCan() {
+    twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(PIN_CAN_TX, PIN_CAN_RX, TWAI_MODE_NORMAL);
+    g_config.rx_queue_len = CAN_RX_QUEUE_LEN;
+    g_config.tx_queue_len = CAN_TX_QUEUE_LEN;
+    g_config.alerts_enabled = TWAI_ALERT_RX_DATA | TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_ERR_PASS |
+                              TWAI_ALERT_BUS_OFF | TWAI_ALERT_BUS_RECOVERED;
+    twai_timing_config_t t_config = TWAI_TIMING_CONFIG_125KBITS(); // 需與 CAN_BITRATE 一致
+    twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    twai_driver_install(&g_config, &t_config, &f_config);
+    twai_start();
+    xTaskCreate(canAlertTask, "can_alert", 2048, this, 10, NULL);
+}
+
+void Esp32HAL::initStorage() {
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        // NVS 分割區格式不符，清除後重新初始化 (設定回到預設值)
+        nvs_flash_erase();
+        err = nvs_flash_init();
     }
-};
+    if (err != ESP_OK || nvs_open("psu_cfg", NVS_READWRITE, &_nvs) != ESP_OK) {
+        printf("HAL: NVS unavailable, settings will not persist\n");
+        _nvs = 0;
+    }
+}
+
+void Esp32HAL::initUart() {
+    // 初始化 Command UART (UART2)
+    uart_config_t uart_config = {
+        .baud_rate = CMD_UART_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity    = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .rx_flow_ctrl_thresh = 122,
+        .source_clk = UART_SCLK_DEFAULT,
+        // [修正] 完整初始化 flags 結構
+        .flags = {
+            .backup_before_sleep = 0, // 補上這個
+        }
+    };
+    
+    uart_driver_install(CMD_UART_PORT, 1024, 0, 16, &_uartQueue, 0);
+    uart_param_config(CMD_UART_PORT, &uart_config);
+    uart_set_pin(CMD_UART_PORT, CMD_UART_TX, CMD_UART_RX, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+
+    // 換行字元觸發 pattern 中斷
+    uart_enable_pattern_det_baud_intr(CMD_UART_PORT, '\n', 1, 9, 0, 0);
+    uart_pattern_queue_reset(CMD_UART_PORT, 16);
+    xTaskCreate(uartEventTask, "uart_evt", 2048, this, 10, NULL);
+}
+
+void Esp32HAL::initI2cAndU8g2() {
+    // 1. New I2C Master Bus Init
+    i2c_master_bus_config_t i2c_mst_config = {
+        .i2c_port = I2C_PORT,
+        .sda_io_num = PIN_SDA,
+        .scl_io_num = PIN_SCL,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .intr_priority = 0,
+        .trans_queue_depth = 0,
+        // [修正] 完整初始化 flags 結構
+        .flags = {
+            .enable_internal_pullup = 1,
+            .allow_pd = 0, // 補上這個 (Allow Power Down)
+        }
+    };
+
+    ESP_ERROR_CHECK(i2c_new_master_bus(&i2c_mst_config, &g_i2c_bus_handle));
+
+    // 2. Add OLED Device
+    i2c_device_config_t dev_cfg = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = OLED_ADDR,
+        .scl_speed_hz = I2C_SPEED_HZ, // 這裡對應 port_def.h 的定義
+        .scl_wait_us = 0,             // 建議補上這個初始化
+        .flags = { .disable_ack_check = 0 }, // 建議補上這個初始化
+    };
+    ESP_ERROR_CHECK(i2c_master_bus_add_device(g_i2c_bus_handle, &dev_cfg, &g_oled_handle));
+
+    // 3. U8g2 Init
+    u8g2_Setup_ssd1306_i2c_128x64_noname_f(
+        &_u8g2,
+        U8G2_R0,
+        u8x8_byte_esp32_hw_i2c,
+        u8x8_gpio_and_delay_esp32
+    );
+    // 資料不切成 24 bytes 的小段，連續的資料在同一筆 I2C 傳輸送出
+    _u8g2.u8x8.cad_cb = u8x8_cad_ssd13xx_stream_i2c;
+    _fontSet.attach(&_u8g2);
+    u8g2_SetShadowRAM(&_u8g2, _shadowRam);
+
+    u8x8_SetI2CAddress(&_u8g2.u8x8, OLED_ADDR << 1);
+    u8g2_InitDisplay(&_u8g2);
+    u8g2_SetPowerSave(&_u8g2, 0);
+    
+    // 測試畫面
+    u8g2_ClearBuffer(&_u8g2);
+    _fontSet.select(&_u8g2, HAL_FONT_SMALL);
+    u8g2_DrawStr(&_u8g2, 0, 10, "System Ready");
+    u8g2_SendBuffer(&_u8g2);
+}
 
 // Global HAL Instance
 Esp32HAL g_hal;
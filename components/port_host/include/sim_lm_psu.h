@@ -0,0 +1,58 @@
+#ifndef SIM_LM_PSU_H
+#define SIM_LM_PSU_H
+
+#include "virtual_clock_hal.h"
+
+// 模擬一台 LianMing V2.0 整流模塊 (接在 VirtualClockHAL 的 CAN Bus 上)
+// 負載模型: 電阻性負載 (可選串接電池電動勢)，輸出受電流限制 (CC/CV)
+class SimLmPsu {
+public:
+    SimLmPsu(VirtualClockHAL* hal, uint8_t addr);
+
+    // 回應延遲 (ms)，模擬模塊處理時間
+    void setResponseDelay(uint32_t ms) { _respDelay = ms; }
+    // 負載: I = (V - emf) / ohms，ohms <= 0 表示開路 (接觸器未吸合)
+    void setLoad(float ohms, float emf = 0.0f) { _loadOhms = ohms; _loadEmf = emf; }
+    void setInputVoltage(float v) { _inputVoltage = v; }
+    // 故障: 模塊關閉輸出且狀態回報 hw off
+    void setFault(bool fault) { _fault = fault; }
+    // 離線: 完全不回應任何 CAN 訊框
+    void setOffline(bool offline) { _offline = offline; }
+    void setRunning(bool on) { _running = on; }
+    // 啟動時間 (ms): 開機指令後這段期間狀態仍回報 hw off、沒有輸出
+    void setStartupDelay(uint32_t ms) { _startDelay = ms; }
+
+    bool isRunning() const { return _running && !_fault && _hal->now() >= _runningAt; }
+    float setVoltage() const { return _setV; }
+    float setCurrent() const { return _setI; }
+    float outputVoltage() const;
+    float outputCurrent() const;
+
+    // 給 VirtualClockHAL::setCanTxHandler 使用; 多台模塊可串接呼叫
+    bool handleFrame(const HalCanFrame& frame);
+
+private:
+    VirtualClockHAL* _hal;
+    uint8_t _addr;
+    uint32_t _respDelay;
+    uint32_t _startDelay;
+    uint64_t _runningAt;
+
+    bool _running;
+    bool _fault;
+    bool _offline;
+    float _setV;
+    float _setI;
+    float _loadOhms;
+    float _loadEmf;
+    float _inputVoltage;
+
+    static const uint32_t ID_CMD      = 0x1907C080;
+    static const uint32_t ID_RESP     = 0x1807C080;
+    static const uint32_t ID_CMD_IN   = 0x1907A080;
+    static const uint32_t ID_RESP_IN  = 0x1807A080;
+
+    void reply(const HalCanFrame& frame);
+};
+
+#endif // SIM_LM_PSU_H
@@ -0,0 +1,136 @@
+#ifndef VIRTUAL_CLOCK_HAL_H
+#define VIRTUAL_CLOCK_HAL_H
+
+#include "hal_interface.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+// 離散事件 (Discrete-Event) 虛擬時鐘 HAL
+// - getTickCount() 回傳虛擬時間，不跟隨真實時間
+// - delayMs()/advanceTo() 直接跳到下一個排程事件或期限，不會真的睡眠
+// 用於在 Linux 主機上以遠快於真實時間的速度模擬長時間的充電、軟啟動與故障情境
+class VirtualClockHAL final : public IHardwareHAL {
+public:
+    typedef std::function<void()> Action;
+    typedef std::function<void(const HalCanFrame&)> CanTxHandler;
+
+    VirtualClockHAL();
+
+    void init() override;
+    void getBootTimes(HalBootTimes& out) override;
+
+    // System
+    uint32_t getTickCount() override { return (uint32_t)_now; }
+    void delayMs(uint32_t ms) override;
+    // 依序執行排程事件，直到注入 CAN / UART 換行 / 按鍵變化或到達 deadline
+    uint32_t waitEvents(uint32_t deadline) override;
+
+    // GPIO
+    bool readButton(HalButton btn) override;
+
+    // CAN Bus
+    bool canSend(const HalCanFrame& frame) override;
+    bool canReceive(HalCanFrame& frame) override;
+    void canGetStats(HalCanStats& out) override;
+    bool canRecover() override;
+
+    // UART (Serial)
+    void uartSend(const char* str) override;
+    int uartRead() override;
+    int uartAvailable() override;
+
+    // Storage: 記憶體 key/value，設定 storagePath 後 commit 時寫入檔案
+    bool storageRead(const char* key, void* buf, size_t len) override;
+    bool storageWrite(const char* key, const void* buf, size_t len) override;
+    bool storageCommit() override;
+
+    // Display: 只記錄繪製的字串，方便模擬程式檢查畫面內容
+    void displayClear() override;
+    void displayDrawString(int x, int y, const char* str, int fontSize) override;
+    void displayShow() override;
+    // 與 ESP32 相同的兩個等寬字型 (6x10、profont17) 的尺寸
+    int displayTextWidth(const char* str, int fontSize) override;
+    void displayFontMetrics(int fontSize, HalFontMetrics& out) override;
+
+    // --- Simulation Control ---
+
+    // 在虛擬時間 at (ms) 執行 fn；同一時間點的事件依排程順序執行
+    void schedule(uint64_t at, Action fn);
+    void scheduleIn(uint32_t delay, Action fn) { schedule(_now + delay, fn); }
+
+    // 前進到 deadline 或下一個排程事件 (取較早者)，並執行所有到期事件
+    // 回傳 false 表示時間沒有前進 (deadline 已過且沒有到期事件)
+    bool advanceTo(uint32_t deadline);
+    // 前進到絕對時間 (64-bit)，途中依序執行所有事件
+    void runUntil(uint64_t at);
+
+    uint64_t now() const { return _now; }
+    bool hasPendingEvents() const { return !_events.empty(); }
+    uint64_t nextEventTime() const;
+
+    void setButton(HalButton btn, bool pressed);
+    void injectCan(const HalCanFrame& frame);
+    void injectUart(const char* str);
+
+    // 模擬匯流排故障: 進入 bus-off (TEC=256)，之後送出失敗、收不到訊框，直到 canRecover() 完成
+    void setCanBusOff();
+
+    // canSend() 送出的訊框交給模擬的 PSU 模組處理
+    void setCanTxHandler(CanTxHandler handler) { _canTx = handler; }
+
+    // 載入既有的儲存檔 (不存在則從空白開始)
+    bool setStoragePath(const std::string& path);
+    uint32_t storageCommitCount() const { return _storageCommits; }
+
+    std::string takeUartOutput();
+    const std::vector<std::string>& displayLines() const { return _shownLines; }
+
+    uint32_t canTxCount() const { return _canTxCount; }
+    uint32_t canRxCount() const { return _canRxCount; }
+    uint32_t wakeCount() const { return _wakes; }
+
+private:
+    struct Event {
+        uint64_t at;
+        uint64_t seq;
+        Action fn;
+    };
+    struct EventLater {
+        bool operator()(const Event& a, const Event& b) const {
+            return (a.at != b.at) ? (a.at > b.at) : (a.seq > b.seq);
+        }
+    };
+
+    uint64_t _now;
+    uint64_t _seq;
+    std::priority_queue<Event, std::vector<Event>, EventLater> _events;
+
+    uint32_t _halEvents; // 尚未被 waitEvents() 取走的 HalEvent
+    uint32_t _wakes;
+    bool _buttons[3];
+    std::deque<HalCanFrame> _canRx;
+    std::deque<char> _uartRx;
+    std::string _uartTx;
+    CanTxHandler _canTx;
+    uint32_t _canTxCount;
+    uint32_t _canRxCount;
+    HalCanStats _canStats;
+
+    typedef std::map<std::string, std::vector<uint8_t> > Blobs;
+    Blobs _storage;   // 已 commit
+    Blobs _pending;   // storageWrite() 之後尚未 commit
+    std::string _storagePath;
+    uint32_t _storageCommits;
+
+    std::vector<std::string> _drawLines;
+    std::vector<std::string> _shownLines;
+
+    void runDueEvents();
+};
+
+#endif // VIRTUAL_CLOCK_HAL_H
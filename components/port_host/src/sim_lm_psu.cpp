@@ -0,0 +1,90 @@
+#include "sim_lm_psu.h"
+
+#include <string.h>
+
+SimLmPsu::SimLmPsu(VirtualClockHAL* hal, uint8_t addr)
+    : _hal(hal), _addr(addr), _respDelay(2), _startDelay(0), _runningAt(0),
+      _running(false), _fault(false), _offline(false),
+      _setV(0.0f), _setI(0.0f), _loadOhms(0.0f), _loadEmf(0.0f),
+      _inputVoltage(220.0f) {}
+
+float SimLmPsu::outputCurrent() const {
+    if (!isRunning() || _loadOhms <= 0.0f) return 0.0f;
+    float i = (_setV - _loadEmf) / _loadOhms;
+    if (i < 0.0f) i = 0.0f;
+    return (i > _setI) ? _setI : i; // CC 模式
+}
+
+float SimLmPsu::outputVoltage() const {
+    if (!isRunning()) return 0.0f;
+    if (_loadOhms <= 0.0f) return _setV;
+    return _loadEmf + outputCurrent() * _loadOhms;
+}
+
+bool SimLmPsu::handleFrame(const HalCanFrame& frame) {
+    if (_offline) return false;
+
+    if (frame.id == ID_CMD + _addr) {
+        HalCanFrame resp;
+        memset(&resp, 0, sizeof(resp));
+        resp.id = ID_RESP + _addr;
+        resp.len = 8;
+        resp.ext = true;
+
+        switch (frame.data[0]) {
+            case 0x00: { // Set V/I
+                uint32_t iVal = ((uint32_t)frame.data[1] << 16) | (frame.data[2] << 8) | frame.data[3];
+                uint32_t vVal = ((uint32_t)frame.data[4] << 24) | ((uint32_t)frame.data[5] << 16) |
+                                (frame.data[6] << 8) | frame.data[7];
+                _setI = iVal / 1000.0f;
+                _setV = vVal / 1000.0f;
+                return true;
+            }
+            case 0x01: { // Status query
+                uint16_t rawI = (uint16_t)(outputCurrent() * 10.0f + 0.5f);
+                uint16_t rawV = (uint16_t)(outputVoltage() * 10.0f + 0.5f);
+                resp.data[0] = 0x01;
+                resp.data[2] = rawI >> 8;
+                resp.data[3] = rawI & 0xFF;
+                resp.data[4] = rawV >> 8;
+                resp.data[5] = rawV & 0xFF;
+                resp.data[7] = isRunning() ? 0x00 : 0x01;
+                reply(resp);
+                return true;
+            }
+            case 0x02: { // Power on/off
+                if (frame.data[7] == 0x55) {
+                    if (!_running) _runningAt = _hal->now() + _startDelay;
+                    _running = true;
+                }
+                else if (frame.data[7] == 0xAA) _running = false;
+                resp.data[0] = 0x02;
+                resp.data[1] = 0x01;
+                reply(resp);
+                return true;
+            }
+            default:
+                return true;
+        }
+    }
+
+    if (frame.id == ID_CMD_IN + _addr && frame.data[0] == 0x31) {
+        HalCanFrame resp;
+        memset(&resp, 0, sizeof(resp));
+        resp.id = ID_RESP_IN + _addr;
+        resp.len = 8;
+        resp.ext = true;
+        uint16_t raw = (uint16_t)(_inputVoltage * 32.0f);
+        resp.data[0] = 0x31;
+        resp.data[2] = raw >> 8;
+        resp.data[3] = raw & 0xFF;
+        reply(resp);
+        return true;
+    }
+    return false;
+}
+
+void SimLmPsu::reply(const HalCanFrame& frame) {
+    VirtualClockHAL* hal = _hal;
+    hal->scheduleIn(_respDelay, [hal, frame]() { hal->injectCan(frame); });
+}
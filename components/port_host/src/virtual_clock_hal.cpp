@@ -0,0 +1,267 @@
+#include "virtual_clock_hal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+VirtualClockHAL::VirtualClockHAL()
+    : _now(0), _seq(0), _halEvents(0), _wakes(0), _canTxCount(0), _canRxCount(0), _storageCommits(0) {
+    memset(_buttons, 0, sizeof(_buttons));
+    memset(&_canStats, 0, sizeof(_canStats));
+    _canStats.state = HAL_CAN_RUNNING;
+    _canStats.bitrate = 125000;
+}
+
+void VirtualClockHAL::init() {
+    // 虛擬硬體不需要初始化
+}
+
+void VirtualClockHAL::getBootTimes(HalBootTimes& out) {
+    memset(&out, 0, sizeof(out));
+}
+
+// --- System ---
+
+void VirtualClockHAL::delayMs(uint32_t ms) {
+    runUntil(_now + ms);
+}
+
+void VirtualClockHAL::schedule(uint64_t at, Action fn) {
+    if (at < _now) at = _now;
+    Event ev;
+    ev.at = at;
+    ev.seq = _seq++;
+    ev.fn = fn;
+    _events.push(ev);
+}
+
+uint64_t VirtualClockHAL::nextEventTime() const {
+    return _events.empty() ? UINT64_MAX : _events.top().at;
+}
+
+void VirtualClockHAL::runDueEvents() {
+    while (!_events.empty() && _events.top().at <= _now) {
+        // 先複製再 pop，事件本身可能會再排程新事件
+        Action fn = _events.top().fn;
+        _events.pop();
+        fn();
+    }
+}
+
+void VirtualClockHAL::runUntil(uint64_t at) {
+    while (!_events.empty() && _events.top().at <= at) {
+        _now = _events.top().at;
+        runDueEvents();
+    }
+    if (at > _now) _now = at;
+}
+
+uint32_t VirtualClockHAL::waitEvents(uint32_t deadline) {
+    // 與 ESP32 的 task notification 相同語意: 事件在等待前已發生則立即回傳
+    while (_halEvents == 0 && halTickBefore((uint32_t)_now, deadline)) {
+        advanceTo(deadline);
+    }
+    uint32_t evt = _halEvents;
+    _halEvents = 0;
+    _wakes++;
+    return evt;
+}
+
+bool VirtualClockHAL::advanceTo(uint32_t deadline) {
+    // 32-bit 期限轉換成 64-bit 虛擬時間 (期限最多在 2^31 ms 之後)
+    int32_t delta = (int32_t)(deadline - (uint32_t)_now);
+    uint64_t target = (delta > 0) ? _now + (uint32_t)delta : _now;
+
+    uint64_t next = nextEventTime();
+    if (next < target) target = next;
+
+    bool moved = target > _now;
+    _now = target;
+    runDueEvents();
+    return moved;
+}
+
+// --- GPIO ---
+
+bool VirtualClockHAL::readButton(HalButton btn) {
+    if ((int)btn < 0 || (int)btn >= 3) return false;
+    return _buttons[btn];
+}
+
+void VirtualClockHAL::setButton(HalButton btn, bool pressed) {
+    if ((int)btn < 0 || (int)btn >= 3) return;
+    if (_buttons[btn] != pressed) _halEvents |= HAL_EVT_BUTTON;
+    _buttons[btn] = pressed;
+}
+
+// --- CAN ---
+
+bool VirtualClockHAL::canSend(const HalCanFrame& frame) {
+    if (_canStats.state != HAL_CAN_RUNNING) {
+        _canStats.txFailed++;
+        return false;
+    }
+    _canTxCount++;
+    _canStats.txFrames++;
+    _canStats.txBytes += frame.len;
+    if (_canTx) _canTx(frame);
+    return true;
+}
+
+bool VirtualClockHAL::canReceive(HalCanFrame& frame) {
+    if (_canRx.empty()) return false;
+    frame = _canRx.front();
+    _canRx.pop_front();
+    _canStats.rxFrames++;
+    _canStats.rxBytes += frame.len;
+    return true;
+}
+
+void VirtualClockHAL::injectCan(const HalCanFrame& frame) {
+    if (_canStats.state != HAL_CAN_RUNNING) return; // bus-off 時收不到任何訊框
+    _canRxCount++;
+    _canRx.push_back(frame);
+    _canRx.back().timestampUs = (uint32_t)(_now * 1000);
+    _halEvents |= HAL_EVT_CAN;
+    if (_canRx.size() > _canStats.rxQueueHigh) _canStats.rxQueueHigh = (uint16_t)_canRx.size();
+}
+
+void VirtualClockHAL::canGetStats(HalCanStats& out) {
+    _canStats.rxQueueLen = (uint16_t)_canRx.size();
+    out = _canStats;
+}
+
+bool VirtualClockHAL::canRecover() {
+    if (_canStats.state != HAL_CAN_BUS_OFF) return false;
+    _canStats.state = HAL_CAN_RECOVERING;
+    // 128 x 11 個隱性位元 @125 kbit/s ≈ 11.3 ms
+    scheduleIn(12, [this]() {
+        _canStats.state = HAL_CAN_RUNNING;
+        _canStats.txErrorCounter = 0;
+        _canStats.rxErrorCounter = 0;
+        _halEvents |= HAL_EVT_CAN;
+    });
+    return true;
+}
+
+void VirtualClockHAL::setCanBusOff() {
+    if (_canStats.state == HAL_CAN_BUS_OFF) return;
+    _canStats.state = HAL_CAN_BUS_OFF;
+    _canStats.txErrorCounter = 256;
+    _canStats.busOffCount++;
+    _canRx.clear();
+    _halEvents |= HAL_EVT_CAN;
+}
+
+// --- UART ---
+
+void VirtualClockHAL::uartSend(const char* str) {
+    _uartTx.append(str);
+}
+
+int VirtualClockHAL::uartRead() {
+    if (_uartRx.empty()) return -1;
+    int c = (uint8_t)_uartRx.front();
+    _uartRx.pop_front();
+    return c;
+}
+
+int VirtualClockHAL::uartAvailable() {
+    return (int)_uartRx.size();
+}
+
+void VirtualClockHAL::injectUart(const char* str) {
+    while (*str) {
+        if (*str == '\n') _halEvents |= HAL_EVT_UART; // 與 ESP32 的換行 pattern 中斷一致
+        _uartRx.push_back(*str++);
+    }
+}
+
+std::string VirtualClockHAL::takeUartOutput() {
+    std::string out;
+    out.swap(_uartTx);
+    return out;
+}
+
+// --- Storage ---
+// 檔案格式: 每行 "key hexbytes"
+
+bool VirtualClockHAL::storageRead(const char* key, void* buf, size_t len) {
+    Blobs::const_iterator it = _storage.find(key);
+    if (it == _storage.end() || it->second.size() != len) return false;
+    memcpy(buf, it->second.data(), len);
+    return true;
+}
+
+bool VirtualClockHAL::storageWrite(const char* key, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*)buf;
+    _pending[key].assign(p, p + len);
+    return true;
+}
+
+bool VirtualClockHAL::storageCommit() {
+    for (Blobs::const_iterator it = _pending.begin(); it != _pending.end(); ++it) {
+        _storage[it->first] = it->second;
+    }
+    _pending.clear();
+    _storageCommits++;
+
+    if (_storagePath.empty()) return true;
+    FILE* f = fopen(_storagePath.c_str(), "w");
+    if (!f) return false;
+    for (Blobs::const_iterator it = _storage.begin(); it != _storage.end(); ++it) {
+        fprintf(f, "%s ", it->first.c_str());
+        for (size_t i = 0; i < it->second.size(); i++) fprintf(f, "%02x", it->second[i]);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return true;
+}
+
+bool VirtualClockHAL::setStoragePath(const std::string& path) {
+    _storagePath = path;
+    _storage.clear();
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+
+    char key[32];
+    char hex[512];
+    while (fscanf(f, "%31s %511s", key, hex) == 2) {
+        std::vector<uint8_t>& blob = _storage[key];
+        for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+            unsigned int b;
+            if (sscanf(&hex[i], "%2x", &b) != 1) break;
+            blob.push_back((uint8_t)b);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+// --- Display ---
+
+void VirtualClockHAL::displayClear() {
+    _drawLines.clear();
+}
+
+void VirtualClockHAL::displayDrawString(int x, int y, const char* str, int fontSize) {
+    (void)x; (void)y; (void)fontSize;
+    _drawLines.push_back(str);
+}
+
+void VirtualClockHAL::displayShow() {
+    _shownLines = _drawLines;
+}
+
+static const HalFontMetrics HOST_FONTS[HAL_FONT_COUNT] = {
+    { 7, -2, 6, 10 },   // 6x10
+    { 11, -3, 9, 17 },  // profont17
+};
+
+int VirtualClockHAL::displayTextWidth(const char* str, int fontSize) {
+    const HalFontMetrics& f = HOST_FONTS[fontSize == HAL_FONT_LARGE ? HAL_FONT_LARGE : HAL_FONT_SMALL];
+    return (int)strlen(str) * f.maxWidth;
+}
+
+void VirtualClockHAL::displayFontMetrics(int fontSize, HalFontMetrics& out) {
+    out = HOST_FONTS[fontSize == HAL_FONT_LARGE ? HAL_FONT_LARGE : HAL_FONT_SMALL];
+}
@@ -159,6 +159,83 @@
 #endif
 
 
+/*
+  The following macro enables an optional RAM index for the glyph lookup.
+  Without an index, every glyph is found by walking the glyph list of the font
+  (starting at 'A' or 'a' for 8 bit encodings, after a jump table for unicode).
+  With U8G2_WITH_GLYPH_INDEX defined, a u8g2_glyph_index_t can be assigned with
+  u8g2_SetGlyphIndex(). The index is (re)built on the first glyph lookup after
+  the font has changed and provides a direct lookup table for the encodings 0..255
+  and a binary search for unicode glyphs.
+  The index itself requires about 520 bytes RAM plus 8 bytes per unicode glyph,
+  all provided by the caller. If no index is assigned, the behavior is unchanged.
+*/
+#ifndef U8G2_WITHOUT_GLYPH_INDEX
+#define U8G2_WITH_GLYPH_INDEX
+#endif
+
+
+/*
+  The font decoder reads the compressed glyph data bit by bit. With
+  U8G2_WITH_FONT_WORD_READER, the decoder keeps a 32 bit buffer, which is
+  refilled with four byte loads instead of one byte per field.
+  This is not faster: on x86-64 (gcc -O2, sys/bitmap/font_reader) the decode
+  time per glyph is between 5% lower and 13% higher than with the byte reader
+  and complete frames are 3-6% slower, so it is disabled by default.
+  Requires fonts in byte addressable memory, it is ignored for AVR (PROGMEM)
+  and ESP8266 (flash access with 32 bit alignment).
+*/
+//#define U8G2_WITH_FONT_WORD_READER
+#if defined(U8G2_WITH_FONT_WORD_READER) && (defined(__AVR__) || defined(ESP8266))
+#undef U8G2_WITH_FONT_WORD_READER
+#endif
+
+
+/*
+  The following macro enables an optional cache for decoded glyphs.
+  Glyphs are stored as uncompressed bitmaps in the vertical_top_lsb layout
+  (the tile layout of SSD1306 and most other monochrome controllers) and
+  copied into the buffer with byte operations, skipping the RLE decoder.
+  The cache memory is provided by the caller via u8g2_InitGlyphCache();
+  least recently used glyphs are replaced.
+  The cache is only used for U8G2_R0 (and U8G2_R1_TRANSPOSE/U8G2_R3_TRANSPOSE), 
+  font direction 0 and displays with the vertical_top_lsb buffer, otherwise glyphs 
+  are decoded as usual.
+*/
+#ifndef U8G2_WITHOUT_GLYPH_CACHE
+#define U8G2_WITH_GLYPH_CACHE
+#endif
+
+
+/*
+  With U8G2_WITH_BITMAP_BLIT, u8g2_DrawXBM(), u8g2_DrawXBMP() and u8g2_DrawBitmap()
+  write directly into the vertical_top_lsb buffer: 8 bitmap rows are transposed
+  into 8 tile bytes, instead of drawing one hvline per pixel run.
+  This is only used for U8G2_R0 (and U8G2_R1_TRANSPOSE/U8G2_R3_TRANSPOSE), 
+  other setups use the hvline procedure.
+*/
+#ifndef U8G2_WITHOUT_BITMAP_BLIT
+#define U8G2_WITH_BITMAP_BLIT
+#endif
+
+/*
+  U8G2_WITH_ROTATION_TRANSPOSE adds the rotations U8G2_R1_TRANSPOSE and U8G2_R3_TRANSPOSE.
+  They show the same picture as U8G2_R1 and U8G2_R3, but all drawing happens in an
+  unrotated buffer (same as U8G2_R0), so horizontal lines, glyphs and bitmaps use the
+  fast R0 procedures. The tiles are rotated with a 8x8 bit transpose while the buffer is
+  sent to the display.
+  This pays off for text with the glyph cache assigned (sys/bitmap/rotation_transpose,
+  x86-64: status screen 19-28 us -> 4-6 us per frame). Screens with only boxes and
+  lines are not faster, the transpose while sending adds about 1-3 us per frame.
+  Requires full buffer mode (u8g2_Setup_..._f) and the vertical_top_lsb buffer, 
+  otherwise U8G2_R1/U8G2_R3 is used instead (u8g2->cb is replaced).
+  Adds one byte to the u8g2 structure.
+*/
+#ifndef U8G2_WITHOUT_ROTATION_TRANSPOSE
+#define U8G2_WITH_ROTATION_TRANSPOSE
+#endif
+
+
 /*
   See issue https://github.com/olikraus/u8g2/issues/1561
   The old behaviour of the StrWidth and UTF8Width functions returned an unbalanced string width, where
@@ -266,6 +343,47 @@ struct _u8g2_font_info_t
 };
 typedef struct _u8g2_font_info_t u8g2_font_info_t;
 
+#ifdef U8G2_WITH_GLYPH_INDEX
+struct _u8g2_glyph_index_entry_t
+{
+  uint16_t encoding;
+  uint32_t offset;		/* glyph data, relative to the start of the font */
+};
+typedef struct _u8g2_glyph_index_entry_t u8g2_glyph_index_entry_t;
+
+#define U8G2_GLYPH_INDEX_INCOMPLETE 0x0ffff
+
+struct _u8g2_glyph_index_t
+{
+  const uint8_t *font;		/* font for which the index was built, NULL if not built */
+  uint16_t ascii[256];		/* glyph data offset for encodings 0..255, 0 if not in the font */
+  uint8_t is_ascii_valid;		/* 0 if an offset did not fit into 16 bit */
+#ifdef U8G2_WITH_UNICODE
+  u8g2_glyph_index_entry_t *unicode;	/* caller provided, sorted by encoding, can be NULL */
+  uint16_t unicode_capacity;
+  uint16_t unicode_cnt;		/* U8G2_GLYPH_INDEX_INCOMPLETE if the glyphs did not fit */
+#endif
+};
+typedef struct _u8g2_glyph_index_t u8g2_glyph_index_t;
+#endif /* U8G2_WITH_GLYPH_INDEX */
+
+#ifdef U8G2_WITH_GLYPH_CACHE
+struct _u8g2_glyph_cache_t
+{
+  uint8_t *slots;		/* slot_cnt * slot_size bytes, part of the arena */
+  uint8_t *hash;		/* hash_mask+1 chain heads, part of the arena */
+  uint16_t slot_size;		/* header and bitmap */
+  uint16_t max_bitmap_bytes;
+  uint8_t slot_cnt;
+  uint8_t hash_mask;
+  uint8_t mru;			/* most recently used slot */
+  uint8_t lru;			/* least recently used slot, replaced next */
+  uint32_t hits;
+  uint32_t misses;
+};
+typedef struct _u8g2_glyph_cache_t u8g2_glyph_cache_t;
+#endif /* U8G2_WITH_GLYPH_CACHE */
+
 /* from ucglib... */
 struct _u8g2_font_decode_t
 {
@@ -279,7 +397,13 @@ struct _u8g2_font_decode_t
   int8_t glyph_width;	
   int8_t glyph_height;
 
+#ifdef U8G2_WITH_FONT_WORD_READER
+  const uint8_t *decode_end;		/* word loads are allowed up to this address */
+  uint32_t decode_bits;			/* not yet used bits, next bit is the lsb */
+  uint8_t decode_bit_pos;			/* number of bits in decode_bits */
+#else
   uint8_t decode_bit_pos;			/* bitpos inside a byte of the compressed data */
+#endif
   uint8_t is_transparent;
   uint8_t fg_color;
   uint8_t bg_color;
@@ -321,6 +445,9 @@ struct u8g2_struct
   uint8_t *tile_buf_ptr;	/* ptr to memory area with u8x8.display_info->tile_width * 8 * tile_buf_height bytes */
   uint8_t tile_buf_height;	/* height of the tile memory area in tile rows */
   uint8_t tile_curr_row;	/* current row for picture loop */
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+  uint8_t tile_buf_width;	/* tiles per buffer row: display tile_width, display tile_height for the transpose rotations */
+#endif
   
   /* dimension of the buffer in pixel */
   u8g2_uint_t pixel_buf_width;		/* equal to tile_buf_width*8 */
@@ -363,6 +490,12 @@ struct u8g2_struct
   u8g2_font_calc_vref_fnptr font_calc_vref;
   u8g2_font_decode_t font_decode;		/* new font decode structure */
   u8g2_font_info_t font_info;			/* new font info structure */
+#ifdef U8G2_WITH_GLYPH_INDEX
+  u8g2_glyph_index_t *glyph_index;		/* can be NULL */
+#endif
+#ifdef U8G2_WITH_GLYPH_CACHE
+  u8g2_glyph_cache_t *glyph_cache;		/* can be NULL */
+#endif
 
 #ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
   /* 1 of there is an intersection between user_?? and clip_?? box */
@@ -407,6 +540,10 @@ struct u8g2_struct
 #define u8g2_SetPowerSave(u8g2, is_enable) u8x8_SetPowerSave(u8g2_GetU8x8(u8g2), (is_enable))
 #define u8g2_SetFlipMode(u8g2, mode) u8x8_SetFlipMode(u8g2_GetU8x8(u8g2), (mode))
 #define u8g2_SetContrast(u8g2, value) u8x8_SetContrast(u8g2_GetU8x8(u8g2), (value))
+#ifdef U8X8_WITH_SHADOW_RAM
+#define u8g2_SetShadowRAM(u8g2, buf) u8x8_SetShadowRAM(u8g2_GetU8x8(u8g2), (buf))
+#define u8g2_InvalidateShadowRAM(u8g2) u8x8_InvalidateShadowRAM(u8g2_GetU8x8(u8g2))
+#endif
 //#define u8g2_ClearDisplay(u8g2) u8x8_ClearDisplay(u8g2_GetU8x8(u8g2))  obsolete, can not be used in all cases
 void u8g2_ClearDisplay(u8g2_t *u8g2);
 
@@ -437,6 +574,10 @@ extern const u8g2_cb_t u8g2_cb_r2;
 extern const u8g2_cb_t u8g2_cb_r3;
 extern const u8g2_cb_t u8g2_cb_mirror;
 extern const u8g2_cb_t u8g2_cb_mirror_vertical;
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+extern const u8g2_cb_t u8g2_cb_r1_transpose;
+extern const u8g2_cb_t u8g2_cb_r3_transpose;
+#endif
 
 #define U8G2_R0	(&u8g2_cb_r0)
 #define U8G2_R1	(&u8g2_cb_r1)
@@ -444,6 +585,10 @@ extern const u8g2_cb_t u8g2_cb_mirror_vertical;
 #define U8G2_R3	(&u8g2_cb_r3)
 #define U8G2_MIRROR	(&u8g2_cb_mirror)
 #define U8G2_MIRROR_VERTICAL	(&u8g2_cb_mirror_vertical)
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+#define U8G2_R1_TRANSPOSE	(&u8g2_cb_r1_transpose)
+#define U8G2_R3_TRANSPOSE	(&u8g2_cb_r3_transpose)
+#endif
 /*
   u8g2:			A new, not yet initialized u8g2 memory area
   buf:			Memory area of size tile_buf_height*<width of the display in pixel>
@@ -451,7 +596,7 @@ extern const u8g2_cb_t u8g2_cb_mirror_vertical;
   ll_hvline_cb:		one of:
     u8g2_ll_hvline_vertical_top_lsb
     u8g2_ll_hvline_horizontal_right_lsb
-  u8g2_cb			U8G2_R0 .. U8G2_R3
+  u8g2_cb			U8G2_R0 .. U8G2_R3 (or U8G2_R1_TRANSPOSE, U8G2_R3_TRANSPOSE)
       
 */
 
@@ -1939,6 +2084,26 @@ size_t u8g2_GetFontSize(const uint8_t *font_arg);
 #define U8G2_FONT_HEIGHT_MODE_ALL 2
 
 void u8g2_SetFont(u8g2_t *u8g2, const uint8_t  *font);
+/* parse the font header once and keep the result, then switch fonts with u8g2_SetFontWithInfo() */
+void u8g2_read_font_info(u8g2_font_info_t *font_info, const uint8_t *font);
+void u8g2_SetFontWithInfo(u8g2_t *u8g2, const uint8_t *font, const u8g2_font_info_t *font_info);
+#ifdef U8G2_WITH_GLYPH_INDEX
+/* unicode may be NULL (unicode_capacity = 0), then unicode glyphs are searched without index */
+void u8g2_InitGlyphIndex(u8g2_glyph_index_t *glyph_index, u8g2_glyph_index_entry_t *unicode, uint16_t unicode_capacity);
+void u8g2_BuildGlyphIndex(u8g2_glyph_index_t *glyph_index, const uint8_t *font);
+/* the index is rebuilt for the current font if required, NULL removes the index */
+#define u8g2_SetGlyphIndex(u8g2, idx) ((u8g2)->glyph_index = (idx))
+#endif
+#ifdef U8G2_WITH_GLYPH_CACHE
+/* 
+  max_bitmap_bytes: glyph width * ((glyph height+7)/8) of the largest glyph to be cached 
+  returns the number of glyphs, which fit into the arena (max 254)
+*/
+uint8_t u8g2_InitGlyphCache(u8g2_glyph_cache_t *cache, void *arena, size_t arena_size, uint16_t max_bitmap_bytes);
+void u8g2_ClearGlyphCache(u8g2_glyph_cache_t *cache);
+/* cache can be shared by several fonts, NULL disables the cache */
+#define u8g2_SetGlyphCache(u8g2, cache) ((u8g2)->glyph_cache = (cache))
+#endif
 void u8g2_SetFontMode(u8g2_t *u8g2, uint8_t is_transparent);
 
 uint8_t u8g2_IsGlyph(u8g2_t *u8g2, uint16_t requested_encoding);
@@ -40,6 +40,117 @@ void u8g2_SetBitmapMode(u8g2_t *u8g2, uint8_t is_transparent) {
   u8g2->bitmap_transparency = is_transparent;
 }
 
+#ifdef U8G2_WITH_BITMAP_BLIT
+
+/*
+  Draw a bitmap directly into a vertical_top_lsb buffer.
+  is_xbm: 1 for XBM (lsb is the left pixel), 0 for u8glib bitmaps (msb is the left pixel)
+  is_pgm: 1 if the bitmap must be read with u8x8_pgm_read()
+  Return:
+    0 if the buffer is not supported, the bitmap must be drawn by the caller
+    1 if the bitmap has been handled
+*/
+static uint8_t u8g2_blit_bitmap(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t w, u8g2_uint_t h, const uint8_t *bitmap, uint8_t is_xbm, uint8_t is_pgm)
+{
+  u8g2_uint_t x1 = x0 + w;
+  u8g2_uint_t y1 = y0 + h;
+  u8g2_uint_t cx0, cx1, cy0, cy1;
+  uint16_t blen, row, row_end, page, page_end, col, col_end;
+  int32_t start;
+  const uint8_t *src[8];
+  uint8_t rows[8];
+  uint8_t cols[8];
+  uint8_t *ptr;
+  uint8_t page_mask, fg, bg, c, q;
+  uint8_t color = u8g2->draw_color;
+  
+  if ( u8g2->cb->draw_l90 != u8g2_draw_l90_r0 || u8g2->ll_hvline != u8g2_ll_hvline_vertical_top_lsb )
+    return 0;
+  /* bitmaps, which wrap around the coordinate range, are handled by the clipping of the regular path */
+  if ( x1 < x0 || y1 < y0 )
+    return 0;
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if ( u8g2->is_page_clip_window_intersection == 0 )
+    return 1;
+#endif
+  
+  cx0 = x0 < u8g2->user_x0 ? u8g2->user_x0 : x0;
+  cx1 = x1 > u8g2->user_x1 ? u8g2->user_x1 : x1;
+  cy0 = y0 < u8g2->user_y0 ? u8g2->user_y0 : y0;
+  cy1 = y1 > u8g2->user_y1 ? u8g2->user_y1 : y1;
+  if ( cx0 >= cx1 || cy0 >= cy1 )
+    return 1;
+  
+  blen = w;
+  blen += 7;
+  blen >>= 3;
+  
+  /* rows in buffer coordinates, columns relative to the bitmap */
+  row = cy0 - u8g2->pixel_curr_row;
+  row_end = cy1 - u8g2->pixel_curr_row;
+  col_end = cx1 - x0;
+  page_end = (row_end + 7) >> 3;
+  for( page = row >> 3; page < page_end; page++ )
+  {
+    page_mask = 0xff;
+    if ( (page << 3) < row )
+      page_mask <<= row & 7;
+    if ( (page << 3) + 8 > row_end )
+      page_mask &= 0xff >> (8 - (row_end & 7));
+    
+    /* bitmap row for bit 0 of the tile bytes, might be negative */
+    start = (int32_t)(page << 3) + u8g2->pixel_curr_row - (int32_t)y0;
+    for( q = 0; q < 8; q++ )
+    {
+      src[q] = NULL;
+      if ( page_mask & (1<<q) )
+	src[q] = bitmap + (uint32_t)(start + q) * blen;
+      rows[q] = 0;
+    }
+    
+    ptr = u8g2->tile_buf_ptr + page * u8g2->pixel_buf_width + cx0;
+    col = cx0 - x0;
+    while( col < col_end )
+    {
+      /* transpose the 8 bitmap bytes of the current column block */
+      for( q = 0; q < 8; q++ )
+      {
+	if ( src[q] != NULL )
+	  rows[q] = is_pgm ? u8x8_pgm_read(src[q] + (col >> 3)) : src[q][col >> 3];
+      }
+      u8x8_transpose_8x8(rows, cols);
+      
+      do
+      {
+	c = col & 7;
+	if ( is_xbm == 0 )
+	  c = 7 - c;
+	fg = cols[c] & page_mask;
+	if ( u8g2->bitmap_transparency == 0 )
+	{
+	  /* clear pixels are drawn with color 1 for draw color 0, otherwise with color 0 */
+	  bg = ~fg & page_mask;
+	  if ( color == 0 )
+	    *ptr |= bg;
+	  else
+	    *ptr &= ~bg;
+	}
+	if ( color == 0 )
+	  *ptr &= ~fg;
+	else if ( color == 1 )
+	  *ptr |= fg;
+	else
+	  *ptr ^= fg;
+	ptr++;
+	col++;
+      } while( col < col_end && (col & 7) != 0 );
+    }
+  }
+  return 1;
+}
+
+#endif /* U8G2_WITH_BITMAP_BLIT */
+
 /*
   x,y 	Position on the display
   len		Length of bitmap line in pixel. Note: This differs from u8glib which had a bytecount here.
@@ -92,6 +203,10 @@ void u8g2_DrawBitmap(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t cnt
   if ( u8g2_IsIntersection(u8g2, x, y, x+w, y+h) == 0 ) 
     return;
 #endif /* U8G2_WITH_INTERSECTION */
+#ifdef U8G2_WITH_BITMAP_BLIT
+  if ( u8g2_blit_bitmap(u8g2, x, y, w, h, bitmap, 0, 0) )
+    return;
+#endif /* U8G2_WITH_BITMAP_BLIT */
   
   while( h > 0 )
   {
@@ -174,6 +289,10 @@ void u8g2_DrawXBM(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g
   if ( u8g2_IsIntersection(u8g2, x, y, x+w, y+h) == 0 ) 
     return;
 #endif /* U8G2_WITH_INTERSECTION */
+#ifdef U8G2_WITH_BITMAP_BLIT
+  if ( u8g2_blit_bitmap(u8g2, x, y, w, h, bitmap, 1, 0) )
+    return;
+#endif /* U8G2_WITH_BITMAP_BLIT */
   
   while( h > 0 )
   {
@@ -262,6 +381,10 @@ void u8g2_DrawXBMP(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8
   if ( u8g2_IsIntersection(u8g2, x, y, x+w, y+h) == 0 ) 
     return;
 #endif /* U8G2_WITH_INTERSECTION */
+#ifdef U8G2_WITH_BITMAP_BLIT
+  if ( u8g2_blit_bitmap(u8g2, x, y, w, h, bitmap, 1, 1) )
+    return;
+#endif /* U8G2_WITH_BITMAP_BLIT */
   
   while( h > 0 )
   {
@@ -48,45 +48,93 @@ void u8g2_ClearBuffer(u8g2_t *u8g2)
 
 /*============================================*/
 
-static void u8g2_send_tile_row(u8g2_t *u8g2, uint8_t src_tile_row, uint8_t dest_tile_row)
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+/*
+  Send the display tiles tx..tx+tw-1, ty..ty+th-1 from the unrotated buffer 
+  of U8G2_R1_TRANSPOSE or U8G2_R3_TRANSPOSE. Tile positions are display positions.
+  For U8G2_R1 the display tile (x,y) is the transposed buffer tile (y, tile_width-1-x) 
+  in reverse byte order, for U8G2_R3 it is the buffer tile (tile_height-1-y, x) 
+  transposed in reverse byte order.
+  The tiles are collected in a small local buffer (16 tiles) for u8x8_DrawTile().
+*/
+static void u8g2_send_transpose(u8g2_t *u8g2, uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th)
 {
-  uint8_t *ptr;
-  uint16_t offset;
-  uint8_t w;
+  uint8_t row[16*8];
+  uint8_t tmp[8];
+  uint8_t *src;
+  uint8_t *dest;
+  uint16_t stride = u8g2->pixel_buf_width;	/* bytes per buffer tile row */
+  uint8_t tile_width = u8g2_GetU8x8(u8g2)->display_info->tile_width;
+  uint8_t tile_height = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  uint8_t x, c, n, i, k;
   
-  w = u8g2_GetU8x8(u8g2)->display_info->tile_width;
-  offset = src_tile_row;
-  ptr = u8g2->tile_buf_ptr;
-  offset *= w;
-  offset *= 8;
-  ptr += offset;
-  u8x8_DrawTile(u8g2_GetU8x8(u8g2), 0, dest_tile_row, w, ptr);
+  while( th > 0 )
+  {
+    x = tx;
+    c = tw;
+    while( c > 0 )
+    {
+      n = c > 16 ? 16 : c;
+      dest = row;
+      for( i = 0; i < n; i++ )
+      {
+	if ( u8g2->cb == &u8g2_cb_r1_transpose )
+	{
+	  src = u8g2->tile_buf_ptr + (uint16_t)(tile_width-1-(x+i)) * stride + ty*8;
+	  u8x8_transpose_8x8(src, tmp);
+	  for( k = 0; k < 8; k++ )
+	    dest[k] = tmp[7-k];
+	}
+	else
+	{
+	  src = u8g2->tile_buf_ptr + (uint16_t)(x+i) * stride + (tile_height-1-ty)*8;
+	  for( k = 0; k < 8; k++ )
+	    tmp[k] = src[7-k];
+	  u8x8_transpose_8x8(tmp, dest);
+	}
+	dest += 8;
+      }
+      u8x8_DrawTile(u8g2_GetU8x8(u8g2), x, ty, n, row);
+      x += n;
+      c -= n;
+    }
+    ty++;
+    th--;
+  }
 }
+#endif
 
 /* 
   write the buffer to the display RAM. 
   For most displays, this will make the content visible to the user.
   Some displays (like the SSD1606) require a u8x8_RefreshDisplay()
+  All tile rows of the buffer are sent with one u8x8_DrawTileArea(), so that
+  drivers with U8X8_MSG_DISPLAY_DRAW_AREA can stream the complete buffer.
 */
 static void u8g2_send_buffer(u8g2_t *u8g2) U8X8_NOINLINE;
 static void u8g2_send_buffer(u8g2_t *u8g2)
 {
-  uint8_t src_row;
-  uint8_t src_max;
+  uint8_t rows;
   uint8_t dest_row;
   uint8_t dest_max;
 
-  src_row = 0;
-  src_max = u8g2->tile_buf_height;
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+  if ( u8g2->cb == &u8g2_cb_r1_transpose || u8g2->cb == &u8g2_cb_r3_transpose )
+  {
+    u8g2_send_transpose(u8g2, 0, 0, u8g2_GetU8x8(u8g2)->display_info->tile_width, u8g2_GetU8x8(u8g2)->display_info->tile_height);
+    return;
+  }
+#endif
+  rows = u8g2->tile_buf_height;
   dest_row = u8g2->tile_curr_row;
   dest_max = u8g2_GetU8x8(u8g2)->display_info->tile_height;
   
-  do
-  {
-    u8g2_send_tile_row(u8g2, src_row, dest_row);
-    src_row++;
-    dest_row++;
-  } while( src_row < src_max && dest_row < dest_max );
+  if ( dest_row >= dest_max )
+    rows = 1;	/* same as before: the first tile row is always sent */
+  else if ( rows > dest_max - dest_row )
+    rows = dest_max - dest_row;
+  
+  u8x8_DrawTileArea(u8g2_GetU8x8(u8g2), 0, dest_row, u8g2_GetU8x8(u8g2)->display_info->tile_width, rows, u8g2->tile_buf_ptr);
 }
 
 /* same as u8g2_send_buffer but also send the DISPLAY_REFRESH message (used by SSD1606) */
@@ -149,6 +197,7 @@ uint8_t u8g2_NextPage(u8g2_t *u8g2)
     - Any display rotation/mirror is ignored
     - Only works with displays, which support U8x8 API
     - Will not send the e-paper refresh message (will probably not work with e-paper devices)
+    - With U8G2_R1_TRANSPOSE/U8G2_R3_TRANSPOSE the tiles are still display tiles, they are rotated from the buffer
 */
 void u8g2_UpdateDisplayArea(u8g2_t *u8g2, uint8_t  tx, uint8_t ty, uint8_t tw, uint8_t th)
 {
@@ -159,19 +208,21 @@ void u8g2_UpdateDisplayArea(u8g2_t *u8g2, uint8_t  tx, uint8_t ty, uint8_t tw, u
   if ( u8g2->tile_buf_height != u8g2_GetU8x8(u8g2)->display_info->tile_height )
     return; /* not in full buffer mode, do nothing */
 
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+  if ( u8g2->cb == &u8g2_cb_r1_transpose || u8g2->cb == &u8g2_cb_r3_transpose )
+  {
+    u8g2_send_transpose(u8g2, tx, ty, tw, th);
+    return;
+  }
+#endif
+
   page_size = u8g2->pixel_buf_width;  /* 8*u8g2->u8g2_GetU8x8(u8g2)->display_info->tile_width */
     
   ptr = u8g2_GetBufferPtr(u8g2);
   ptr += tx*8;
   ptr += page_size*ty;
   
-  while( th > 0 )
-  {
-    u8x8_DrawTile( u8g2_GetU8x8(u8g2), tx, ty, tw, ptr );
-    ptr += page_size;
-    ty++;
-    th--;
-  }  
+  u8x8_DrawTileArea( u8g2_GetU8x8(u8g2), tx, ty, tw, th, ptr );
 }
 
 /* same as sendBuffer, but does not send the ePaper refresh message */
@@ -34,6 +34,7 @@
 */
 
 #include "u8g2.h"
+#include <string.h>
 
 /* size of the font data structure, there is no struct or class... */
 /* this is the size for the new font format */
@@ -233,6 +234,64 @@ uint8_t u8g2_GetFontCapitalAHeight(u8g2_t *u8g2)
 /*========================================================================*/
 /* glyph handling */
 
+#ifdef U8G2_WITH_FONT_WORD_READER
+
+/* add at least cnt bits to the bit buffer, decode_bit_pos must be lower than cnt */
+static void u8g2_font_decode_refill(u8g2_font_decode_t *f, uint8_t cnt)
+{
+  uint32_t w;
+  uint8_t bytes;
+  
+  if ( f->decode_ptr + 4 <= f->decode_end )
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(&w, f->decode_ptr, 4);
+#else
+    w = (uint32_t)f->decode_ptr[0];
+    w |= (uint32_t)f->decode_ptr[1] << 8;
+    w |= (uint32_t)f->decode_ptr[2] << 16;
+    w |= (uint32_t)f->decode_ptr[3] << 24;
+#endif
+    /* as many complete bytes as fit into the buffer */
+    bytes = (32 - f->decode_bit_pos) >> 3;
+    f->decode_bits |= w << f->decode_bit_pos;
+    f->decode_ptr += bytes;
+    f->decode_bit_pos += bytes << 3;
+  }
+  else
+  {
+    /* close to the end of the glyph: do not read more than required */
+    do
+    {
+      f->decode_bits |= (uint32_t)u8x8_pgm_read( f->decode_ptr ) << f->decode_bit_pos;
+      f->decode_ptr++;
+      f->decode_bit_pos += 8;
+    } while ( f->decode_bit_pos < cnt );
+  }
+}
+
+/* inlined into the run length loops of this file */
+static inline uint8_t u8g2_font_decode_bits(u8g2_font_decode_t *f, uint8_t cnt) 
+{
+  uint8_t val;
+  
+  if ( f->decode_bit_pos < cnt )
+    u8g2_font_decode_refill(f, cnt);
+  val = (uint8_t)(f->decode_bits & ((1U<<cnt)-1));
+  f->decode_bits >>= cnt;
+  f->decode_bit_pos -= cnt;
+  return val;
+}
+
+uint8_t u8g2_font_decode_get_unsigned_bits(u8g2_font_decode_t *f, uint8_t cnt) 
+{
+  return u8g2_font_decode_bits(f, cnt);
+}
+
+#define u8g2_font_decode_run_bits(f, cnt) u8g2_font_decode_bits((f), (cnt))
+
+#else /* U8G2_WITH_FONT_WORD_READER */
+
 /* optimized */
 uint8_t u8g2_font_decode_get_unsigned_bits(u8g2_font_decode_t *f, uint8_t cnt) 
 {
@@ -263,6 +322,10 @@ uint8_t u8g2_font_decode_get_unsigned_bits(u8g2_font_decode_t *f, uint8_t cnt)
   return val;
 }
 
+#define u8g2_font_decode_run_bits(f, cnt) u8g2_font_decode_get_unsigned_bits((f), (cnt))
+
+#endif /* U8G2_WITH_FONT_WORD_READER */
+
 
 /*
     2 bit --> cnt = 2
@@ -580,6 +643,11 @@ static void u8g2_font_setup_decode(u8g2_t *u8g2, const uint8_t *glyph_data)
   u8g2_font_decode_t *decode = &(u8g2->font_decode);
   decode->decode_ptr = glyph_data;
   decode->decode_bit_pos = 0;
+#ifdef U8G2_WITH_FONT_WORD_READER
+  /* the glyph size is stored in front of the data and includes the header (2 or 3 bytes) */
+  decode->decode_end = glyph_data + u8x8_pgm_read( glyph_data - 1 ) - 3;
+  decode->decode_bits = 0;
+#endif
   
   /* 8 Nov 2015, this is already done in the glyph data search procedure */
   /*
@@ -691,13 +759,13 @@ int8_t u8g2_font_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
     /* decode glyph */
     for(;;)
     {
-      a = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_0);
-      b = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_1);
+      a = u8g2_font_decode_run_bits(decode, u8g2->font_info.bits_per_0);
+      b = u8g2_font_decode_run_bits(decode, u8g2->font_info.bits_per_1);
       do
       {
 	u8g2_font_decode_len(u8g2, a, 0);
 	u8g2_font_decode_len(u8g2, b, 1);
-      } while( u8g2_font_decode_get_unsigned_bits(decode, 1) != 0 );
+      } while( u8g2_font_decode_run_bits(decode, 1) != 0 );
 
       if ( decode->y >= h )
 	break;
@@ -753,13 +821,13 @@ int8_t u8g2_font_2x_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
     /* decode glyph */
     for(;;)
     {
-      a = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_0);
-      b = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_1);
+      a = u8g2_font_decode_run_bits(decode, u8g2->font_info.bits_per_0);
+      b = u8g2_font_decode_run_bits(decode, u8g2->font_info.bits_per_1);
       do
       {
 	u8g2_font_2x_decode_len(u8g2, a, 0);
 	u8g2_font_2x_decode_len(u8g2, b, 1);
-      } while( u8g2_font_decode_get_unsigned_bits(decode, 1) != 0 );
+      } while( u8g2_font_decode_run_bits(decode, 1) != 0 );
 
       if ( decode->y >= h )
 	break;
@@ -771,6 +839,124 @@ int8_t u8g2_font_2x_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
   return d*2;
 }
 
+#ifdef U8G2_WITH_GLYPH_INDEX
+void u8g2_InitGlyphIndex(u8g2_glyph_index_t *glyph_index, u8g2_glyph_index_entry_t *unicode, uint16_t unicode_capacity)
+{
+  glyph_index->font = NULL;
+  glyph_index->is_ascii_valid = 0;
+#ifdef U8G2_WITH_UNICODE
+  glyph_index->unicode = unicode;
+  glyph_index->unicode_capacity = unicode == NULL ? 0 : unicode_capacity;
+  glyph_index->unicode_cnt = 0;
+#else
+  (void)unicode;
+  (void)unicode_capacity;
+#endif
+}
+
+/*
+  Walk all glyphs of the font once and store the offsets of the glyph data.
+  Unicode glyphs are stored in font order, which is sorted by encoding.
+*/
+void u8g2_BuildGlyphIndex(u8g2_glyph_index_t *glyph_index, const uint8_t *font)
+{
+  const uint8_t *p = font + U8G2_FONT_DATA_STRUCT_SIZE;
+  uint16_t i;
+  uint32_t offset;
+  
+  for( i = 0; i < 256; i++ )
+    glyph_index->ascii[i] = 0;
+  glyph_index->is_ascii_valid = 1;
+  
+  while ( u8x8_pgm_read( p + 1 ) != 0 )
+  {
+    offset = (uint32_t)(p + 2 - font);
+    if ( offset > 0x0ffff )
+      glyph_index->is_ascii_valid = 0;
+    else
+      glyph_index->ascii[u8x8_pgm_read( p )] = (uint16_t)offset;
+    p += u8x8_pgm_read( p + 1 );
+  }
+  
+#ifdef U8G2_WITH_UNICODE
+  {
+    uint16_t e;
+    uint16_t cnt = 0;
+    
+    p = font + U8G2_FONT_DATA_STRUCT_SIZE + u8g2_font_get_word(font, 21);
+    /* the first entry of the unicode lookup table points to the first glyph */
+    p += u8g2_font_get_word(p, 0);
+    for(;;)
+    {
+      e = u8x8_pgm_read( p );
+      e <<= 8;
+      e |= u8x8_pgm_read( p + 1 );
+      if ( e == 0 )
+        break;
+      if ( cnt >= glyph_index->unicode_capacity )
+      {
+        cnt = U8G2_GLYPH_INDEX_INCOMPLETE;
+        break;
+      }
+      glyph_index->unicode[cnt].encoding = e;
+      glyph_index->unicode[cnt].offset = (uint32_t)(p + 3 - font);
+      cnt++;
+      p += u8x8_pgm_read( p + 2 );
+    }
+    glyph_index->unicode_cnt = cnt;
+  }
+#endif
+  
+  glyph_index->font = font;
+}
+
+/*
+  Return:
+    1 if the index has answered the lookup, *glyph_data is the glyph or NULL
+    0 if the glyph must be searched in the font
+*/
+static uint8_t u8g2_glyph_index_lookup(u8g2_t *u8g2, uint16_t encoding, const uint8_t **glyph_data)
+{
+  u8g2_glyph_index_t *glyph_index = u8g2->glyph_index;
+  
+  if ( glyph_index->font != u8g2->font )
+    u8g2_BuildGlyphIndex(glyph_index, u8g2->font);
+  
+  if ( encoding <= 255 )
+  {
+    if ( glyph_index->is_ascii_valid == 0 )
+      return 0;
+    *glyph_data = glyph_index->ascii[encoding] == 0 ? NULL : u8g2->font + glyph_index->ascii[encoding];
+    return 1;
+  }
+#ifdef U8G2_WITH_UNICODE
+  else
+  {
+    uint16_t lo, hi, mid;
+    if ( glyph_index->unicode_cnt == U8G2_GLYPH_INDEX_INCOMPLETE )
+      return 0;
+    lo = 0;
+    hi = glyph_index->unicode_cnt;
+    while ( lo < hi )
+    {
+      mid = (uint16_t)((lo + hi) >> 1);
+      if ( glyph_index->unicode[mid].encoding < encoding )
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if ( lo < glyph_index->unicode_cnt && glyph_index->unicode[lo].encoding == encoding )
+      *glyph_data = u8g2->font + glyph_index->unicode[lo].offset;
+    else
+      *glyph_data = NULL;
+    return 1;
+  }
+#else
+  return 0;
+#endif
+}
+#endif /* U8G2_WITH_GLYPH_INDEX */
+
 /*
   Description:
     Find the starting point of the glyph data.
@@ -782,6 +968,16 @@ int8_t u8g2_font_2x_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
 const uint8_t *u8g2_font_get_glyph_data(u8g2_t *u8g2, uint16_t encoding)
 {
   const uint8_t *font = u8g2->font;
+  
+#ifdef U8G2_WITH_GLYPH_INDEX
+  if ( u8g2->glyph_index != NULL )
+  {
+    const uint8_t *glyph_data;
+    if ( u8g2_glyph_index_lookup(u8g2, encoding, &glyph_data) )
+      return glyph_data;
+  }
+#endif
+  
   font += U8G2_FONT_DATA_STRUCT_SIZE;
 
   
@@ -866,9 +1062,379 @@ const uint8_t *u8g2_font_get_glyph_data(u8g2_t *u8g2, uint16_t encoding)
   return NULL;
 }
 
+#ifdef U8G2_WITH_GLYPH_CACHE
+
+#define U8G2_GLYPH_CACHE_NONE 0x0ff
+
+/* 
+  Each slot starts with this header, followed by the glyph bitmap: 
+  (height+7)/8 pages, each page has "width" bytes, lsb is the top row.
+*/
+struct _u8g2_glyph_cache_slot_t
+{
+  const uint8_t *font;		/* NULL: slot not used */
+  uint16_t encoding;
+  uint8_t prev, next;		/* LRU list, prev is more recently used */
+  uint8_t hnext;		/* next slot with the same hash value */
+  uint8_t width, height;
+  int8_t x, y, delta;
+};
+typedef struct _u8g2_glyph_cache_slot_t u8g2_glyph_cache_slot_t;
+
+#define u8g2_glyph_cache_slot(cache, i) ((u8g2_glyph_cache_slot_t *)((cache)->slots + (uint16_t)(i)*(cache)->slot_size))
+#define u8g2_glyph_cache_bitmap(slot) (((uint8_t *)(slot)) + sizeof(u8g2_glyph_cache_slot_t))
+
+static uint8_t u8g2_glyph_cache_hash(u8g2_glyph_cache_t *cache, const uint8_t *font, uint16_t encoding)
+{
+  uint16_t h = encoding;
+  h ^= (uint16_t)(((size_t)font) >> 4);
+  h ^= h >> 8;
+  return (uint8_t)h & cache->hash_mask;
+}
+
+uint8_t u8g2_InitGlyphCache(u8g2_glyph_cache_t *cache, void *arena, size_t arena_size, uint16_t max_bitmap_bytes)
+{
+  uint8_t *p = (uint8_t *)arena;
+  size_t align = sizeof(void *);
+  size_t slot_size = (sizeof(u8g2_glyph_cache_slot_t) + max_bitmap_bytes + align - 1) & ~(align - 1);
+  size_t skip;
+  size_t cnt;
+  uint16_t hash_cnt;
+  
+  cache->slot_cnt = 0;
+  cache->hash_mask = 0;
+  cache->max_bitmap_bytes = max_bitmap_bytes;
+  cache->slot_size = (uint16_t)slot_size;
+  
+  /* hash table at the start of the arena, then the aligned slots */
+  cnt = arena_size / (slot_size + 1);
+  if ( cnt > 254 )
+    cnt = 254;
+  for(;;)
+  {
+    if ( cnt == 0 )
+      return 0;
+    hash_cnt = 1;
+    while ( hash_cnt < cnt )
+      hash_cnt <<= 1;
+    skip = (align - ((size_t)(p + hash_cnt) & (align - 1))) & (align - 1);
+    if ( hash_cnt + skip + cnt * slot_size <= arena_size )
+      break;
+    cnt--;
+  }
+  
+  cache->hash = p;
+  cache->hash_mask = (uint8_t)(hash_cnt - 1);
+  cache->slots = p + hash_cnt + skip;
+  cache->slot_cnt = (uint8_t)cnt;
+  u8g2_ClearGlyphCache(cache);
+  return cache->slot_cnt;
+}
+
+void u8g2_ClearGlyphCache(u8g2_glyph_cache_t *cache)
+{
+  u8g2_glyph_cache_slot_t *slot;
+  uint16_t i;
+  
+  for( i = 0; i <= cache->hash_mask; i++ )
+    cache->hash[i] = U8G2_GLYPH_CACHE_NONE;
+  for( i = 0; i < cache->slot_cnt; i++ )
+  {
+    slot = u8g2_glyph_cache_slot(cache, i);
+    slot->font = NULL;
+    slot->prev = i == 0 ? U8G2_GLYPH_CACHE_NONE : (uint8_t)(i - 1);
+    slot->next = i + 1 == cache->slot_cnt ? U8G2_GLYPH_CACHE_NONE : (uint8_t)(i + 1);
+    slot->hnext = U8G2_GLYPH_CACHE_NONE;
+  }
+  cache->mru = 0;
+  cache->lru = cache->slot_cnt == 0 ? U8G2_GLYPH_CACHE_NONE : (uint8_t)(cache->slot_cnt - 1);
+  cache->hits = 0;
+  cache->misses = 0;
+}
+
+static void u8g2_glyph_cache_touch(u8g2_glyph_cache_t *cache, uint8_t i)
+{
+  u8g2_glyph_cache_slot_t *slot = u8g2_glyph_cache_slot(cache, i);
+  if ( cache->mru == i )
+    return;
+  /* unlink */
+  u8g2_glyph_cache_slot(cache, slot->prev)->next = slot->next;
+  if ( slot->next != U8G2_GLYPH_CACHE_NONE )
+    u8g2_glyph_cache_slot(cache, slot->next)->prev = slot->prev;
+  else
+    cache->lru = slot->prev;
+  /* insert as most recently used */
+  slot->prev = U8G2_GLYPH_CACHE_NONE;
+  slot->next = cache->mru;
+  u8g2_glyph_cache_slot(cache, cache->mru)->prev = i;
+  cache->mru = i;
+}
+
+/* remove the least recently used glyph from its hash chain and return its slot */
+static uint8_t u8g2_glyph_cache_evict(u8g2_glyph_cache_t *cache)
+{
+  uint8_t i = cache->lru;
+  u8g2_glyph_cache_slot_t *slot = u8g2_glyph_cache_slot(cache, i);
+  uint8_t *link;
+  
+  if ( slot->font != NULL )
+  {
+    link = cache->hash + u8g2_glyph_cache_hash(cache, slot->font, slot->encoding);
+    while ( *link != i )
+      link = &(u8g2_glyph_cache_slot(cache, *link)->hnext);
+    *link = slot->hnext;
+    slot->font = NULL;
+  }
+  return i;
+}
+
+/* set "len" bitmap pixels, starting at the current decode position, wrap at the glyph width */
+static void u8g2_glyph_cache_decode_len(u8g2_font_decode_t *decode, uint8_t *bitmap, uint8_t len, uint8_t is_foreground)
+{
+  uint8_t cnt = len;
+  uint8_t rem, current, lx, ly, mask;
+  uint8_t *ptr;
+  
+  lx = decode->x;
+  ly = decode->y;
+  for(;;)
+  {
+    rem = decode->glyph_width;
+    rem -= lx;
+    current = rem;
+    if ( cnt < rem )
+      current = cnt;
+    if ( is_foreground && ly < decode->glyph_height )
+    {
+      ptr = bitmap + (uint16_t)(ly >> 3) * decode->glyph_width + lx;
+      mask = 1 << (ly & 7);
+      while ( current > 0 )
+      {
+        *ptr++ |= mask;
+        current--;
+      }
+    }
+    if ( cnt < rem )
+      break;
+    cnt -= rem;
+    lx = 0;
+    ly++;
+  }
+  lx += cnt;
+  decode->x = lx;
+  decode->y = ly;
+}
+
+/* same as u8g2_font_decode_glyph(), but the glyph is written into the slot */
+static void u8g2_glyph_cache_decode(u8g2_t *u8g2, u8g2_glyph_cache_slot_t *slot)
+{
+  u8g2_font_decode_t *decode = &(u8g2->font_decode);
+  uint8_t *bitmap = u8g2_glyph_cache_bitmap(slot);
+  uint16_t i, size;
+  uint8_t a, b;
+  
+  size = (uint16_t)((slot->height + 7) >> 3) * slot->width;
+  for( i = 0; i < size; i++ )
+    bitmap[i] = 0;
+  if ( slot->width == 0 )
+    return;
+  
+  decode->x = 0;
+  decode->y = 0;
+  for(;;)
+  {
+    a = u8g2_font_decode_run_bits(decode, u8g2->font_info.bits_per_0);
+    b = u8g2_font_decode_run_bits(decode, u8g2->font_info.bits_per_1);
+    do
+    {
+      u8g2_glyph_cache_decode_len(decode, bitmap, a, 0);
+      u8g2_glyph_cache_decode_len(decode, bitmap, b, 1);
+    } while( u8g2_font_decode_run_bits(decode, 1) != 0 );
+    if ( decode->y >= slot->height )
+      break;
+  }
+}
+
+/* 8 glyph rows, starting at row "start" (-7..height-1) of column "col" */
+static uint8_t u8g2_glyph_cache_get_rows(u8g2_glyph_cache_slot_t *slot, uint8_t col, int16_t start)
+{
+  const uint8_t *bitmap = u8g2_glyph_cache_bitmap(slot) + col;
+  uint8_t pages = (slot->height + 7) >> 3;
+  uint8_t page;
+  uint8_t shift;
+  uint16_t v;
+  
+  if ( start < 0 )
+    return (uint8_t)(bitmap[0] << (-start));
+  page = (uint8_t)(start >> 3);
+  shift = start & 7;
+  v = bitmap[(uint16_t)page * slot->width];
+  if ( shift != 0 && page + 1 < pages )
+    v |= (uint16_t)bitmap[(uint16_t)(page + 1) * slot->width] << 8;
+  return (uint8_t)(v >> shift);
+}
+
+/* copy the glyph into the buffer, clipped against the current page and clip window */
+static void u8g2_glyph_cache_blit(u8g2_t *u8g2, u8g2_glyph_cache_slot_t *slot, u8g2_uint_t x0, u8g2_uint_t y0)
+{
+  u8g2_font_decode_t *decode = &(u8g2->font_decode);
+  u8g2_uint_t x1 = x0 + slot->width;
+  u8g2_uint_t y1 = y0 + slot->height;
+  u8g2_uint_t cx0, cx1, cy0, cy1;
+  uint16_t row, row_end, page, page_end;
+  int16_t start;
+  uint8_t *ptr;
+  uint8_t page_mask, fg, bg, c, col, col_end;
+  
+  cx0 = x0 < u8g2->user_x0 ? u8g2->user_x0 : x0;
+  cx1 = x1 > u8g2->user_x1 ? u8g2->user_x1 : x1;
+  cy0 = y0 < u8g2->user_y0 ? u8g2->user_y0 : y0;
+  cy1 = y1 > u8g2->user_y1 ? u8g2->user_y1 : y1;
+  if ( cx0 >= cx1 || cy0 >= cy1 )
+    return;
+  
+  /* rows in buffer coordinates */
+  row = cy0 - u8g2->pixel_curr_row;
+  row_end = cy1 - u8g2->pixel_curr_row;
+  col = (uint8_t)(cx0 - x0);
+  col_end = (uint8_t)(cx1 - x0);
+  page_end = (row_end + 7) >> 3;
+  for( page = row >> 3; page < page_end; page++ )
+  {
+    page_mask = 0xff;
+    if ( (page << 3) < row )
+      page_mask <<= row & 7;
+    if ( (page << 3) + 8 > row_end )
+      page_mask &= 0xff >> (8 - (row_end & 7));
+    
+    start = (int16_t)((int32_t)(page << 3) + u8g2->pixel_curr_row - (int32_t)y0);
+    ptr = u8g2->tile_buf_ptr + (uint16_t)page * u8g2->pixel_buf_width + cx0;
+    for( c = col; c < col_end; c++ )
+    {
+      fg = u8g2_glyph_cache_get_rows(slot, c, start) & page_mask;
+      if ( decode->is_transparent == 0 )
+      {
+        bg = ~fg & page_mask;
+        if ( decode->bg_color == 0 )
+          *ptr &= ~bg;
+        else
+          *ptr |= bg;
+      }
+      if ( decode->fg_color == 0 )
+        *ptr &= ~fg;
+      else if ( decode->fg_color == 1 )
+        *ptr |= fg;
+      else
+        *ptr ^= fg;
+      ptr++;
+    }
+  }
+}
+
+/*
+  Draw the glyph from the cache, decode it into the cache if required.
+  Return:
+    0 if the cache can not be used, the glyph must be drawn by the caller
+    1 if the glyph has been handled, *dx is the delta x advance
+*/
+static uint8_t u8g2_glyph_cache_draw(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding, u8g2_uint_t *dx)
+{
+  u8g2_glyph_cache_t *cache = u8g2->glyph_cache;
+  u8g2_font_decode_t *decode = &(u8g2->font_decode);
+  u8g2_glyph_cache_slot_t *slot;
+  const uint8_t *glyph_data;
+  uint8_t *link;
+  uint8_t i;
+  uint8_t width, height;
+  int8_t h;
+  u8g2_uint_t x0, y0;
+  
+  if ( cache->slot_cnt == 0 || u8g2->cb->draw_l90 != u8g2_draw_l90_r0 || u8g2->ll_hvline != u8g2_ll_hvline_vertical_top_lsb )
+    return 0;
+#ifdef U8G2_WITH_FONT_ROTATION
+  if ( decode->dir != 0 )
+    return 0;
+#endif
+  
+  link = cache->hash + u8g2_glyph_cache_hash(cache, u8g2->font, encoding);
+  for( i = *link; i != U8G2_GLYPH_CACHE_NONE; i = slot->hnext )
+  {
+    slot = u8g2_glyph_cache_slot(cache, i);
+    if ( slot->encoding == encoding && slot->font == u8g2->font )
+      break;
+  }
+  
+  if ( i != U8G2_GLYPH_CACHE_NONE )
+  {
+    cache->hits++;
+    decode->fg_color = u8g2->draw_color;
+    decode->bg_color = (decode->fg_color == 0 ? 1 : 0);
+  }
+  else
+  {
+    cache->misses++;
+    glyph_data = u8g2_font_get_glyph_data(u8g2, encoding);
+    if ( glyph_data == NULL )
+    {
+      *dx = 0;
+      return 1;
+    }
+    u8g2_font_setup_decode(u8g2, glyph_data);
+    width = decode->glyph_width;
+    height = decode->glyph_height;
+    if ( (uint16_t)((height + 7) >> 3) * width > cache->max_bitmap_bytes )
+    {
+      /* too large for a slot */
+      decode->target_x = x;
+      decode->target_y = y;
+      *dx = u8g2_font_decode_glyph(u8g2, glyph_data);
+      return 1;
+    }
+    
+    i = u8g2_glyph_cache_evict(cache);
+    slot = u8g2_glyph_cache_slot(cache, i);
+    slot->width = width;
+    slot->height = height;
+    slot->x = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_x);
+    slot->y = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_y);
+    slot->delta = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_delta_x);
+    u8g2_glyph_cache_decode(u8g2, slot);
+    
+    slot->font = u8g2->font;
+    slot->encoding = encoding;
+    slot->hnext = *link;
+    *link = i;
+  }
+  u8g2_glyph_cache_touch(cache, i);
+  
+  *dx = slot->delta;
+  if ( slot->width == 0 )
+    return 1;
+  
+  h = (int8_t)slot->height;
+  x0 = x + slot->x;
+  y0 = y - (h + slot->y);
+  /* glyphs, which wrap around the coordinate range, are handled by the clipping of the regular path */
+  if ( (u8g2_uint_t)(x0 + slot->width) < x0 || (u8g2_uint_t)(y0 + slot->height) < y0 )
+  {
+    return 0;
+  }
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if ( u8g2->is_page_clip_window_intersection == 0 )
+    return 1;
+#endif
+  u8g2_glyph_cache_blit(u8g2, slot, x0, y0);
+  return 1;
+}
+#endif /* U8G2_WITH_GLYPH_CACHE */
+
 static u8g2_uint_t u8g2_font_draw_glyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding)
 {
   u8g2_uint_t dx = 0;
+#ifdef U8G2_WITH_GLYPH_CACHE
+  if ( u8g2->glyph_cache != NULL && u8g2_glyph_cache_draw(u8g2, x, y, encoding, &dx) )
+    return dx;
+#endif
   u8g2->font_decode.target_x = x;
   u8g2->font_decode.target_y = y;
   //u8g2->font_decode.is_transparent = is_transparent; this is already set
@@ -1291,6 +1857,21 @@ void u8g2_SetFont(u8g2_t *u8g2, const uint8_t  *font)
   }
 }
 
+/*
+  Same as u8g2_SetFont(), but font_info must be the result of u8g2_read_font_info() for this font.
+  Applications which alternate between a few fonts can parse each header once and
+  avoid re-reading it on every switch.
+*/
+void u8g2_SetFontWithInfo(u8g2_t *u8g2, const uint8_t *font, const u8g2_font_info_t *font_info)
+{
+  if ( u8g2->font != font )
+  {
+    u8g2->font = font;
+    u8g2->font_info = *font_info;
+    u8g2_UpdateRefHeight(u8g2);
+  }
+}
+
 /*===============================================*/
 
 static uint8_t u8g2_is_all_valid(u8g2_t *u8g2, const char *str) U8G2_NOINLINE;
@@ -51,6 +51,61 @@
 #include "u8g2.h"
 #include <assert.h>
 
+#ifdef U8G2_WITH_HVLINE_SPEED_OPTIMIZATION
+
+/* 
+  32 bit access to the buffer for long spans. 
+  The buffer is a byte array, may_alias allows the access through a wider type.
+*/
+#if defined(__GNUC__) && !defined(__AVR__)
+#define U8G2_LL_HVLINE_WORD_ACCESS
+typedef uint32_t __attribute__((__may_alias__)) u8g2_ll_word_t;
+#endif
+
+/*
+  Apply or_mask and xor_mask to "len" consecutive bytes:
+    *ptr |= or_mask
+    *ptr ^= xor_mask
+*/
+static void u8g2_ll_span(uint8_t *ptr, u8g2_uint_t len, uint8_t or_mask, uint8_t xor_mask)
+{
+#ifdef U8G2_LL_HVLINE_WORD_ACCESS
+  if ( len >= 8 )
+  {
+    u8g2_ll_word_t *wptr;
+    uint32_t or_word, xor_word;
+    
+    while ( ((size_t)ptr & 3) != 0 )
+    {
+      *ptr |= or_mask;
+      *ptr ^= xor_mask;
+      ptr++;
+      len--;
+    }
+    or_word = or_mask * 0x01010101UL;
+    xor_word = xor_mask * 0x01010101UL;
+    wptr = (u8g2_ll_word_t *)ptr;
+    while ( len >= 4 )
+    {
+      *wptr |= or_word;
+      *wptr ^= xor_word;
+      wptr++;
+      len -= 4;
+    }
+    ptr = (uint8_t *)wptr;
+  }
+#endif
+  while ( len != 0 )
+  {
+    *ptr |= or_mask;
+    *ptr ^= xor_mask;
+    ptr++;
+    len--;
+  }
+}
+
+#endif /* U8G2_WITH_HVLINE_SPEED_OPTIMIZATION */
+
 /*=================================================*/
 /*
   u8g2_ll_hvline_vertical_top_lsb
@@ -73,7 +128,7 @@ void u8g2_ll_hvline_vertical_top_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y,
 {
   uint16_t offset;
   uint8_t *ptr;
-  uint8_t bit_pos, mask;
+  uint8_t bit_pos, mask, cnt;
   uint8_t or_mask, xor_mask;
 #ifdef __unix
   uint8_t *max_ptr = u8g2->tile_buf_ptr + u8g2_GetU8x8(u8g2)->display_info->tile_width*u8g2->tile_buf_height*8;
@@ -87,67 +142,61 @@ void u8g2_ll_hvline_vertical_top_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y,
   /* bytes are vertical, lsb on top (y=0), msb at bottom (y=7) */
   bit_pos = y;		/* overflow truncate is ok here... */
   bit_pos &= 7; 	/* ... because only the lowest 3 bits are needed */
-  mask = 1;
-  mask <<= bit_pos;
-
-  or_mask = 0;
-  xor_mask = 0;
-  if ( u8g2->draw_color <= 1 )
-    or_mask  = mask;
-  if ( u8g2->draw_color != 1 )
-    xor_mask = mask;
-
 
   offset = y;		/* y might be 8 or 16 bit, but we need 16 bit, so use a 16 bit variable */
   offset &= ~7;
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+  offset *= u8g2->tile_buf_width;
+#else
   offset *= u8g2_GetU8x8(u8g2)->display_info->tile_width;
+#endif
   ptr = u8g2->tile_buf_ptr;
   ptr += offset;
   ptr += x;
   
   if ( dir == 0 )
   {
-      do
-      {
+    mask = 1;
+    mask <<= bit_pos;
+    or_mask = 0;
+    xor_mask = 0;
+    if ( u8g2->draw_color <= 1 )
+      or_mask  = mask;
+    if ( u8g2->draw_color != 1 )
+      xor_mask = mask;
 #ifdef __unix
-	assert(ptr < max_ptr);
+    assert(ptr + len <= max_ptr);
 #endif
-	*ptr |= or_mask;
-	*ptr ^= xor_mask;
-	ptr++;
-	len--;
-      } while( len != 0 );
+    /* the same bit in "len" consecutive bytes */
+    u8g2_ll_span(ptr, len, or_mask, xor_mask);
   }
   else
   {    
-    do
+    /* one mask per byte: the partial first byte, full bytes, the partial last byte */
+    for(;;)
     {
 #ifdef __unix
       assert(ptr < max_ptr);
 #endif
-      *ptr |= or_mask;
-      *ptr ^= xor_mask;
-      
-      bit_pos++;
-      bit_pos &= 7;
-
-      len--;
-
-      if ( bit_pos == 0 )
-      {
-	ptr+=u8g2->pixel_buf_width;	/* 6 Jan 17: Changed u8g2->width to u8g2->pixel_buf_width, issue #148 */
-		
-	if ( u8g2->draw_color <= 1 )
-	  or_mask  = 1;
-	if ( u8g2->draw_color != 1 )
-	  xor_mask = 1;
-      }
-      else
+      mask = 0x0ff;
+      mask <<= bit_pos;
+      cnt = 8 - bit_pos;
+      if ( len < cnt )
       {
-	or_mask <<= 1;
-	xor_mask <<= 1;
+	mask &= 0x0ff >> (cnt - len);
+	cnt = len;
       }
-    } while( len != 0 );
+      if ( u8g2->draw_color <= 1 )
+	*ptr |= mask;
+      if ( u8g2->draw_color != 1 )
+	*ptr ^= mask;
+      
+      len -= cnt;
+      if ( len == 0 )
+	break;
+      bit_pos = 0;
+      ptr+=u8g2->pixel_buf_width;	/* 6 Jan 17: Changed u8g2->width to u8g2->pixel_buf_width, issue #148 */
+    }
   }
 }
 
@@ -246,13 +295,11 @@ void u8g2_ll_hvline_horizontal_right_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_
   uint16_t offset;
   uint8_t *ptr;
   uint8_t bit_pos;
-  uint8_t mask;
+  uint8_t mask, cnt;
   uint8_t tile_width = u8g2_GetU8x8(u8g2)->display_info->tile_width;
 
   bit_pos = x;		/* overflow truncate is ok here... */
   bit_pos &= 7; 	/* ... because only the lowest 3 bits are needed */
-  mask = 128;
-  mask >>= bit_pos;
 
   offset = y;		/* y might be 8 or 16 bit, but we need 16 bit, so use a 16 bit variable */
   offset *= tile_width;
@@ -262,28 +309,45 @@ void u8g2_ll_hvline_horizontal_right_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_
   
   if ( dir == 0 )
   {
-      
-    do
+    /* partial first byte, msb is the left pixel */
+    mask = 0x0ff;
+    mask >>= bit_pos;
+    cnt = 8 - bit_pos;
+    if ( len < cnt )
     {
-
+      mask &= 0x0ff << (cnt - len);
+      cnt = len;
+    }
+    if ( u8g2->draw_color <= 1 )
+      *ptr |= mask;
+    if ( u8g2->draw_color != 1 )
+      *ptr ^= mask;
+    ptr++;
+    len -= cnt;
+    
+    /* full bytes */
+    if ( len >= 8 )
+    {
+      u8g2_ll_span(ptr, len >> 3, u8g2->draw_color <= 1 ? 0x0ff : 0, u8g2->draw_color != 1 ? 0x0ff : 0);
+      ptr += len >> 3;
+      len &= 7;
+    }
+    
+    /* partial last byte */
+    if ( len != 0 )
+    {
+      mask = 0x0ff;
+      mask <<= 8 - len;
       if ( u8g2->draw_color <= 1 )
 	*ptr |= mask;
       if ( u8g2->draw_color != 1 )
 	*ptr ^= mask;
-      
-      mask >>= 1;
-      if ( mask == 0 )
-      {
-	mask = 128;
-        ptr++;
-      }
-      
-      //x++;
-      len--;
-    } while( len != 0 );
+    }
   }
   else
   {
+    mask = 128;
+    mask >>= bit_pos;
     do
     {
       if ( u8g2->draw_color <= 1 )
@@ -71,6 +71,12 @@ void u8g2_SetClipWindow(u8g2_t *u8g2, u8g2_uint_t clip_x0, u8g2_uint_t clip_y0,
 void u8g2_SetupBuffer(u8g2_t *u8g2, uint8_t *buf, uint8_t tile_buf_height, u8g2_draw_ll_hvline_cb ll_hvline_cb, const u8g2_cb_t *u8g2_cb)
 {
   u8g2->font = NULL;
+#ifdef U8G2_WITH_GLYPH_INDEX
+  u8g2->glyph_index = NULL;
+#endif
+#ifdef U8G2_WITH_GLYPH_CACHE
+  u8g2->glyph_cache = NULL;
+#endif
   //u8g2->kerning = NULL;
   //u8g2->get_kerning_cb = u8g2_GetNullKerning;
   
@@ -178,6 +184,9 @@ static void u8g2_update_dimension_common(u8g2_t *u8g2)
   u8g2->height = display_info->pixel_height;
 #endif
 
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+  u8g2->tile_buf_width = display_info->tile_width;
+#endif
 }
 
 /*==========================================================*/
@@ -301,6 +310,60 @@ void u8g2_update_page_win_r3(u8g2_t *u8g2)
 }
 
 
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+/*
+  U8G2_R1_TRANSPOSE and U8G2_R3_TRANSPOSE: 
+  The buffer contains the picture as seen by the user (width and height of the display 
+  are swapped), tile_height tiles per buffer row and tile_width buffer rows. 
+  Drawing is the same as for U8G2_R0, the tiles are rotated in u8g2_send_buffer().
+  Only for full buffer mode with the vertical_top_lsb buffer: For page buffers
+  (_1, _2 setup procedures), other buffer layouts and (without U8G2_16BIT)
+  displays with 256 or more pixel columns, the rotation is replaced by U8G2_R1 
+  or U8G2_R3. The picture is the same, only the speed advantage is lost.
+*/
+void u8g2_update_dimension_transpose(u8g2_t *u8g2)
+{
+  const u8x8_display_info_t *display_info = u8g2_GetU8x8(u8g2)->display_info;
+  u8g2_uint_t t;
+  
+  if ( u8g2->tile_buf_height != display_info->tile_height 
+    || u8g2->ll_hvline != u8g2_ll_hvline_vertical_top_lsb
+#ifndef U8G2_16BIT
+    || display_info->tile_width >= 32
+#endif
+    )
+  {
+    /* the caller uses u8g2->cb for update_page_win, so the replacement is used from now on */
+    if ( u8g2->cb == &u8g2_cb_r1_transpose )
+      u8g2->cb = &u8g2_cb_r1;
+    else
+      u8g2->cb = &u8g2_cb_r3;
+    u8g2->cb->update_dimension(u8g2);
+    return;
+  }
+  
+  u8g2_update_dimension_common(u8g2);
+  
+  u8g2->tile_buf_width = display_info->tile_height;
+  t = display_info->tile_height;
+  t *= 8;
+  u8g2->pixel_buf_width = t;
+  
+  t = display_info->tile_width;
+#ifndef U8G2_16BIT
+  if ( t >= 32 )
+    t = 31;
+#endif
+  t *= 8;
+  u8g2->pixel_buf_height = t;
+  u8g2->buf_y0 = 0;
+  u8g2->buf_y1 = t;
+  
+  u8g2->height = display_info->pixel_width;
+  u8g2->width = display_info->pixel_height;
+}
+#endif
+
 /*============================================*/
 extern void u8g2_draw_hv_line_2dir(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir);
 
@@ -452,6 +515,12 @@ const u8g2_cb_t u8g2_cb_r3 = { u8g2_update_dimension_r3, u8g2_update_page_win_r3
   
 const u8g2_cb_t u8g2_cb_mirror = { u8g2_update_dimension_r0, u8g2_update_page_win_r0, u8g2_draw_l90_mirrorr_r0 };
 const u8g2_cb_t u8g2_cb_mirror_vertical = { u8g2_update_dimension_r0, u8g2_update_page_win_r0, u8g2_draw_mirror_vertical_r0 };
+
+#ifdef U8G2_WITH_ROTATION_TRANSPOSE
+/* same procedures, the rotation direction is selected by the address in u8g2_send_buffer() */
+const u8g2_cb_t u8g2_cb_r1_transpose = { u8g2_update_dimension_transpose, u8g2_update_page_win_r0, u8g2_draw_l90_r0 };
+const u8g2_cb_t u8g2_cb_r3_transpose = { u8g2_update_dimension_transpose, u8g2_update_page_win_r0, u8g2_draw_l90_r0 };
+#endif
   
 /*============================================*/
 /* setup for the null device */
@@ -96,6 +96,15 @@
 /* Define this for an additional user pointer inside the u8x8 data struct */
 //#define U8X8_WITH_USER_PTR
 
+/* 
+  Undefine this to remove the shadow RAM support (u8x8_SetShadowRAM).
+  With a shadow RAM assigned, u8x8_DrawTile() only transfers the tiles which 
+  differ from the last transfered content. 
+*/
+#ifndef U8X8_WITHOUT_SHADOW_RAM
+#define U8X8_WITH_SHADOW_RAM
+#endif
+
 
 /* Undefine this to remove u8x8_SetFlipMode function */
 /* 26 May 2016: Obsolete */
@@ -211,6 +220,7 @@ uint8_t u8x8_pgm_read_esp(const uint8_t * addr);   /* u8x8_8x8.c */
 typedef struct u8x8_struct u8x8_t;
 typedef struct u8x8_display_info_struct u8x8_display_info_t;
 typedef struct u8x8_tile_struct u8x8_tile_t;
+typedef struct u8x8_segment_struct u8x8_segment_t;
 
 typedef uint8_t (*u8x8_msg_cb)(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 typedef uint16_t (*u8x8_char_cb)(u8x8_t *u8x8, uint8_t b);
@@ -233,6 +243,14 @@ struct u8x8_tile_struct
   uint8_t y_pos;	/* tile y position */
 };
 
+/* one block of a vectored byte transfer, see U8X8_MSG_BYTE_SEND_SEGMENTS */
+struct u8x8_segment_struct
+{
+  uint8_t *ptr;		/* bytes of this segment */
+  uint16_t len;		/* number of bytes, may exceed 255 */
+  uint8_t dc;		/* value for U8X8_MSG_BYTE_SET_DC */
+};
+
 
 struct u8x8_display_info_struct
 {
@@ -366,6 +384,9 @@ struct u8x8_struct
 #ifdef U8X8_WITH_USER_PTR
   void *user_ptr;
 #endif
+#ifdef U8X8_WITH_SHADOW_RAM
+  uint8_t *shadow_ram;		/* copy of the display RAM followed by one valid flag per tile row, NULL: not used */
+#endif
 #ifdef U8X8_USE_PINS 
   uint8_t pins[U8X8_PIN_CNT];	/* defines a pinlist: Mainly a list of pins for the Arduino Environment, use U8X8_PIN_xxx to access */
 #endif
@@ -533,6 +554,26 @@ void u8x8_d_helper_display_init(u8x8_t *u8g2);
 */
 #define U8X8_MSG_DISPLAY_REFRESH 16
 
+/*
+  Name: 	U8X8_MSG_DISPLAY_DRAW_AREA
+  Args:	
+    arg_int: number of tile rows (>= 1)
+    arg_ptr: pointer to u8x8_tile_t
+        uint8_t *tile_ptr;	pointer to the tiles of the first tile row
+	uint8_t cnt;		number of tiles per tile row
+	uint8_t x_pos;		first tile x position
+	uint8_t y_pos;		first tile y position 
+  Tasks:
+    Draw a rectangle of cnt x arg_int tiles. The tiles of the next tile
+    row start 8*tile_width bytes (tile_width of the display) after the 
+    tiles of the current row. This is the memory layout of the u8g2 buffer.
+    This message is optional: Drivers, which can transfer the area with
+    one address setup (e.g. SSD1306 horizontal addressing mode) return 1.
+    All other drivers return 0, u8x8_DrawTileArea() will then use 
+    U8X8_MSG_DISPLAY_DRAW_TILE for each tile row.
+*/
+#define U8X8_MSG_DISPLAY_DRAW_AREA 17
+
 /*==========================================*/
 /* u8x8_setup.c */
 
@@ -551,6 +592,8 @@ void u8x8_Setup(u8x8_t *u8x8, u8x8_msg_cb display_cb, u8x8_msg_cb cad_cb, u8x8_m
 /*==========================================*/
 /* u8x8_display.c */
 uint8_t u8x8_DrawTile(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t *tile_ptr);
+/* tile rows are 8*tile_width bytes apart, see U8X8_MSG_DISPLAY_DRAW_AREA */
+uint8_t u8x8_DrawTileArea(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t rows, uint8_t *tile_ptr);
 
 /* 
   After a call to u8x8_SetupDefaults, 
@@ -585,6 +628,27 @@ void u8x8_FillDisplay(u8x8_t *u8x8);
 void u8x8_RefreshDisplay(u8x8_t *u8x8);	// make RAM content visible on the display (Dec 16: SSD1606 only)
 void u8x8_ClearLine(u8x8_t *u8x8, uint8_t line);
 
+#ifdef U8X8_WITH_SHADOW_RAM
+/*
+  Shadow RAM: A copy of the display RAM. u8x8_DrawTile() compares the tiles 
+  with the shadow RAM and sends only the changed tiles, adjacent changed tiles 
+  are sent together. This works with all display drivers, but only if the 
+  display RAM is exclusivly written by u8x8_DrawTile(), u8x8_ClearDisplay(), 
+  u8x8_FillDisplay() or u8x8_ClearLine().
+  The memory must have U8X8_SHADOW_RAM_SIZE(tile_width, tile_height) bytes,
+  u8x8_GetShadowRAMSize() returns the size for the current display.
+  u8x8_SetShadowRAM(u8x8, NULL) disables the shadow RAM.
+  The shadow RAM is invalidated by u8x8_SetShadowRAM(), u8x8_InitDisplay() and 
+  u8x8_SetFlipMode(), the next transfer will send all tiles. 
+  u8x8_InvalidateShadowRAM() can be used, if the display RAM has been
+  modified otherwise.
+*/
+#define U8X8_SHADOW_RAM_SIZE(tile_width, tile_height) ((tile_width)*(tile_height)*8+(tile_height))
+#define u8x8_GetShadowRAMSize(u8x8) U8X8_SHADOW_RAM_SIZE((uint16_t)(u8x8)->display_info->tile_width, (uint16_t)(u8x8)->display_info->tile_height)
+void u8x8_SetShadowRAM(u8x8_t *u8x8, uint8_t *buf);
+void u8x8_InvalidateShadowRAM(u8x8_t *u8x8);
+#endif
+
 
 
 /*==========================================*/
@@ -611,12 +675,19 @@ void u8x8_ClearLine(u8x8_t *u8x8, uint8_t line);
 /* arg_int = 0: disable chip, arg_int = 1: enable chip */
 //#define U8X8_MSG_CAD_SET_I2C_ADR 26
 //#define U8X8_MSG_CAD_SET_DEVICE 27
+/* 
+  optional: send all collected commands and data to the display, before a delay 
+  within a transfer (U8X8_DLY in a sequence). Only needed by cad procedures, 
+  which collect bytes (u8x8_cad_ssd13xx_stream_i2c), all others return 0.
+*/
+#define U8X8_MSG_CAD_FLUSH 28
 
 
 
 /* u8g_cad.c */
 
 #define u8x8_cad_Init(u8x8) ((u8x8)->cad_cb((u8x8), U8X8_MSG_CAD_INIT, 0, NULL ))
+#define u8x8_cad_Flush(u8x8) ((u8x8)->cad_cb((u8x8), U8X8_MSG_CAD_FLUSH, 0, NULL ))
 
 uint8_t u8x8_cad_SendCmd(u8x8_t *u8x8, uint8_t cmd) U8X8_NOINLINE;
 uint8_t u8x8_cad_SendArg(u8x8_t *u8x8, uint8_t arg) U8X8_NOINLINE;
@@ -666,6 +737,7 @@ uint8_t u8x8_cad_st7920_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 uint8_t u8x8_cad_ssd13xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);        /* CAD=001 */
 uint8_t u8x8_cad_011_ssd13xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);     /* CAD=011 */
 uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);   /* CAD=001 */
+uint8_t u8x8_cad_ssd13xx_stream_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);   /* CAD=001, one i2c transfer per cad transfer */
 uint8_t u8x8_cad_st75256_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_cad_ld7032_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_cad_uc16xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);  /* CAD=001 */
@@ -683,6 +755,16 @@ uint8_t u8x8_cad_uc1638_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 #define U8X8_MSG_BYTE_START_TRANSFER U8X8_MSG_CAD_START_TRANSFER
 #define U8X8_MSG_BYTE_END_TRANSFER U8X8_MSG_CAD_END_TRANSFER
 
+/*
+  U8X8_MSG_BYTE_SEND_SEGMENTS: 
+    arg_int: number of segments, arg_ptr: array of u8x8_segment_t
+    Send all segments in this order, apply the dc value of each segment
+    before its bytes. Only valid between START_TRANSFER and END_TRANSFER.
+    Optional: Byte procedures return 0 if not supported, u8x8_byte_SendSegments() 
+    will then use U8X8_MSG_BYTE_SET_DC and U8X8_MSG_BYTE_SEND.
+*/
+#define U8X8_MSG_BYTE_SEND_SEGMENTS 33
+
 //#define U8X8_MSG_BYTE_SET_I2C_ADR U8X8_MSG_CAD_SET_I2C_ADR
 //#define U8X8_MSG_BYTE_SET_DEVICE U8X8_MSG_CAD_SET_DEVICE
 
@@ -692,6 +774,7 @@ uint8_t u8x8_byte_SendByte(u8x8_t *u8x8, uint8_t byte) U8X8_NOINLINE;
 uint8_t u8x8_byte_SendBytes(u8x8_t *u8x8, uint8_t cnt, uint8_t *data) U8X8_NOINLINE;
 uint8_t u8x8_byte_StartTransfer(u8x8_t *u8x8);
 uint8_t u8x8_byte_EndTransfer(u8x8_t *u8x8);
+uint8_t u8x8_byte_SendSegments(u8x8_t *u8x8, uint8_t cnt, u8x8_segment_t *seg);
 
 uint8_t u8x8_byte_empty(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_byte_4wire_sw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
@@ -1144,6 +1227,14 @@ uint8_t u8x8_UserInterfaceSelectionList(u8x8_t *u8x8, const char *title, uint8_t
 /* u8x8_message.c  */
 uint8_t u8x8_UserInterfaceMessage(u8x8_t *u8x8, const char *title1, const char *title2, const char *title3, const char *buttons);
 
+/*==========================================*/
+/* u8x8_transpose.c */
+
+/* bit k of src[q] becomes bit q of dest[k], converts a tile into 8 pixel rows and vice versa */
+void u8x8_transpose_8x8(const uint8_t *src, uint8_t *dest);
+/* cnt tiles into 8 pixel rows with cnt bytes each (lsb is the left pixel), row r at rows + r*stride */
+void u8x8_transpose_tiles(const uint8_t *tiles, uint16_t cnt, uint8_t *rows, uint16_t stride);
+
 /*==========================================*/
 /* u8x8_capture.c */
 
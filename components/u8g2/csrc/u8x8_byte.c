@@ -61,6 +61,39 @@ uint8_t u8x8_byte_EndTransfer(u8x8_t *u8x8)
   return u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_END_TRANSFER, 0, NULL);
 }
 
+/*
+  send a list of (dc, ptr, len) segments with one call to the byte procedure.
+  byte procedures without U8X8_MSG_BYTE_SEND_SEGMENTS return 0, in this case
+  the segments are sent with U8X8_MSG_BYTE_SET_DC and U8X8_MSG_BYTE_SEND 
+  (at most 255 bytes per message)
+*/
+uint8_t u8x8_byte_SendSegments(u8x8_t *u8x8, uint8_t cnt, u8x8_segment_t *seg)
+{
+  uint16_t len;
+  uint8_t *ptr;
+  uint8_t n;
+  
+  if ( u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_SEND_SEGMENTS, cnt, (void *)seg) != 0 )
+    return 1;
+  
+  while( cnt > 0 )
+  {
+    u8x8_byte_SetDC(u8x8, seg->dc);
+    ptr = seg->ptr;
+    len = seg->len;
+    while( len > 0 )
+    {
+      n = len > 255 ? 255 : len;
+      u8x8_byte_SendBytes(u8x8, n, ptr);
+      ptr += n;
+      len -= n;
+    }
+    seg++;
+    cnt--;
+  }
+  return 1;
+}
+
 /*=========================================*/
 
 uint8_t u8x8_byte_empty(U8X8_UNUSED u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_t arg_int, U8X8_UNUSED void *arg_ptr)
@@ -99,40 +132,56 @@ uint8_t u8x8_byte_empty(U8X8_UNUSED u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8
   Handles:
     U8X8_MSG_BYTE_INIT
     U8X8_MSG_BYTE_SEND
+    U8X8_MSG_BYTE_SEND_SEGMENTS
     U8X8_MSG_BYTE_SET_DC
     U8X8_MSG_BYTE_START_TRANSFER
     U8X8_MSG_BYTE_END_TRANSFER
 */
 
-uint8_t u8x8_byte_4wire_sw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+static void u8x8_byte_4wire_sw_spi_send(u8x8_t *u8x8, uint16_t cnt, uint8_t *data)
 {
   uint8_t i, b;
-  uint8_t *data;
   uint8_t takeover_edge = u8x8_GetSPIClockPhase(u8x8);
   uint8_t not_takeover_edge = 1 - takeover_edge;
+  
+  while( cnt > 0 )
+  {
+    b = *data;
+    data++;
+    cnt--;
+    for( i = 0; i < 8; i++ )
+    {
+      if ( b & 128 )
+	u8x8_gpio_SetSPIData(u8x8, 1);
+      else
+	u8x8_gpio_SetSPIData(u8x8, 0);
+      b <<= 1;
+      
+      u8x8_gpio_SetSPIClock(u8x8, not_takeover_edge);
+      u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->sda_setup_time_ns);
+      u8x8_gpio_SetSPIClock(u8x8, takeover_edge);
+      u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->sck_pulse_width_ns);
+    }    
+  }
+}
+
+uint8_t u8x8_byte_4wire_sw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_segment_t *seg;
  
   switch(msg)
   {
     case U8X8_MSG_BYTE_SEND:
-      data = (uint8_t *)arg_ptr;
+      u8x8_byte_4wire_sw_spi_send(u8x8, arg_int, (uint8_t *)arg_ptr);
+      break;
+    case U8X8_MSG_BYTE_SEND_SEGMENTS:
+      seg = (u8x8_segment_t *)arg_ptr;
       while( arg_int > 0 )
       {
-	b = *data;
-	data++;
+	u8x8_gpio_SetDC(u8x8, seg->dc);
+	u8x8_byte_4wire_sw_spi_send(u8x8, seg->len, seg->ptr);
+	seg++;
 	arg_int--;
-	for( i = 0; i < 8; i++ )
-	{
-	  if ( b & 128 )
-	    u8x8_gpio_SetSPIData(u8x8, 1);
-	  else
-	    u8x8_gpio_SetSPIData(u8x8, 0);
-	  b <<= 1;
-	  
-	  u8x8_gpio_SetSPIClock(u8x8, not_takeover_edge);
-	  u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->sda_setup_time_ns);
-	  u8x8_gpio_SetSPIClock(u8x8, takeover_edge);
-	  u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->sck_pulse_width_ns);
-	}    
       }
       break;
       
@@ -578,6 +627,8 @@ static void i2c_write_byte(u8x8_t *u8x8, uint8_t b)
 uint8_t u8x8_byte_sw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   uint8_t *data;
+  u8x8_segment_t *seg;
+  uint16_t len;
 
   switch(msg)
   {
@@ -592,6 +643,21 @@ uint8_t u8x8_byte_sw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_p
       }
       
       break;
+    case U8X8_MSG_BYTE_SEND_SEGMENTS:
+      /* dc is ignored for i2c */
+      seg = (u8x8_segment_t *)arg_ptr;
+      while( arg_int > 0 )
+      {
+	data = seg->ptr;
+	for( len = seg->len; len > 0; len-- )
+	{
+	  i2c_write_byte(u8x8, *data);
+	  data++;
+	}
+	seg++;
+	arg_int--;
+      }
+      break;
       
     case U8X8_MSG_BYTE_INIT:
       i2c_init(u8x8);
@@ -184,6 +184,7 @@ void u8x8_cad_SendSequence(u8x8_t *u8x8, uint8_t const *data)
 	  break;
       case 0x0fe:
 	  v = *data;
+	  u8x8_cad_Flush(u8x8);	/* the commands before the delay must reach the display first */
 	  u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_MILLI, v);	    
 	  data++;
 	  break;
@@ -653,6 +654,111 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
 
 
 
+/* 
+  stream version of the fast ssd13xx i2c cad: 
+  One cad transfer becomes one i2c transfer. Commands and args are collected 
+  with the continuation bit (control byte 0x80 before each byte), the first data 
+  starts the data stream (control byte 0x40). Data is not split into 24 byte blocks. 
+  The collected commands and the data are passed to the byte procedure with 
+  U8X8_MSG_BYTE_SEND_SEGMENTS. A command after data starts a new i2c transfer.
+  This requires a byte procedure, which can handle long transfers 
+  (e.g. 1037 bytes for a 128x64 frame).
+  A delay within a transfer (U8X8_DLY in a sequence) sends U8X8_MSG_CAD_FLUSH: 
+  the collected commands are sent and the i2c transfer is closed before the 
+  delay, the following commands start a new i2c transfer.
+  END_TRANSFER and FLUSH return 0, if the byte procedure could not send the 
+  i2c transfer.
+*/
+#define U8X8_CAD_STREAM_BUF_SIZE 32
+static uint8_t u8x8_cad_stream_buf[U8X8_CAD_STREAM_BUF_SIZE];	/* 0x80/cmd pairs and the final 0x40 */
+static uint8_t u8x8_cad_stream_len;
+static uint8_t u8x8_cad_stream_is_open;
+
+static void u8x8_cad_stream_flush(u8x8_t *u8x8, uint8_t cnt, uint8_t *data)
+{
+  u8x8_segment_t seg[2];
+  uint8_t n = 0;
+  
+  if ( u8x8_cad_stream_len > 0 )
+  {
+    seg[n].ptr = u8x8_cad_stream_buf;
+    seg[n].len = u8x8_cad_stream_len;
+    seg[n].dc = 0;
+    n++;
+  }
+  if ( cnt > 0 )
+  {
+    seg[n].ptr = data;
+    seg[n].len = cnt;
+    seg[n].dc = 1;
+    n++;
+  }
+  if ( n == 0 )
+    return;
+  if ( u8x8_cad_stream_is_open == 0 )
+  {
+    u8x8_byte_StartTransfer(u8x8);
+    u8x8_cad_stream_is_open = 1;
+  }
+  u8x8_byte_SendSegments(u8x8, n, seg);
+  u8x8_cad_stream_len = 0;
+}
+
+uint8_t u8x8_cad_ssd13xx_stream_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  static uint8_t in_data = 0;
+  switch(msg)
+  {
+    case U8X8_MSG_CAD_SEND_CMD:
+    case U8X8_MSG_CAD_SEND_ARG:
+      if ( in_data != 0 )
+      {
+	/* the data stream can not be terminated, start a new i2c transfer */
+	u8x8_byte_EndTransfer(u8x8); 
+	u8x8_cad_stream_is_open = 0;
+	in_data = 0;
+      }
+      if ( u8x8_cad_stream_len + 3 > U8X8_CAD_STREAM_BUF_SIZE )
+	u8x8_cad_stream_flush(u8x8, 0, NULL);
+      u8x8_cad_stream_buf[u8x8_cad_stream_len++] = 0x080;	/* Co=1, D/C=0: one command byte */
+      u8x8_cad_stream_buf[u8x8_cad_stream_len++] = arg_int;
+      break;
+    case U8X8_MSG_CAD_SEND_DATA:
+      if ( in_data == 0 )
+      {
+	u8x8_cad_stream_buf[u8x8_cad_stream_len++] = 0x040;	/* Co=0, D/C=1: data until end of transfer */
+	in_data = 1;
+      }
+      u8x8_cad_stream_flush(u8x8, arg_int, (uint8_t *)arg_ptr);
+      break;
+    case U8X8_MSG_CAD_INIT:
+      /* apply default i2c adr if required so that the start transfer msg can use this */
+      if ( u8x8->i2c_address == 255 )
+	u8x8->i2c_address = 0x078;
+      return u8x8->byte_cb(u8x8, msg, arg_int, arg_ptr);
+    case U8X8_MSG_CAD_START_TRANSFER:
+      u8x8_cad_stream_len = 0;
+      u8x8_cad_stream_is_open = 0;
+      in_data = 0;
+      break;
+    case U8X8_MSG_CAD_END_TRANSFER:
+    case U8X8_MSG_CAD_FLUSH:
+      /* for FLUSH the cad transfer continues, the next command or data opens a new i2c transfer */
+      u8x8_cad_stream_flush(u8x8, 0, NULL);
+      in_data = 0;
+      if ( u8x8_cad_stream_is_open != 0 )
+      {
+	u8x8_cad_stream_is_open = 0;
+	return u8x8_byte_EndTransfer(u8x8); 
+      }
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+
 /* the st75256 i2c driver is a copy of the ssd13xx driver, but with arg=1 */
 /* modified from cad001 (ssd13xx) to cad011 */
 uint8_t u8x8_cad_st75256_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
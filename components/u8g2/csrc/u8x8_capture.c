@@ -72,6 +72,56 @@ uint8_t u8x8_capture_get_pixel_2(uint16_t x, uint16_t y, uint8_t *dest_ptr, uint
   return 1;
 }
 
+/*
+  Fast path for u8x8_capture_get_pixel_1 and u8x8_capture_get_pixel_2:
+  the pixel rows are collected as horizontal bytes (lsb is the left pixel)
+  in chunks of U8X8_CAPTURE_CHUNK bytes.
+*/
+#define U8X8_CAPTURE_CHUNK 16
+
+/*
+  Return cnt horizontal bytes of pixel row y, starting with tile tx.
+  rows[] must have 8*U8X8_CAPTURE_CHUNK bytes. For get_pixel_1, it keeps the
+  transposed tile row, if a pixel row fits into one chunk, so the tiles
+  are transposed only at the first pixel row of each tile row.
+*/
+static const uint8_t *u8x8_capture_get_line(uint8_t *buffer, uint8_t tile_width, uint16_t y, uint8_t tx, uint8_t cnt, uint8_t is_horizontal, uint8_t *rows)
+{
+  uint8_t *line;
+  uint8_t i, v;
+  
+  if ( is_horizontal == 0 )
+  {
+    if ( (y & 7) == 0 || tile_width > U8X8_CAPTURE_CHUNK )
+      u8x8_transpose_tiles(buffer + ((uint32_t)(y >> 3)*tile_width + tx)*8, cnt, rows, U8X8_CAPTURE_CHUNK);
+    return rows + (y & 7)*U8X8_CAPTURE_CHUNK;
+  }
+  
+  /* horizontal right lsb: msb is the left pixel, reverse the bits */
+  line = buffer + (uint32_t)y*tile_width + tx;
+  for( i = 0; i < cnt; i++ )
+  {
+    v = line[i];
+    v = (v >> 4) | (v << 4);
+    v = ((v & 0xcc) >> 2) | ((v & 0x33) << 2);
+    v = ((v & 0xaa) >> 1) | ((v & 0x55) << 1);
+    rows[i] = v;
+  }
+  return rows;
+}
+
+static uint8_t u8x8_capture_is_fast(uint8_t (*get_pixel)(uint16_t x, uint16_t y, uint8_t *dest_ptr, uint8_t tile_width))
+{
+  return get_pixel == u8x8_capture_get_pixel_1 || get_pixel == u8x8_capture_get_pixel_2;
+}
+
+static char u8x8_capture_hex(uint8_t v)
+{
+  if ( v <= 9 )
+    return '0' + v;
+  return 'a' - 10 + v;
+}
+
 void u8x8_capture_write_pbm_pre(uint8_t tile_width, uint8_t tile_height, void (*out)(const char *s))
 {
   out("P1\n");
@@ -91,10 +141,38 @@ void u8x8_capture_write_pbm_buffer(uint8_t *buffer, uint8_t tile_width, uint8_t
   w *= 8;
   h = tile_height;
   h *= 8;
+  
+  if ( u8x8_capture_is_fast(get_pixel) )
+  {
+    uint8_t rows[8*U8X8_CAPTURE_CHUNK];
+    char s[8*U8X8_CAPTURE_CHUNK+1];
+    const uint8_t *line;
+    uint8_t tx, cnt, i, b;
+    char *p;
     
-  for( y = 0; y < h; y++)
+    for( y = 0; y < h; y++ )
+    {
+      for( tx = 0; tx < tile_width; tx += cnt )
+      {
+	cnt = tile_width - tx;
+	if ( cnt > U8X8_CAPTURE_CHUNK )
+	  cnt = U8X8_CAPTURE_CHUNK;
+	line = u8x8_capture_get_line(buffer, tile_width, y, tx, cnt, get_pixel == u8x8_capture_get_pixel_2, rows);
+	p = s;
+	for( i = 0; i < cnt; i++ )
+	  for( b = 0; b < 8; b++ )
+	    *p++ = '0' + ((line[i] >> b) & 1);
+	*p = '\0';
+	out(s);
+      }
+      out("\n");
+    }
+    return;
+  }
+    
+  for( y = 0; y < h; y++ )
   {
-    for( x = 0; x < w; x++)
+    for( x = 0; x < w; x++ )
     {
       if ( get_pixel(x, y, buffer, tile_width) )
 	out("1");
@@ -132,6 +210,42 @@ void u8x8_capture_write_xbm_buffer(uint8_t *buffer, uint8_t tile_width, uint8_t
   h = tile_height;
   h *= 8;
 
+  if ( u8x8_capture_is_fast(get_pixel) )
+  {
+    uint8_t rows[8*U8X8_CAPTURE_CHUNK];
+    char t[5*U8X8_CAPTURE_CHUNK+1];	/* "0xhh," for each byte */
+    const uint8_t *line;
+    uint8_t tx, cnt, i;
+    char *p;
+    
+    for( y = 0; y < h; y++ )
+    {
+      for( tx = 0; tx < tile_width; tx += cnt )
+      {
+	cnt = tile_width - tx;
+	if ( cnt > U8X8_CAPTURE_CHUNK )
+	  cnt = U8X8_CAPTURE_CHUNK;
+	line = u8x8_capture_get_line(buffer, tile_width, y, tx, cnt, get_pixel == u8x8_capture_get_pixel_2, rows);
+	p = t;
+	for( i = 0; i < cnt; i++ )
+	{
+	  *p++ = '0';
+	  *p++ = 'x';
+	  *p++ = u8x8_capture_hex(line[i] >> 4);
+	  *p++ = u8x8_capture_hex(line[i] & 15);
+	  if ( tx + i + 1 < tile_width )
+	    *p++ = ',';
+	}
+	*p = '\0';
+	out(t);
+      }
+      if ( y + 1 < h )
+	out(",\n");
+    }
+    out("};\n");
+    return;
+  }
+
   y = 0;
   for(;;)
   {
@@ -146,17 +260,9 @@ void u8x8_capture_write_xbm_buffer(uint8_t *buffer, uint8_t tile_width, uint8_t
 	  v |= 1;
       }
       out("0x");
-      s[0] = (v>>4);
-      if ( s[0] <= 9 )
-	s[0] += '0';
-      else
-	s[0] += 'a'-10;
+      s[0] = u8x8_capture_hex(v>>4);
       out(s);
-      s[0] = (v&15);
-      if ( s[0] <= 9 )
-	s[0] += '0';
-      else
-	s[0] += 'a'-10;
+      s[0] = u8x8_capture_hex(v&15);
       out(s);
       x += 8;
       if ( x >= w )
@@ -229,6 +335,25 @@ uint8_t u8x8_d_capture(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr
       arg_int--;
     } while( arg_int > 0 );
   }
+  else if ( msg == U8X8_MSG_DISPLAY_DRAW_AREA )
+  {
+    /* capture only the display areas, which are accepted by the display */
+    if ( u8x8_capture.old_cb(u8x8, msg, arg_int, arg_ptr) == 0 )
+      return 0;
+    {
+      u8x8_tile_t *tile = (u8x8_tile_t *)arg_ptr;
+      uint8_t y = tile->y_pos;
+      uint8_t *ptr = tile->tile_ptr;
+      do
+      {
+	u8x8_capture_DrawTiles(&u8x8_capture, tile->x_pos, y, tile->cnt, ptr);
+	ptr += (uint16_t)u8x8->display_info->tile_width*8;
+	y++;
+	arg_int--;
+      } while( arg_int > 0 );
+    }
+    return 1;
+  }
   return u8x8_capture.old_cb(u8x8, msg, arg_int, arg_ptr);
 }
 
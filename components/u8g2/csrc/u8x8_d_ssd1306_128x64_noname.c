@@ -331,6 +331,57 @@ static uint8_t u8x8_d_ssd1306_sh1106_generic(u8x8_t *u8x8, uint8_t msg, uint8_t
   return 1;
 }
 
+/*
+  U8X8_MSG_DISPLAY_DRAW_AREA for the SSD1306 (not SH1106): 
+  The init sequence selects horizontal addressing mode, so after setting the
+  column (0x21) and page (0x22) address range, all tile rows are written with 
+  one data transfer. Together with u8x8_cad_ssd13xx_stream_i2c a full frame is 
+  sent as one i2c transaction.
+  The column/page range is restored to the full display afterwards, because
+  U8X8_MSG_DISPLAY_DRAW_TILE only sets the start address.
+*/
+static uint8_t u8x8_d_ssd1306_draw_area(u8x8_t *u8x8, uint8_t arg_int, void *arg_ptr)
+{
+  uint8_t x, c, rows;
+  uint8_t *ptr;
+  uint16_t row_size;
+  
+  x = ((u8x8_tile_t *)arg_ptr)->x_pos;    
+  x *= 8;
+  x += u8x8->x_offset;
+  c = ((u8x8_tile_t *)arg_ptr)->cnt;
+  ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
+  row_size = u8x8->display_info->tile_width;
+  row_size *= 8;
+  
+  u8x8_cad_StartTransfer(u8x8);
+  u8x8_cad_SendCmd(u8x8, 0x021 );	/* column address range */
+  u8x8_cad_SendArg(u8x8, x );
+  u8x8_cad_SendArg(u8x8, x + c*8 - 1 );
+  u8x8_cad_SendCmd(u8x8, 0x022 );	/* page address range */
+  u8x8_cad_SendArg(u8x8, ((u8x8_tile_t *)arg_ptr)->y_pos );
+  u8x8_cad_SendArg(u8x8, ((u8x8_tile_t *)arg_ptr)->y_pos + arg_int - 1 );
+  
+  rows = arg_int;
+  do
+  {
+    u8x8_cad_SendData(u8x8, c*8, ptr); 	/* note: SendData can not handle more than 255 bytes */
+    ptr += row_size;
+    rows--;
+  } while( rows > 0 );
+  
+  if ( x != 0 || c != u8x8->display_info->tile_width || ((u8x8_tile_t *)arg_ptr)->y_pos != 0 || arg_int != u8x8->display_info->tile_height )
+  {
+    u8x8_cad_SendCmd(u8x8, 0x021 );
+    u8x8_cad_SendArg(u8x8, 0 );
+    u8x8_cad_SendArg(u8x8, u8x8->display_info->pixel_width - 1 );
+    u8x8_cad_SendCmd(u8x8, 0x022 );
+    u8x8_cad_SendArg(u8x8, 0 );
+    u8x8_cad_SendArg(u8x8, u8x8->display_info->tile_height - 1 );
+  }
+  u8x8_cad_EndTransfer(u8x8);
+  return 1;
+}
 
 static const u8x8_display_info_t u8x8_ssd1306_128x64_noname_display_info =
 {
@@ -371,6 +422,8 @@ uint8_t u8x8_d_ssd1306_128x64_noname(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
+    case U8X8_MSG_DISPLAY_DRAW_AREA:
+      return u8x8_d_ssd1306_draw_area(u8x8, arg_int, arg_ptr);
     default:
       return 0;
   }
@@ -401,8 +454,7 @@ uint8_t u8x8_d_ssd1312_128x64_noname(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
     default:
-      if ( u8x8_d_ssd1306_sh1106_generic(u8x8, msg, arg_int, arg_ptr) != 0 )
-        return 1;
+      return u8x8_d_ssd1306_sh1106_generic(u8x8, msg, arg_int, arg_ptr);
   }
   return 1;
 }
@@ -424,6 +476,8 @@ uint8_t u8x8_d_ssd1306_128x64_vcomh0(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
+    case U8X8_MSG_DISPLAY_DRAW_AREA:
+      return u8x8_d_ssd1306_draw_area(u8x8, arg_int, arg_ptr);
     default:
       return 0;
   }
@@ -445,6 +499,8 @@ uint8_t u8x8_d_ssd1306_128x64_alt0(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, v
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
+    case U8X8_MSG_DISPLAY_DRAW_AREA:
+      return u8x8_d_ssd1306_draw_area(u8x8, arg_int, arg_ptr);
     default:
       return 0;
   }
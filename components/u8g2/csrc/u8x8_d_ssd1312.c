@@ -227,8 +227,7 @@ uint8_t u8x8_d_ssd1312_128x32(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1312_128x32_display_info);
       break;
     default:
-      if ( u8x8_d_ssd1312_generic(u8x8, msg, arg_int, arg_ptr) != 0 )
-        return 1;
+      return u8x8_d_ssd1312_generic(u8x8, msg, arg_int, arg_ptr);
   }
   return 1;
 }
@@ -285,8 +284,7 @@ uint8_t u8x8_d_ssd1312_120x32(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1312_120x32_display_info);
       break;
     default:
-      if ( u8x8_d_ssd1312_generic(u8x8, msg, arg_int, arg_ptr) != 0 )
-        return 1;
+      return u8x8_d_ssd1312_generic(u8x8, msg, arg_int, arg_ptr);
   }
   return 1;
 }
@@ -346,8 +344,7 @@ uint8_t u8x8_d_ssd1312_120x28(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1312_120x28_display_info);
       break;
     default:
-      if ( u8x8_d_ssd1312_generic(u8x8, msg, arg_int, arg_ptr) != 0 )
-        return 1;
+      return u8x8_d_ssd1312_generic(u8x8, msg, arg_int, arg_ptr);
   }
   return 1;
 }
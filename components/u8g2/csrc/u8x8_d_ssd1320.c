@@ -716,7 +716,7 @@ uint8_t u8x8_d_ssd1320_160x80(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
       break;
     
     default:
-      break;
+      return 0;
   }
   return 1;
 }
@@ -882,7 +882,7 @@ uint8_t u8x8_d_ssd1320_128x72(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
       break;
     
     default:
-      break;
+      return 0;
   }
   return 1;
 }
@@ -39,6 +39,7 @@
 
 
 #include "u8x8.h"
+#include <string.h>
 
 
 /*==========================================*/
@@ -76,6 +77,151 @@ void u8x8_d_helper_display_init(u8x8_t *u8x8)
       u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_MILLI, u8x8->display_info->post_reset_wait_ms);
 }    
 
+/*==========================================*/
+/* shadow RAM */
+
+#ifdef U8X8_WITH_SHADOW_RAM
+
+/* the valid flags of the tile rows are located after the tiles */
+static uint8_t *u8x8_shadow_valid_flags(u8x8_t *u8x8)
+{
+  uint16_t offset;
+  offset = u8x8->display_info->tile_width;
+  offset *= u8x8->display_info->tile_height;
+  offset *= 8;
+  return u8x8->shadow_ram + offset;
+}
+
+static uint8_t *u8x8_shadow_tile(u8x8_t *u8x8, uint8_t x, uint8_t y)
+{
+  uint16_t offset;
+  offset = y;
+  offset *= u8x8->display_info->tile_width;
+  offset += x;
+  offset *= 8;
+  return u8x8->shadow_ram + offset;
+}
+
+/*
+  Compare the tiles with the shadow RAM and send only the changed tiles.
+  Adjacent changed tiles are sent with one DRAW_TILE message.
+*/
+static uint8_t u8x8_draw_tile_shadow(u8x8_t *u8x8, u8x8_tile_t *tile)
+{
+  u8x8_tile_t run;
+  uint8_t *shadow;
+  uint8_t *src;
+  uint8_t is_valid;
+  uint8_t i;
+  
+  shadow = u8x8_shadow_tile(u8x8, tile->x_pos, tile->y_pos);
+  src = tile->tile_ptr;
+  is_valid = u8x8_shadow_valid_flags(u8x8)[tile->y_pos];
+  run.y_pos = tile->y_pos;
+  i = 0;
+  while( i < tile->cnt )
+  {
+    /* skip unchanged tiles */
+    if ( is_valid != 0 && memcmp(shadow, src, 8) == 0 )
+    {
+      shadow += 8;
+      src += 8;
+      i++;
+      continue;
+    }
+    
+    /* collect changed tiles */
+    run.x_pos = tile->x_pos + i;
+    run.tile_ptr = src;
+    run.cnt = 0;
+    do
+    {
+      memcpy(shadow, src, 8);
+      shadow += 8;
+      src += 8;
+      run.cnt++;
+      i++;
+    } while( i < tile->cnt && ( is_valid == 0 || memcmp(shadow, src, 8) != 0 ) );
+    
+    if ( u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, 1, (void *)&run) == 0 )
+    {
+      /* the copy already contains the new tiles, which did not reach the display */
+      u8x8_shadow_valid_flags(u8x8)[tile->y_pos] = 0;
+      return 0;
+    }
+  }
+  /* the tile row is only valid, if it was completely transfered */
+  if ( tile->x_pos == 0 && tile->cnt == u8x8->display_info->tile_width )
+    u8x8_shadow_valid_flags(u8x8)[tile->y_pos] = 1;
+  return 1;
+}
+
+/* number of tiles in the tile row, which differ from the shadow RAM, all tiles of an invalid row differ */
+static uint8_t u8x8_shadow_changed_tiles(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, const uint8_t *src)
+{
+  const uint8_t *shadow;
+  uint8_t changed;
+  
+  if ( u8x8_shadow_valid_flags(u8x8)[y] == 0 )
+    return cnt;
+  shadow = u8x8_shadow_tile(u8x8, x, y);
+  changed = 0;
+  while( cnt > 0 )
+  {
+    if ( memcmp(shadow, src, 8) != 0 )
+      changed++;
+    shadow += 8;
+    src += 8;
+    cnt--;
+  }
+  return changed;
+}
+
+/* a tile row has been transfered to the display */
+static void u8x8_shadow_copy_row(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, const uint8_t *src)
+{
+  memcpy(u8x8_shadow_tile(u8x8, x, y), src, (uint16_t)cnt*8);
+  if ( x == 0 && cnt == u8x8->display_info->tile_width )
+    u8x8_shadow_valid_flags(u8x8)[y] = 1;
+}
+
+/* a tile row has been filled with the same tile */
+static void u8x8_shadow_fill_row(u8x8_t *u8x8, uint8_t y, const uint8_t *buf)
+{
+  uint8_t *shadow;
+  uint8_t x;
+  
+  if ( u8x8->shadow_ram == NULL )
+    return;
+  shadow = u8x8_shadow_tile(u8x8, 0, y);
+  for( x = 0; x < u8x8->display_info->tile_width; x++ )
+  {
+    memcpy(shadow, buf, 8);
+    shadow += 8;
+  }
+  u8x8_shadow_valid_flags(u8x8)[y] = 1;
+}
+
+/*
+  buf must have u8x8_GetShadowRAMSize(u8x8) bytes, NULL disables the shadow RAM.
+  Must be called after the display setup (u8x8_Setup or u8g2_Setup_xxx).
+*/
+void u8x8_SetShadowRAM(u8x8_t *u8x8, uint8_t *buf)
+{
+  u8x8->shadow_ram = buf;
+  u8x8_InvalidateShadowRAM(u8x8);
+}
+
+void u8x8_InvalidateShadowRAM(u8x8_t *u8x8)
+{
+  if ( u8x8->shadow_ram == NULL )
+    return;
+  memset(u8x8_shadow_valid_flags(u8x8), 0, u8x8->display_info->tile_height);
+}
+
+#endif /* U8X8_WITH_SHADOW_RAM */
+
+
 /*==========================================*/
 /* official functions */
 
@@ -86,9 +232,122 @@ uint8_t u8x8_DrawTile(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t *
   tile.y_pos = y;
   tile.cnt = cnt;
   tile.tile_ptr = tile_ptr;
+#ifdef U8X8_WITH_SHADOW_RAM
+  /* tiles outside of the display are passed to the driver unchanged */
+  if ( u8x8->shadow_ram != NULL && y < u8x8->display_info->tile_height && (uint16_t)x + cnt <= u8x8->display_info->tile_width )
+    return u8x8_draw_tile_shadow(u8x8, &tile);
+#endif
   return u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, 1, (void *)&tile);
 }
 
+/* 
+  Send the area without shadow RAM: one DRAW_AREA message, if the driver supports it, 
+  otherwise one DRAW_TILE message for each tile row.
+*/
+static uint8_t u8x8_draw_area_direct(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t rows, uint8_t *tile_ptr)
+{
+  u8x8_tile_t tile;
+  uint16_t row_size;
+  
+  tile.x_pos = x;
+  tile.y_pos = y;
+  tile.cnt = cnt;
+  tile.tile_ptr = tile_ptr;
+  if ( u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_AREA, rows, (void *)&tile) != 0 )
+    return 1;
+  
+  row_size = u8x8->display_info->tile_width;
+  row_size *= 8;
+  do
+  {
+    if ( u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, 1, (void *)&tile) == 0 )
+      return 0;
+    tile.tile_ptr += row_size;
+    tile.y_pos++;
+    rows--;
+  } while( rows > 0 );
+  return 1;
+}
+
+/*
+  Draw "rows" tile rows with "cnt" tiles each, tile rows are 8*tile_width bytes apart.
+  Drivers, which support U8X8_MSG_DISPLAY_DRAW_AREA, transfer the area in one burst,
+  otherwise each tile row is drawn with U8X8_MSG_DISPLAY_DRAW_TILE.
+  With shadow RAM, unchanged rows are skipped and rows with some changed tiles only 
+  send the changed tiles. Adjacent rows, which are invalid or where all tiles 
+  have changed (e.g. the first frame after u8x8_InitDisplay), are still sent as 
+  one burst.
+*/
+uint8_t u8x8_DrawTileArea(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t rows, uint8_t *tile_ptr)
+{
+#ifdef U8X8_WITH_SHADOW_RAM
+  u8x8_tile_t tile;
+  uint16_t row_size;
+  uint8_t *ptr;
+  uint8_t n;
+#endif
+  
+  if ( rows == 0 || cnt == 0 )
+    return 1;
+#ifdef U8X8_WITH_SHADOW_RAM
+  /* areas outside of the display are passed to the driver unchanged */
+  if ( u8x8->shadow_ram != NULL && (uint16_t)y + rows <= u8x8->display_info->tile_height && (uint16_t)x + cnt <= u8x8->display_info->tile_width )
+  {
+    row_size = u8x8->display_info->tile_width;
+    row_size *= 8;
+    while( rows > 0 )
+    {
+      /* collect the completely changed rows */
+      n = 0;
+      ptr = tile_ptr;
+      while( n < rows && u8x8_shadow_changed_tiles(u8x8, x, y+n, cnt, ptr) == cnt )
+      {
+	ptr += row_size;
+	n++;
+      }
+      
+      if ( n > 0 )
+      {
+	if ( u8x8_draw_area_direct(u8x8, x, y, cnt, n, tile_ptr) == 0 )
+	{
+	  /* unknown how far the transfer went */
+	  do
+	  {
+	    u8x8_shadow_valid_flags(u8x8)[y] = 0;
+	    y++;
+	    n--;
+	  } while( n > 0 );
+	  return 0;
+	}
+	do
+	{
+	  u8x8_shadow_copy_row(u8x8, x, y, cnt, tile_ptr);
+	  tile_ptr += row_size;
+	  y++;
+	  rows--;
+	  n--;
+	} while( n > 0 );
+      }
+      else
+      {
+	/* some tiles of this row have changed (or none) */
+	tile.x_pos = x;
+	tile.y_pos = y;
+	tile.cnt = cnt;
+	tile.tile_ptr = tile_ptr;
+	if ( u8x8_draw_tile_shadow(u8x8, &tile) == 0 )
+	  return 0;
+	tile_ptr += row_size;
+	y++;
+	rows--;
+      }
+    }
+    return 1;
+  }
+#endif
+  return u8x8_draw_area_direct(u8x8, x, y, cnt, rows, tile_ptr);
+}
+
 /* should be implemented as macro */
 void u8x8_SetupMemory(u8x8_t *u8x8)
 {
@@ -135,6 +394,9 @@ void u8x8_InitInterface(u8x8_t *u8x8)
 void u8x8_InitDisplay(u8x8_t *u8x8)
 {
   u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_INIT, 0, NULL);       /* this will call u8x8_d_helper_display_init() and send the init seqence to the display */
+#ifdef U8X8_WITH_SHADOW_RAM
+  u8x8_InvalidateShadowRAM(u8x8);	/* the content of the display RAM is unknown after reset */
+#endif
   /* u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_SET_FLIP_MODE, 0, NULL);  */ /* It would make sense to call flip mode 0 here after U8X8_MSG_DISPLAY_INIT */
 }
 
@@ -146,6 +408,9 @@ void u8x8_SetPowerSave(u8x8_t *u8x8, uint8_t is_enable)
 void u8x8_SetFlipMode(u8x8_t *u8x8, uint8_t mode)
 {
   u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_SET_FLIP_MODE, mode, NULL);  
+#ifdef U8X8_WITH_SHADOW_RAM
+  u8x8_InvalidateShadowRAM(u8x8);	/* the tiles must be sent again for the new orientation */
+#endif
 }
 
 void u8x8_SetContrast(u8x8_t *u8x8, uint8_t value)
@@ -172,6 +437,9 @@ void u8x8_ClearDisplayWithTile(u8x8_t *u8x8, const uint8_t *buf)
   do
   {
     u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, u8x8->display_info->tile_width, (void *)&tile);
+#ifdef U8X8_WITH_SHADOW_RAM
+    u8x8_shadow_fill_row(u8x8, tile.y_pos, buf);
+#endif
     tile.y_pos++;
   } while( tile.y_pos < h );
 }
@@ -199,5 +467,8 @@ void u8x8_ClearLine(u8x8_t *u8x8, uint8_t line)
     tile.cnt = 1;
     tile.tile_ptr = (uint8_t *)buf;		/* tile_ptr should be const, but isn't */
     u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, u8x8->display_info->tile_width, (void *)&tile);
+#ifdef U8X8_WITH_SHADOW_RAM
+    u8x8_shadow_fill_row(u8x8, line, buf);
+#endif
   }  
 }
\ No newline at end of file
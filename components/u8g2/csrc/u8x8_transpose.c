@@ -0,0 +1,111 @@
+/*
+
+  u8x8_transpose.c
+
+  Universal 8bit Graphics Library (https://github.com/olikraus/u8g2/)
+
+  8x8 bit matrix transpose: conversion between vertical tiles (one byte per
+  pixel column, lsb is the upper pixel) and horizontal pixel rows (one byte
+  per 8 pixel, lsb is the left pixel).
+
+  The transpose is its own inverse, so the same procedures convert in both
+  directions.
+
+  Variants:
+    - 64 bit shift/mask, if the target has 64 bit registers
+    - 32 bit shift/mask (two 32 bit halves) for 8, 16 and 32 bit targets
+    - SSE2 (movemask) for u8x8_transpose_tiles(), two tiles per step
+
+  There is intentionally no NEON variant: it could not be verified without
+  an ARM toolchain and hardware. ARM targets use the 32/64 bit shift/mask
+  versions above (the ESP32 target of this project is Xtensa, no SIMD is
+  used there either).
+
+*/
+
+#include "u8x8.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/*
+  Transpose a 8x8 bit matrix: bit k of src[q] becomes bit q of dest[k].
+  src and dest must not overlap.
+*/
+void u8x8_transpose_8x8(const uint8_t *src, uint8_t *dest)
+{
+#if defined(UINTPTR_MAX) && UINTPTR_MAX > 0xffffffffUL
+  uint64_t x, t;
+
+  x = src[0] | ((uint64_t)src[1] << 8) | ((uint64_t)src[2] << 16) | ((uint64_t)src[3] << 24)
+    | ((uint64_t)src[4] << 32) | ((uint64_t)src[5] << 40) | ((uint64_t)src[6] << 48) | ((uint64_t)src[7] << 56);
+
+  /* swap 1x1 blocks, then 2x2 blocks, then 4x4 blocks */
+  t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;  x ^= t ^ (t << 28);
+
+  dest[0] = x;  dest[1] = x >> 8;  dest[2] = x >> 16;  dest[3] = x >> 24;
+  dest[4] = x >> 32;  dest[5] = x >> 40;  dest[6] = x >> 48;  dest[7] = x >> 56;
+#else
+  uint32_t x, y, t;
+
+  x = src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+  y = src[4] | ((uint32_t)src[5] << 8) | ((uint32_t)src[6] << 16) | ((uint32_t)src[7] << 24);
+
+  /* swap 1x1 blocks, then 2x2 blocks inside each 4x4 block */
+  t = (x ^ (x >> 7)) & 0x00aa00aaUL;  x ^= t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00aa00aaUL;  y ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000ccccUL;  x ^= t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000ccccUL;  y ^= t ^ (t << 14);
+  /* swap the upper right and the lower left 4x4 block */
+  t = (x ^ (y << 4)) & 0xf0f0f0f0UL;
+  x ^= t;
+  y ^= t >> 4;
+
+  dest[0] = x;  dest[1] = x >> 8;  dest[2] = x >> 16;  dest[3] = x >> 24;
+  dest[4] = y;  dest[5] = y >> 8;  dest[6] = y >> 16;  dest[7] = y >> 24;
+#endif
+}
+
+/*
+  Convert cnt consecutive tiles (cnt*8 bytes, as sent with U8X8_MSG_DISPLAY_DRAW_TILE)
+  into 8 pixel rows with cnt bytes each. Row r starts at rows + r*stride,
+  byte t of a row contains the 8 pixel of tile t, lsb is the left pixel.
+*/
+void u8x8_transpose_tiles(const uint8_t *tiles, uint16_t cnt, uint8_t *rows, uint16_t stride)
+{
+  uint8_t tmp[8];
+  uint16_t t = 0;
+  uint8_t r;
+
+#if defined(__SSE2__)
+  /* 
+    _mm_movemask_epi8() collects the msb of the 16 bytes, which is row 7 of two tiles.
+    Adding each byte to itself moves the next row into the msb.
+  */
+  for( ; t+2 <= cnt; t += 2 )
+  {
+    __m128i v = _mm_loadu_si128((const __m128i *)(tiles + (uint32_t)t*8));
+    int m;
+    r = 8;
+    do
+    {
+      r--;
+      m = _mm_movemask_epi8(v);
+      rows[(uint32_t)r*stride + t] = (uint8_t)m;
+      rows[(uint32_t)r*stride + t + 1] = (uint8_t)(m >> 8);
+      v = _mm_add_epi8(v, v);
+    } while( r > 0 );
+  }
+#endif
+
+  for( ; t < cnt; t++ )
+  {
+    u8x8_transpose_8x8(tiles + (uint32_t)t*8, tmp);
+    for( r = 0; r < 8; r++ )
+      rows[(uint32_t)r*stride + t] = tmp[r];
+  }
+}
@@ -93,7 +93,16 @@ static void tga_write_word(FILE *fp, uint16_t word)
 void u8x8_bitmap_SaveTGA(u8x8_bitmap_t *b, const char *name)
 {
   FILE *fp;
-  uint16_t x, y;
+  uint16_t x, y, ty;
+  uint8_t r, c;
+  uint8_t *p;
+  uint8_t *rows;	/* one tile row as 8 pixel rows, lsb is the left pixel */
+  uint8_t *line;	/* one pixel row as BGR */
+  
+  rows = (uint8_t *)malloc((size_t)b->tile_width*8 + (size_t)b->pixel_width*3);
+  if ( rows == NULL )
+    return;
+  line = rows + (size_t)b->tile_width*8;
   
   fp = fopen(name, "wb");
   if ( fp != NULL )
@@ -110,22 +119,31 @@ void u8x8_bitmap_SaveTGA(u8x8_bitmap_t *b, const char *name)
     tga_write_word(fp, b->pixel_height);		/* height */
     tga_write_byte(fp, 24);		/* color depth */
     tga_write_byte(fp, 0);	
-    for( y = 0; y < b->pixel_height; y++ )
+    /* TGA starts with the lowest pixel row: transpose the tile rows from the bottom to the top */
+    ty = b->tile_height;
+    while( ty > 0 )
     {
-      for( x = 0; x < b->pixel_width; x++ )
+      ty--;
+      if ( b->u8x8_buf == NULL )
+	memset(rows, 0, (size_t)b->tile_width*8);
+      else
+	u8x8_transpose_tiles(b->u8x8_buf + (size_t)ty*b->pixel_width, b->tile_width, rows, b->tile_width);
+      r = 8;
+      while( r > 0 )
       {
-	if ( u8x8_bitmap_GetPixel(b, x, b->pixel_height-y-1) == 0 )
-	{
-	  tga_write_byte(fp, 255);		/* R */
-	  tga_write_byte(fp, 255);		/* G */
-	  tga_write_byte(fp, 255);		/* B */
-	}
-	else
+	r--;
+	y = ty*8 + r;
+	if ( y >= b->pixel_height )
+	  continue;
+	p = line;
+	for( x = 0; x < b->pixel_width; x++ )
 	{
-	  tga_write_byte(fp, 0);		/* R */
-	  tga_write_byte(fp, 0);		/* G */
-	  tga_write_byte(fp, 0);		/* B */
+	  c = ((rows[r*b->tile_width + x/8] >> (x&7)) & 1) ? 0 : 255;
+	  *p++ = c;		/* B */
+	  *p++ = c;		/* G */
+	  *p++ = c;		/* R */
 	}
+	fwrite(line, (size_t)b->pixel_width*3, 1, fp);
       }
     }
     tga_write_word(fp, 0);
@@ -135,6 +153,7 @@ void u8x8_bitmap_SaveTGA(u8x8_bitmap_t *b, const char *name)
     fwrite("TRUEVISION-XFILE.", 18, 1, fp);
     fclose(fp);
   }
+  free(rows);
 }
 
 
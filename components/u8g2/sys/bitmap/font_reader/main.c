@@ -0,0 +1,247 @@
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Font decoder bit reader: byte reader (default) and word reader (compiled
+ * with U8G2_WITH_FONT_WORD_READER).
+ * 20000 random frames are drawn: four fonts, all font directions, both font
+ * modes, all draw colors, random clip windows, every second frame through the
+ * glyph cache. The frame buffers and the string widths are combined into a
+ * hash, which must be the same for both readers.
+ * The decode time is measured with the glyph cache cleared before every
+ * string, so that each glyph is decoded into the cache bitmap.
+ *
+ * Usage: font_reader [--out FILE] [--baseline FILE]
+ *   --out       write the hash and the decode times
+ *   --baseline  compare with the output of the other reader, returns 1 if
+ *               the hash differs
+ */
+
+#ifdef U8G2_WITH_FONT_WORD_READER
+#define READER "word reader"
+#else
+#define READER "byte reader"
+#endif
+
+#define FRAMES 20000
+
+u8g2_t u8g2;
+
+uint8_t glyph_cache_arena[4096];
+u8g2_glyph_cache_t glyph_cache;
+
+struct font_test
+{
+  const char *name;
+  const uint8_t *font;
+  const char *text;		/* utf8 text with glyphs of the font */
+};
+
+struct font_test tests[] = {
+  { "6x10_tf", u8g2_font_6x10_tf, "VOUT 54.00V IOUT 60.00A Temp 41C" },
+  { "profont17_tf", u8g2_font_profont17_tf, "VOUT 54.00V IOUT 60.00A Temp 41C" },
+  { "10x20_t_greek", u8g2_font_10x20_t_greek, "Τάση εξόδου 54.00V ΑΒΓΔ αβγδ" },
+  { "10x20_t_cyrillic", u8g2_font_10x20_t_cyrillic, "Напряжение 54.00V АБВГ абвг" },
+};
+
+#define FONT_CNT (sizeof(tests)/sizeof(*tests))
+
+static uint32_t rnd_state;
+static uint32_t rnd(void)
+{
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return rnd_state >> 16;
+}
+
+static double now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec*1e9 + t.tv_nsec;
+}
+
+/* a part of the text of the font or random ascii characters */
+static void random_text(const struct font_test *t, char *s, size_t size)
+{
+  size_t len, start, i;
+  if ( rnd() % 2 )
+  {
+    len = strlen(t->text);
+    start = rnd() % len;
+    /* do not start inside of an utf8 sequence */
+    while ( start > 0 && (t->text[start] & 0xc0) == 0x80 )
+      start--;
+    snprintf(s, size, "%s", t->text + start);
+  }
+  else
+  {
+    len = 1 + rnd() % (size - 1);
+    for( i = 0; i < len; i++ )
+      s[i] = 32 + rnd() % 95;
+    s[len] = '\0';
+  }
+}
+
+static uint32_t frames_hash(long cnt)
+{
+  uint8_t *buf = u8g2_GetBufferPtr(&u8g2);
+  size_t len = 8*u8g2_GetBufferTileWidth(&u8g2)*u8g2_GetBufferTileHeight(&u8g2);
+  uint32_t hash = 0;
+  const struct font_test *t;
+  char s[40];
+  long frame;
+  size_t j;
+  int k, a, b;
+
+  for( frame = 0; frame < cnt; frame++ )
+  {
+    rnd_state = frame;
+    u8g2_SetGlyphCache(&u8g2, frame & 1 ? &glyph_cache : NULL);
+    u8g2_ClearGlyphCache(&glyph_cache);
+    memset(buf, rnd(), len);
+    for( k = 0; k < 8; k++ )
+    {
+      t = tests + rnd() % FONT_CNT;
+      u8g2_SetFont(&u8g2, t->font);
+      u8g2_SetFontDirection(&u8g2, rnd() % 4);
+      u8g2_SetFontMode(&u8g2, rnd() % 2);
+      u8g2_SetDrawColor(&u8g2, rnd() % 3);
+      if ( rnd() % 4 == 0 )
+      {
+        a = rnd() % 128;
+        b = rnd() % 64;
+        u8g2_SetClipWindow(&u8g2, a, b, a + 1 + rnd() % (128 - a), b + 1 + rnd() % (64 - b));
+      }
+      else
+      {
+        u8g2_SetMaxClipWindow(&u8g2);
+      }
+      random_text(t, s, sizeof(s));
+      hash = hash*31 + u8g2_GetUTF8Width(&u8g2, s);
+      u8g2_DrawUTF8(&u8g2, (int)(rnd() % 160) - 16, (int)(rnd() % 96) - 16, s);
+    }
+    for( j = 0; j < len; j++ )
+      hash = hash*31 + buf[j];
+  }
+  u8g2_SetGlyphCache(&u8g2, NULL);
+  u8g2_SetFontDirection(&u8g2, 0);
+  u8g2_SetFontMode(&u8g2, 0);
+  u8g2_SetDrawColor(&u8g2, 1);
+  u8g2_SetMaxClipWindow(&u8g2);
+  return hash;
+}
+
+/* ns per glyph, each glyph is decoded into the cache, best of 20 runs */
+static double decode_time(const struct font_test *t)
+{
+  const char *s = t->text;
+  double best = 1e18, start;
+  int glyphs = 0, run, i;
+
+  /* number of glyphs in the utf8 text */
+  for( i = 0; s[i] != '\0'; i++ )
+    if ( (s[i] & 0xc0) != 0x80 )
+      glyphs++;
+
+  u8g2_SetFont(&u8g2, t->font);
+  u8g2_SetGlyphCache(&u8g2, &glyph_cache);
+  for( run = 0; run < 20; run++ )
+  {
+    start = now_ns();
+    for( i = 0; i < 200; i++ )
+    {
+      u8g2_ClearGlyphCache(&glyph_cache);
+      u8g2_DrawUTF8(&u8g2, 0, 30, s);
+    }
+    start = (now_ns() - start) / (200.0 * glyphs);
+    if ( start < best )
+      best = start;
+  }
+  u8g2_SetGlyphCache(&u8g2, NULL);
+  return best;
+}
+
+int main(int argc, char **argv)
+{
+  const char *out_path = NULL;
+  const char *baseline_path = NULL;
+  FILE *fp;
+  char name[32];
+  double t[FONT_CNT], frame_ns, base_t, base_frame_ns;
+  uint32_t hash;
+  unsigned long base_hash;
+  size_t i;
+  int ok = 1;
+
+  for( i = 1; i < (size_t)argc; i++ )
+  {
+    if ( strcmp(argv[i], "--out") == 0 && i+1 < (size_t)argc )
+      out_path = argv[++i];
+    else if ( strcmp(argv[i], "--baseline") == 0 && i+1 < (size_t)argc )
+      baseline_path = argv[++i];
+    else
+    {
+      fprintf(stderr, "usage: %s [--out FILE] [--baseline FILE]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  u8g2_Setup_ssd1306_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  /* largest glyph: 10x20 */
+  u8g2_InitGlyphCache(&glyph_cache, glyph_cache_arena, sizeof(glyph_cache_arena), 30);
+
+  frame_ns = now_ns();
+  hash = frames_hash(FRAMES);
+  frame_ns = (now_ns() - frame_ns) / FRAMES;
+  for( i = 0; i < FONT_CNT; i++ )
+    t[i] = decode_time(tests+i);
+
+  printf("%s: %d frames, hash %08lx, %.1f us/frame\n", READER, FRAMES, (unsigned long)hash, frame_ns/1000);
+
+  if ( out_path != NULL )
+  {
+    fp = fopen(out_path, "w");
+    if ( fp == NULL )
+    {
+      perror(out_path);
+      return 2;
+    }
+    fprintf(fp, "hash %08lx %.1f\n", (unsigned long)hash, frame_ns);
+    for( i = 0; i < FONT_CNT; i++ )
+      fprintf(fp, "%s %.1f\n", tests[i].name, t[i]);
+    fclose(fp);
+  }
+
+  if ( baseline_path == NULL )
+  {
+    for( i = 0; i < FONT_CNT; i++ )
+      printf("%-16s decode %6.1f ns/glyph\n", tests[i].name, t[i]);
+    return 0;
+  }
+
+  fp = fopen(baseline_path, "r");
+  if ( fp == NULL )
+  {
+    perror(baseline_path);
+    return 2;
+  }
+  if ( fscanf(fp, "hash %lx %lf\n", &base_hash, &base_frame_ns) != 2 )
+  {
+    fprintf(stderr, "%s: no hash\n", baseline_path);
+    fclose(fp);
+    return 2;
+  }
+  printf("baseline:    %d frames, hash %08lx, %.1f us/frame, %s\n", FRAMES, base_hash,
+    base_frame_ns/1000, base_hash == hash ? "same pixels" : "PIXEL MISMATCH");
+  ok = base_hash == hash;
+  for( i = 0; i < FONT_CNT; i++ )
+  {
+    if ( fscanf(fp, "%31s %lf\n", name, &base_t) != 2 || strcmp(name, tests[i].name) != 0 )
+      break;
+    printf("%-16s decode %6.1f -> %6.1f ns/glyph\n", tests[i].name, base_t, t[i]);
+  }
+  fclose(fp);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Text drawing speed with and without the glyph index (U8G2_WITH_GLYPH_INDEX)
+ * and the glyph cache (U8G2_WITH_GLYPH_CACHE).
+ * Each font is drawn without index, with index and with index and cache,
+ * the resulting frame buffers must be identical. Additionally, the lookup 
+ * result of every encoding is compared.
+ */
+
+/* internal procedure of u8g2_font.c */
+const uint8_t *u8g2_font_get_glyph_data(u8g2_t *u8g2, uint16_t encoding);
+
+u8g2_t u8g2;
+
+#define UNICODE_CAPACITY 1024
+u8g2_glyph_index_entry_t unicode_entries[UNICODE_CAPACITY];
+u8g2_glyph_index_t glyph_index;
+
+uint8_t glyph_cache_arena[4096];
+u8g2_glyph_cache_t glyph_cache;
+
+uint8_t buf_without[128*64/8];
+uint8_t buf_with[128*64/8];
+uint8_t buf_cache[128*64/8];
+
+const char *ascii_lines[] = {
+  "VOUT 54.00V IOUT 60.00A",
+  "Temp 41C  Fan 3200 rpm",
+  "the quick brown fox",
+  "JUMPS OVER THE LAZY DOG",
+  "0123456789 +-*/=%()[]",
+};
+
+const char *greek_lines[] = {
+  "Τάση εξόδου 54.00V",
+  "Ρεύμα εξόδου 60.00A",
+  "Θερμοκρασία 41C",
+  "ΑΒΓΔΕΖΗΘΙΚΛΜΝΞΟΠ",
+  "αβγδεζηθικλμνξοπ",
+};
+
+const char *cyrillic_lines[] = {
+  "Напряжение 54.00V",
+  "Ток 60.00A",
+  "Температура 41C",
+  "АБВГДЕЖЗИЙКЛМНОП",
+  "абвгдежзийклмноп",
+};
+
+struct font_test
+{
+  const char *name;
+  const uint8_t *font;
+  const char **lines;
+};
+
+struct font_test tests[] = {
+  { "6x10_tf", u8g2_font_6x10_tf, ascii_lines },
+  { "profont17_tf", u8g2_font_profont17_tf, ascii_lines },
+  { "10x20_t_greek", u8g2_font_10x20_t_greek, greek_lines },
+  { "10x20_t_cyrillic", u8g2_font_10x20_t_cyrillic, cyrillic_lines },
+};
+
+double draw_loop(const struct font_test *t, long cnt, uint8_t *result)
+{
+  clock_t start;
+  long i;
+  int j;
+  
+  u8g2_SetFont(&u8g2, t->font);
+  start = clock();
+  for( i = 0; i < cnt; i++ )
+  {
+    u8g2_ClearBuffer(&u8g2);
+    for( j = 0; j < 5; j++ )
+      u8g2_DrawUTF8(&u8g2, 0, 12+j*12, t->lines[j]);
+  }
+  memcpy(result, u8g2_GetBufferPtr(&u8g2), sizeof(buf_with));
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* time for the glyph lookup only, returns ns per glyph */
+double lookup_loop(const struct font_test *t, long cnt)
+{
+  uint16_t encodings[128];
+  uint16_t e;
+  int n = 0;
+  int j;
+  long i, k;
+  clock_t start;
+  volatile const uint8_t *sink;
+  
+  u8g2_SetFont(&u8g2, t->font);
+  u8x8_utf8_init(u8g2_GetU8x8(&u8g2));
+  for( j = 0; j < 5; j++ )
+  {
+    const char *s = t->lines[j];
+    while ( *s != '\0' && n < 128 )
+    {
+      e = u8x8_utf8_next(u8g2_GetU8x8(&u8g2), (uint8_t)*s++);
+      if ( e < 0x0fffe )
+        encodings[n++] = e;
+    }
+  }
+  
+  start = clock();
+  for( i = 0; i < cnt; i++ )
+    for( k = 0; k < n; k++ )
+      sink = u8g2_font_get_glyph_data(&u8g2, encodings[k]);
+  (void)sink;
+  return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / ((double)cnt * n);
+}
+
+int check_lookup(const struct font_test *t)
+{
+  const uint8_t *without;
+  uint32_t e;
+  int err = 0;
+  
+  u8g2_SetFont(&u8g2, t->font);
+  for( e = 0; e < 0x10000; e++ )
+  {
+    u8g2_SetGlyphIndex(&u8g2, NULL);
+    without = u8g2_font_get_glyph_data(&u8g2, e);
+    u8g2_SetGlyphIndex(&u8g2, &glyph_index);
+    if ( u8g2_font_get_glyph_data(&u8g2, e) != without )
+      err++;
+  }
+  return err;
+}
+
+int main(void)
+{
+  long cnt = 20000;
+  size_t i;
+  double t_without, t_with, t_cache;
+  double l_without, l_with;
+  
+  u8g2_SetupBitmap(&u8g2, &u8g2_cb_r0, 128, 64);
+  u8x8_InitDisplay(u8g2_GetU8x8(&u8g2));
+  u8g2_InitGlyphIndex(&glyph_index, unicode_entries, UNICODE_CAPACITY);
+  /* largest glyph: 10x20 */
+  u8g2_InitGlyphCache(&glyph_cache, glyph_cache_arena, sizeof(glyph_cache_arena), 30);
+  
+  for( i = 0; i < sizeof(tests)/sizeof(*tests); i++ )
+  {
+    u8g2_SetGlyphIndex(&u8g2, NULL);
+    l_without = lookup_loop(tests+i, cnt*10);
+    t_without = draw_loop(tests+i, cnt, buf_without);
+    u8g2_SetGlyphIndex(&u8g2, &glyph_index);
+    l_with = lookup_loop(tests+i, cnt*10);
+    t_with = draw_loop(tests+i, cnt, buf_with);
+    u8g2_SetGlyphCache(&u8g2, &glyph_cache);
+    t_cache = draw_loop(tests+i, cnt, buf_cache);
+    u8g2_SetGlyphCache(&u8g2, NULL);
+    printf("%-16s lookup %6.1f -> %5.1f ns/glyph, frame %6.2f -> %6.2f -> %6.2f us (cache), %s, lookup errors %d\n",
+      tests[i].name, l_without, l_with, t_without*1e6/cnt, t_with*1e6/cnt, t_cache*1e6/cnt,
+      memcmp(buf_without, buf_with, sizeof(buf_with)) == 0 && memcmp(buf_without, buf_cache, sizeof(buf_cache)) == 0 ? "same pixels" : "PIXEL MISMATCH",
+      check_lookup(tests+i));
+  }
+  return 0;
+}
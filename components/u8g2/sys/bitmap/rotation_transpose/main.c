@@ -0,0 +1,232 @@
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * U8G2_R1_TRANSPOSE and U8G2_R3_TRANSPOSE must show the same picture as
+ * U8G2_R1 and U8G2_R3. The display procedure of the SSD1306 128x64 is
+ * replaced by a model of the display RAM (DRAW_TILE and DRAW_AREA).
+ * Random scenes are drawn with both rotations and the display RAM is compared:
+ *   - full buffer (_f): SendBuffer and UpdateDisplayArea
+ *   - page buffer (_1, _2): the transpose rotation falls back to R1/R3,
+ *     the page window must stay inside the buffer
+ * The time per frame (drawing and sending) is measured for the full buffer:
+ *   - the random scene (mostly boxes and lines)
+ *   - a status screen (text and a box) with the glyph cache assigned, the
+ *     glyph cache is used by the transpose rotation only
+ */
+
+#define WIDTH 128
+#define PAGES 8
+
+uint8_t display_ram[PAGES*WIDTH];
+u8x8_msg_cb ssd1306_cb;
+int window_errors;
+
+u8g2_t u8g2;
+u8g2_glyph_cache_t glyph_cache;
+uint8_t glyph_arena[3072];
+
+static uint32_t rnd_state;
+static uint32_t rnd(void)
+{
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return rnd_state >> 16;
+}
+
+static uint8_t u8x8_d_model(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_tile_t *tile = (u8x8_tile_t *)arg_ptr;
+  int r;
+  switch(msg)
+  {
+    case U8X8_MSG_DISPLAY_DRAW_TILE:
+      /* arg_int is the repeat count */
+      for( r = 0; r < arg_int; r++ )
+        memcpy(display_ram + tile->y_pos*WIDTH + (tile->x_pos + r*tile->cnt)*8, tile->tile_ptr, tile->cnt*8);
+      return 1;
+    case U8X8_MSG_DISPLAY_DRAW_AREA:
+      for( r = 0; r < arg_int; r++ )
+        memcpy(display_ram + (tile->y_pos+r)*WIDTH + tile->x_pos*8, tile->tile_ptr + r*WIDTH, tile->cnt*8);
+      return 1;
+  }
+  return ssd1306_cb(u8x8, msg, arg_int, arg_ptr);
+}
+
+static const uint8_t xbm[] = {
+  0xff, 0x81, 0x3c, 0x42, 0x99, 0xa5, 0x5a, 0x24,
+  0x81, 0x7e, 0x00, 0xff, 0x0f, 0xf0, 0x33, 0xcc
+};
+
+/* the same scene for every rotation: seed */
+static void scene(uint32_t seed)
+{
+  int i;
+  u8g2_uint_t w = u8g2_GetDisplayWidth(&u8g2);
+  u8g2_uint_t h = u8g2_GetDisplayHeight(&u8g2);
+
+  rnd_state = seed;
+  for( i = 0; i < 30; i++ )
+  {
+    u8g2_SetDrawColor(&u8g2, rnd() % 3);
+    u8g2_DrawBox(&u8g2, rnd() % w, rnd() % h, 1 + rnd() % 20, 1 + rnd() % 20);
+  }
+  for( i = 0; i < 30; i++ )
+  {
+    u8g2_SetDrawColor(&u8g2, rnd() % 3);
+    u8g2_DrawHLine(&u8g2, rnd() % w, rnd() % h, 1 + rnd() % 60);
+    u8g2_DrawVLine(&u8g2, rnd() % w, rnd() % h, 1 + rnd() % 60);
+  }
+  u8g2_SetDrawColor(&u8g2, 1);
+  u8g2_SetFont(&u8g2, u8g2_font_6x10_tf);
+  u8g2_DrawStr(&u8g2, rnd() % 8, 12, "54.00V");
+  u8g2_SetFont(&u8g2, u8g2_font_profont17_tf);
+  u8g2_DrawStr(&u8g2, rnd() % 8, 40, "60.0A");
+  u8g2_DrawCircle(&u8g2, w/2, h/2 + 20, 20, U8G2_DRAW_ALL);
+  u8g2_SetDrawColor(&u8g2, 2);
+  u8g2_SetBitmapMode(&u8g2, rnd() & 1);
+  u8g2_DrawXBM(&u8g2, rnd() % w, rnd() % h, 16, 8, xbm);
+}
+
+/* portrait status screen, seed is not used */
+static void status_scene(uint32_t seed)
+{
+  u8g2_uint_t y;
+  (void)seed;
+  u8g2_SetDrawColor(&u8g2, 1);
+  u8g2_SetFont(&u8g2, u8g2_font_profont17_tf);
+  u8g2_DrawStr(&u8g2, 0, 20, "54.0V");
+  u8g2_DrawStr(&u8g2, 0, 45, "10.0A");
+  u8g2_DrawBox(&u8g2, 0, 50, 64, 14);
+  u8g2_SetFont(&u8g2, u8g2_font_6x10_tf);
+  for( y = 80; y <= 128; y += 12 )
+    u8g2_DrawStr(&u8g2, 0, y, "OUT ON");
+}
+
+typedef void (*setup_fn)(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb);
+
+static void setup(setup_fn fn, const u8g2_cb_t *cb)
+{
+  fn(&u8g2, cb, u8x8_dummy_cb, u8x8_dummy_cb);
+  ssd1306_cb = u8g2.u8x8.display_cb;
+  u8g2.u8x8.display_cb = u8x8_d_model;
+  u8g2_InitDisplay(&u8g2);
+}
+
+/* draw the scene with the page loop (also works for full buffer), result is in display_ram */
+static void render(uint32_t seed)
+{
+  memset(display_ram, 0x5a, sizeof(display_ram));
+  u8g2_FirstPage(&u8g2);
+  do
+  {
+    /* the page window must be inside the buffer (tile_buf_height*WIDTH bytes) */
+    if ( u8g2.buf_y1 < u8g2.buf_y0 || (long)(u8g2.buf_y1 - u8g2.buf_y0) * u8g2.pixel_buf_width > (long)u8g2.tile_buf_height*8*WIDTH )
+      window_errors++;
+    scene(seed);
+  } while( u8g2_NextPage(&u8g2) );
+}
+
+static double frame_time(void (*draw)(uint32_t seed), uint32_t seed, long cnt)
+{
+  struct timespec a, b;
+  long i;
+  clock_gettime(CLOCK_MONOTONIC, &a);
+  for( i = 0; i < cnt; i++ )
+  {
+    u8g2_ClearBuffer(&u8g2);
+    draw(seed);
+    u8g2_SendBuffer(&u8g2);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &b);
+  return ((b.tv_sec - a.tv_sec)*1e9 + (b.tv_nsec - a.tv_nsec)) / cnt;
+}
+
+static int compare(const char *name, const u8g2_cb_t *ref_cb, const u8g2_cb_t *cb)
+{
+  static uint8_t ref[PAGES*WIDTH];
+  static const struct { const char *name; setup_fn fn; } setups[] = {
+    { "_f", u8g2_Setup_ssd1306_128x64_noname_f },
+    { "_1", u8g2_Setup_ssd1306_128x64_noname_1 },
+    { "_2", u8g2_Setup_ssd1306_128x64_noname_2 },
+  };
+  uint32_t seed;
+  size_t i;
+  int mismatch = 0;
+  int fallback_errors = 0;
+  int tx, ty, tw, th, x, y;
+  double t_ref, t_transpose, t_text_ref, t_text_transpose;
+
+  window_errors = 0;
+  for( seed = 1; seed <= 50; seed++ )
+  {
+    setup(u8g2_Setup_ssd1306_128x64_noname_f, ref_cb);
+    render(seed);
+    memcpy(ref, display_ram, sizeof(ref));
+    for( i = 0; i < sizeof(setups)/sizeof(*setups); i++ )
+    {
+      setup(setups[i].fn, cb);
+      /* page buffers: the transpose rotation is replaced */
+      if ( (u8g2.tile_buf_height == PAGES) != (u8g2.cb == cb) )
+        fallback_errors++;
+      render(seed);
+      if ( memcmp(ref, display_ram, sizeof(ref)) != 0 )
+      {
+        printf("%s%s: scene %u differs\n", name, setups[i].name, (unsigned)seed);
+        mismatch++;
+      }
+    }
+
+    /* UpdateDisplayArea takes display tile positions */
+    setup(u8g2_Setup_ssd1306_128x64_noname_f, cb);
+    u8g2_ClearBuffer(&u8g2);
+    scene(seed);
+    memset(display_ram, 0, sizeof(display_ram));
+    tx = rnd() % (WIDTH/8);
+    ty = rnd() % PAGES;
+    tw = 1 + rnd() % (WIDTH/8 - tx);
+    th = 1 + rnd() % (PAGES - ty);
+    u8g2_UpdateDisplayArea(&u8g2, tx, ty, tw, th);
+    for( y = 0; y < PAGES; y++ )
+      for( x = 0; x < WIDTH; x++ )
+        if ( display_ram[y*WIDTH+x] != (y >= ty && y < ty+th && x >= tx*8 && x < (tx+tw)*8 ? ref[y*WIDTH+x] : 0) )
+        {
+          printf("%s: UpdateDisplayArea(%d,%d,%d,%d) differs in scene %u\n", name, tx, ty, tw, th, (unsigned)seed);
+          mismatch++;
+          y = PAGES;
+          break;
+        }
+  }
+
+  setup(u8g2_Setup_ssd1306_128x64_noname_f, ref_cb);
+  t_ref = frame_time(scene, 1, 20000);
+  u8g2_InitGlyphCache(&glyph_cache, glyph_arena, sizeof(glyph_arena), 64);
+  u8g2_SetGlyphCache(&u8g2, &glyph_cache);
+  t_text_ref = frame_time(status_scene, 1, 20000);
+  memcpy(ref, display_ram, sizeof(ref));
+  setup(u8g2_Setup_ssd1306_128x64_noname_f, cb);
+  t_transpose = frame_time(scene, 1, 20000);
+  u8g2_InitGlyphCache(&glyph_cache, glyph_arena, sizeof(glyph_arena), 64);
+  u8g2_SetGlyphCache(&u8g2, &glyph_cache);
+  t_text_transpose = frame_time(status_scene, 1, 20000);
+  if ( memcmp(ref, display_ram, sizeof(ref)) != 0 )
+  {
+    printf("%s: status screen with glyph cache differs\n", name);
+    mismatch++;
+  }
+
+  printf("%-14s 50 scenes x (_f, _1, _2, area): %d mismatches, %d fallback errors, %d window errors\n",
+    name, mismatch, fallback_errors, window_errors);
+  printf("%-14s frame %.1f -> %.1f us, status frame with glyph cache %.1f -> %.1f us\n",
+    "", t_ref/1000, t_transpose/1000, t_text_ref/1000, t_text_transpose/1000);
+  return mismatch == 0 && fallback_errors == 0 && window_errors == 0;
+}
+
+int main(void)
+{
+  int ok = 1;
+  ok &= compare("R1_TRANSPOSE", U8G2_R1, U8G2_R1_TRANSPOSE);
+  ok &= compare("R3_TRANSPOSE", U8G2_R3, U8G2_R3_TRANSPOSE);
+  return ok ? 0 : 1;
+}
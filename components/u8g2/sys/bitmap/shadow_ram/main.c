@@ -0,0 +1,230 @@
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Shadow RAM (u8x8_SetShadowRAM): the display procedure of the SSD1306 128x64
+ * is replaced by a model of the display RAM (DRAW_TILE and DRAW_AREA).
+ * INIT and SET_FLIP_MODE overwrite the model RAM with garbage: the content is
+ * unknown after reset and the tiles must be sent again for the new orientation.
+ * A random sequence of updates is executed:
+ *   - SendBuffer after a small or large change of the buffer
+ *   - partial UpdateDisplayArea
+ *   - SetFlipMode, InitDisplay
+ *   - ClearLine, ClearDisplay
+ * After every update, each tile with known content must match the model RAM.
+ * With shadow RAM, a second SendBuffer without changes must not transfer any tile.
+ * The same sequence is executed without shadow RAM to compare the number of
+ * transferred tiles.
+ */
+
+#define WIDTH 128
+#define PAGES 8
+#define TILES (WIDTH/8)
+
+uint8_t display_ram[PAGES*WIDTH];
+u8x8_msg_cb ssd1306_cb;
+long tiles_sent;
+int reported;			/* only the first mismatch is printed */
+
+/* what the display must show: content and "known" flag per tile */
+uint8_t expected[PAGES*WIDTH];
+uint8_t known[PAGES][TILES];
+
+u8g2_t u8g2;
+uint8_t shadow_ram[U8X8_SHADOW_RAM_SIZE(TILES, PAGES)];
+
+static uint32_t rnd_state;
+static uint32_t rnd(void)
+{
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return rnd_state >> 16;
+}
+
+static void scramble(void)
+{
+  size_t i;
+  for( i = 0; i < sizeof(display_ram); i++ )
+    display_ram[i] = rnd();
+}
+
+static uint8_t u8x8_d_model(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_tile_t *tile = (u8x8_tile_t *)arg_ptr;
+  uint8_t r;
+  switch(msg)
+  {
+    case U8X8_MSG_DISPLAY_DRAW_TILE:
+      /* arg_int is the repeat count */
+      for( r = 0; r < arg_int; r++ )
+        memcpy(display_ram + tile->y_pos*WIDTH + (tile->x_pos + r*tile->cnt)*8, tile->tile_ptr, tile->cnt*8);
+      tiles_sent += arg_int*tile->cnt;
+      return 1;
+    case U8X8_MSG_DISPLAY_DRAW_AREA:
+      for( r = 0; r < arg_int; r++ )
+        memcpy(display_ram + (tile->y_pos+r)*WIDTH + tile->x_pos*8, tile->tile_ptr + r*WIDTH, tile->cnt*8);
+      tiles_sent += arg_int*tile->cnt;
+      return 1;
+    case U8X8_MSG_DISPLAY_INIT:
+    case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
+      ssd1306_cb(u8x8, msg, arg_int, arg_ptr);
+      scramble();
+      return 1;
+  }
+  return ssd1306_cb(u8x8, msg, arg_int, arg_ptr);
+}
+
+/* the buffer tiles inside the area are shown on the display */
+static void expect_buffer(int tx, int ty, int tw, int th)
+{
+  uint8_t *buf = u8g2_GetBufferPtr(&u8g2);
+  int x, y;
+  for( y = ty; y < ty+th; y++ )
+    for( x = tx; x < tx+tw; x++ )
+    {
+      memcpy(expected + y*WIDTH + x*8, buf + y*WIDTH + x*8, 8);
+      known[y][x] = 1;
+    }
+}
+
+static void expect_clear(int ty, int th)
+{
+  memset(expected + ty*WIDTH, 0, th*WIDTH);
+  memset(known[ty], 1, th*TILES);
+}
+
+static void expect_unknown(void)
+{
+  memset(known, 0, sizeof(known));
+}
+
+/* returns 1 if all known tiles match the display RAM */
+static int check(const char *name, const char *what, long step)
+{
+  int x, y;
+  for( y = 0; y < PAGES; y++ )
+    for( x = 0; x < TILES; x++ )
+      if ( known[y][x] && memcmp(expected + y*WIDTH + x*8, display_ram + y*WIDTH + x*8, 8) != 0 )
+      {
+        if ( reported++ == 0 )
+          printf("%s: step %ld: %s: tile %d/%d differs\n", name, step, what, x, y);
+        return 0;
+      }
+  return 1;
+}
+
+/* a few small boxes (some tiles change) or a complete new picture */
+static void change_buffer(void)
+{
+  int i;
+  if ( rnd() % 8 == 0 )
+  {
+    u8g2_ClearBuffer(&u8g2);
+    u8g2_SetDrawColor(&u8g2, 1);
+    for( i = 0; i < 20; i++ )
+      u8g2_DrawBox(&u8g2, rnd() % WIDTH, rnd() % (PAGES*8), 1 + rnd() % 40, 1 + rnd() % 30);
+  }
+  else
+  {
+    u8g2_SetDrawColor(&u8g2, 2);
+    for( i = rnd() % 4; i >= 0; i-- )
+      u8g2_DrawBox(&u8g2, rnd() % WIDTH, rnd() % (PAGES*8), 1 + rnd() % 12, 1 + rnd() % 12);
+  }
+}
+
+/* returns the number of errors */
+static long run(const char *name, int with_shadow, long steps, long *tiles)
+{
+  long step;
+  long errors = 0;
+  long resent = 0;
+  int tx, ty, tw, th;
+  const char *what;
+
+  u8g2_Setup_ssd1306_128x64_noname_f(&u8g2, U8G2_R0, u8x8_dummy_cb, u8x8_dummy_cb);
+  ssd1306_cb = u8g2.u8x8.display_cb;
+  u8g2.u8x8.display_cb = u8x8_d_model;
+  if ( with_shadow )
+    u8g2_SetShadowRAM(&u8g2, shadow_ram);
+  rnd_state = 1;
+  u8g2_InitDisplay(&u8g2);
+  u8g2_ClearBuffer(&u8g2);
+  expect_unknown();
+  tiles_sent = 0;
+  reported = 0;
+
+  for( step = 0; step < steps; step++ )
+  {
+    switch( rnd() % 16 )
+    {
+      case 0:
+        what = "SetFlipMode";
+        u8g2_SetFlipMode(&u8g2, rnd() & 1);
+        expect_unknown();
+        break;
+      case 1:
+        what = "InitDisplay";
+        u8g2_InitDisplay(&u8g2);
+        expect_unknown();
+        break;
+      case 2:
+      case 3:
+        what = "ClearLine";
+        ty = rnd() % PAGES;
+        u8x8_ClearLine(u8g2_GetU8x8(&u8g2), ty);
+        expect_clear(ty, 1);
+        break;
+      case 4:
+        what = "ClearDisplay";
+        u8x8_ClearDisplay(u8g2_GetU8x8(&u8g2));
+        expect_clear(0, PAGES);
+        break;
+      case 5: case 6: case 7: case 8: case 9:
+        what = "UpdateDisplayArea";
+        change_buffer();
+        tx = rnd() % TILES;
+        ty = rnd() % PAGES;
+        tw = 1 + rnd() % (TILES - tx);
+        th = 1 + rnd() % (PAGES - ty);
+        u8g2_UpdateDisplayArea(&u8g2, tx, ty, tw, th);
+        expect_buffer(tx, ty, tw, th);
+        break;
+      default:
+        what = "SendBuffer";
+        change_buffer();
+        u8g2_SendBuffer(&u8g2);
+        expect_buffer(0, 0, TILES, PAGES);
+        if ( with_shadow && check(name, what, step) )
+        {
+          /* nothing has changed: no transfer */
+          resent -= tiles_sent;
+          u8g2_SendBuffer(&u8g2);
+          resent += tiles_sent;
+        }
+        break;
+    }
+    if ( check(name, what, step) == 0 )
+      errors++;
+  }
+
+  *tiles = tiles_sent;
+  printf("%-16s %ld updates, %7ld tiles sent", name, steps, tiles_sent);
+  if ( with_shadow )
+  {
+    printf(", %ld tiles for unchanged SendBuffer", resent);
+    errors += resent != 0;
+  }
+  printf(", %s\n", errors == 0 ? "ok" : "FAILED");
+  return errors;
+}
+
+int main(void)
+{
+  long errors = 0;
+  long tiles, tiles_shadow;
+
+  errors += run("ssd1306_f", 0, 5000, &tiles);
+  errors += run("ssd1306_f+shadow", 1, 5000, &tiles_shadow);
+  printf("shadow RAM: %.1f%% of the tiles sent\n", tiles_shadow * 100.0 / tiles);
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,443 @@
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Model of the SSD1306 I2C controller for u8g2_Setup_ssd1306_i2c_128x64_noname_f.
+ * The byte procedure collects each i2c transfer. The model parses the control
+ * bytes (Co, D/C), executes the addressing commands (addressing mode, column and
+ * page range, start address) and writes the data into a copy of the display RAM.
+ * After each update, the display RAM must match the u8g2 buffer and the
+ * column/page window must cover the complete display again.
+ * This is done for the i2c cad procedures with and without shadow RAM.
+ *
+ * Protocol: The command bytes executed by the model and the delays form a
+ * trace. For the init sequence and for a sequence with delays inside a transfer, 
+ * u8x8_cad_ssd13xx_stream_i2c must produce the same trace as the classic 
+ * u8x8_cad_ssd13xx_i2c (one i2c transfer per byte): commands before a delay 
+ * must reach the display before the delay.
+ */
+
+#define WIDTH 128
+#define PAGES 8
+
+struct ssd1306_model
+{
+  uint8_t ram[PAGES][WIDTH];
+  uint8_t mode;			/* 0: horizontal, 2: page addressing */
+  uint8_t col_start, col_end;
+  uint8_t page_start, page_end;
+  uint8_t col, page;
+  uint8_t cmd;			/* command, which waits for arguments */
+  uint8_t args[8];
+  uint8_t arg_cnt, arg_need;
+
+  long transfers;
+  long bytes;
+  long calls;			/* calls to the byte procedure */
+  long window_cmds;		/* 0x21 commands */
+  long errors;
+};
+
+struct ssd1306_model model;
+
+/* executed command bytes (0..255) and delays (0x100 + milliseconds) */
+#define TRACE_SIZE 256
+uint16_t trace[TRACE_SIZE];
+int trace_len;
+uint8_t fail_end_transfer;	/* byte procedure fails at END_TRANSFER */
+
+static void trace_add(uint16_t v)
+{
+  if ( trace_len < TRACE_SIZE )
+    trace[trace_len++] = v;
+}
+
+#define TRANSFER_SIZE 4096
+uint8_t transfer[TRANSFER_SIZE];
+uint16_t transfer_len;
+
+u8g2_t u8g2;
+uint8_t shadow_ram[U8X8_SHADOW_RAM_SIZE(WIDTH/8, PAGES)];
+uint8_t expected[PAGES][WIDTH];
+
+static uint32_t rnd_state = 1;
+static uint32_t rnd(void)
+{
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return rnd_state >> 16;
+}
+
+static uint8_t cmd_arg_cnt(uint8_t c)
+{
+  switch(c)
+  {
+    case 0x20: case 0x81: case 0x8d: case 0xa8: case 0xd3:
+    case 0xd5: case 0xd9: case 0xda: case 0xdb:
+      return 1;
+    case 0x21: case 0x22: case 0xa3:
+      return 2;
+    case 0x29: case 0x2a:
+      return 5;
+    case 0x26: case 0x27:
+      return 6;
+  }
+  return 0;
+}
+
+static void model_exec(void)
+{
+  uint8_t c = model.cmd;
+  if ( c < 0x10 )
+    model.col = (model.col & 0xf0) | c;
+  else if ( c < 0x20 )
+    model.col = (model.col & 0x0f) | ((c & 0x0f) << 4);
+  else if ( c >= 0xb0 && c < 0xb8 )
+    model.page = c & 7;
+  else if ( c == 0x20 )
+    model.mode = model.args[0] & 3;
+  else if ( c == 0x21 )
+  {
+    model.col_start = model.args[0] & 127;
+    model.col_end = model.args[1] & 127;
+    model.col = model.col_start;
+    model.window_cmds++;
+  }
+  else if ( c == 0x22 )
+  {
+    model.page_start = model.args[0] & 7;
+    model.page_end = model.args[1] & 7;
+    model.page = model.page_start;
+  }
+}
+
+static void model_cmd_byte(uint8_t b)
+{
+  trace_add(b);
+  if ( model.arg_need > 0 )
+  {
+    model.args[model.arg_cnt++] = b;
+    if ( model.arg_cnt == model.arg_need )
+    {
+      model.arg_need = 0;
+      model_exec();
+    }
+    return;
+  }
+  model.cmd = b;
+  model.arg_cnt = 0;
+  model.arg_need = cmd_arg_cnt(b);
+  if ( model.arg_need == 0 )
+    model_exec();
+}
+
+static void model_data_byte(uint8_t b)
+{
+  model.ram[model.page][model.col] = b;
+  if ( model.col != model.col_end )
+  {
+    model.col = (model.col + 1) & 127;
+    return;
+  }
+  model.col = model.col_start;
+  if ( model.mode == 0 )
+    model.page = model.page == model.page_end ? model.page_start : ((model.page + 1) & 7);
+}
+
+/* one i2c transfer: control byte with Co=1 applies to the next byte only, Co=0 to the rest of the transfer */
+static void model_transfer(const uint8_t *p, uint16_t len)
+{
+  uint8_t ctrl;
+  model.transfers++;
+  model.bytes += len;
+  while( len > 0 )
+  {
+    ctrl = *p++;
+    len--;
+    if ( (ctrl & 0x3f) != 0 )
+    {
+      printf("invalid control byte 0x%02x\n", ctrl);
+      model.errors++;
+    }
+    if ( ctrl & 0x80 )
+    {
+      if ( len == 0 )
+      {
+        printf("control byte 0x%02x without byte\n", ctrl);
+        model.errors++;
+        return;
+      }
+      if ( ctrl & 0x40 )
+        model_data_byte(*p);
+      else
+        model_cmd_byte(*p);
+      p++;
+      len--;
+    }
+    else
+    {
+      while( len > 0 )
+      {
+        if ( ctrl & 0x40 )
+          model_data_byte(*p);
+        else
+          model_cmd_byte(*p);
+        p++;
+        len--;
+      }
+    }
+  }
+}
+
+static void transfer_add(const uint8_t *p, uint16_t len)
+{
+  if ( transfer_len + len > TRANSFER_SIZE )
+  {
+    printf("transfer too large\n");
+    model.errors++;
+    return;
+  }
+  memcpy(transfer+transfer_len, p, len);
+  transfer_len += len;
+}
+
+static uint8_t u8x8_byte_model(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_segment_t *seg;
+  (void)u8x8;
+  model.calls++;
+  switch(msg)
+  {
+    case U8X8_MSG_BYTE_SEND:
+      transfer_add((uint8_t *)arg_ptr, arg_int);
+      break;
+    case U8X8_MSG_BYTE_SEND_SEGMENTS:
+      seg = (u8x8_segment_t *)arg_ptr;
+      while( arg_int > 0 )
+      {
+        transfer_add(seg->ptr, seg->len);
+        seg++;
+        arg_int--;
+      }
+      break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      transfer_len = 0;
+      break;
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      if ( fail_end_transfer )
+        return 0;
+      model_transfer(transfer, transfer_len);
+      break;
+    case U8X8_MSG_BYTE_INIT:
+    case U8X8_MSG_BYTE_SET_DC:
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+static uint8_t u8x8_gpio_and_delay_model(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  (void)u8x8; (void)arg_ptr;
+  if ( msg == U8X8_MSG_DELAY_MILLI )
+    trace_add(0x100 + arg_int);
+  return 1;
+}
+
+/* power on: the display RAM content is undefined */
+static void model_power_on(void)
+{
+  int i;
+  memset(&model, 0, sizeof(model));
+  for( i = 0; i < PAGES*WIDTH; i++ )
+    model.ram[i/WIDTH][i%WIDTH] = rnd();
+  model.mode = 2;
+  model.col_end = WIDTH-1;
+  model.page_end = PAGES-1;
+}
+
+static int check(const char *name, const char *what, const uint8_t *ref)
+{
+  int ok = 1;
+  if ( memcmp(model.ram, ref, sizeof(model.ram)) != 0 )
+  {
+    printf("%s: %s: display RAM mismatch\n", name, what);
+    ok = 0;
+  }
+  if ( model.col_start != 0 || model.col_end != WIDTH-1 || model.page_start != 0 || model.page_end != PAGES-1 )
+  {
+    printf("%s: %s: window not restored (col %d..%d, page %d..%d)\n", name, what,
+      model.col_start, model.col_end, model.page_start, model.page_end);
+    ok = 0;
+  }
+  return ok;
+}
+
+static void change_bytes(int cnt)
+{
+  uint8_t *buf = u8g2_GetBufferPtr(&u8g2);
+  while( cnt-- > 0 )
+    buf[rnd() % (PAGES*WIDTH)] = rnd();
+}
+
+static int run(const char *name, u8x8_msg_cb cad, int with_shadow)
+{
+  uint8_t *buf;
+  int ok = 1;
+  int frame;
+  int tx, ty, tw, th, x, y;
+  long transfers, calls, window_cmds;
+
+  model_power_on();
+  u8g2_Setup_ssd1306_i2c_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_model, u8x8_gpio_and_delay_model);
+  u8g2.u8x8.cad_cb = cad;
+  if ( with_shadow )
+    u8g2_SetShadowRAM(&u8g2, shadow_ram);
+  u8g2_InitDisplay(&u8g2);
+  u8g2_SetPowerSave(&u8g2, 0);
+  buf = u8g2_GetBufferPtr(&u8g2);
+
+  /* first frame after init: one burst with column/page window, also with shadow RAM */
+  u8g2_ClearBuffer(&u8g2);
+  u8g2_SetFont(&u8g2, u8g2_font_6x10_tf);
+  u8g2_DrawStr(&u8g2, 0, 10, "System Ready");
+  window_cmds = model.window_cmds;
+  transfers = model.transfers;
+  u8g2_SendBuffer(&u8g2);
+  ok &= check(name, "first frame", buf);
+  if ( model.window_cmds == window_cmds )
+  {
+    printf("%s: first frame not sent with DRAW_AREA\n", name);
+    ok = 0;
+  }
+  printf("%-26s first frame %3ld transfers", name, model.transfers - transfers);
+
+  /* full updates with few or all bytes changed */
+  transfers = model.transfers;
+  calls = model.calls;
+  for( frame = 0; frame < 200; frame++ )
+  {
+    if ( frame % 10 == 0 )
+      change_bytes(PAGES*WIDTH*4);
+    else
+      change_bytes(rnd() % 8);
+    u8g2_SendBuffer(&u8g2);
+    ok &= check(name, "SendBuffer", buf);
+  }
+  printf(", SendBuffer %5.1f transfers %6.1f calls/frame", (model.transfers - transfers)/200.0, (model.calls - calls)/200.0);
+
+  /* partial updates: only the area is transfered, afterwards SendBuffer must still work */
+  memcpy(expected, model.ram, sizeof(expected));
+  for( frame = 0; frame < 200; frame++ )
+  {
+    tx = rnd() % (WIDTH/8);
+    ty = rnd() % PAGES;
+    tw = 1 + rnd() % (WIDTH/8 - tx);
+    th = 1 + rnd() % (PAGES - ty);
+    change_bytes(rnd() % 64);
+    u8g2_UpdateDisplayArea(&u8g2, tx, ty, tw, th);
+    for( y = ty; y < ty+th; y++ )
+      for( x = tx*8; x < (tx+tw)*8; x++ )
+        expected[y][x] = buf[y*WIDTH+x];
+    ok &= check(name, "UpdateDisplayArea", &expected[0][0]);
+    if ( frame % 4 == 3 )
+    {
+      u8g2_SendBuffer(&u8g2);
+      ok &= check(name, "SendBuffer after UpdateDisplayArea", buf);
+      memcpy(expected, model.ram, sizeof(expected));
+    }
+  }
+
+  /* flip mode and a display reset (new RAM content) invalidate the shadow RAM */
+  u8g2_SetFlipMode(&u8g2, 1);
+  u8g2_SendBuffer(&u8g2);
+  ok &= check(name, "flip mode", buf);
+  u8g2_SetFlipMode(&u8g2, 0);
+  u8g2_SendBuffer(&u8g2);
+  ok &= check(name, "flip mode off", buf);
+  model_power_on();
+  u8g2_InitDisplay(&u8g2);
+  u8g2_SetPowerSave(&u8g2, 0);
+  u8g2_SendBuffer(&u8g2);
+  ok &= check(name, "InitDisplay", buf);
+
+  if ( model.errors != 0 )
+    ok = 0;
+  printf(", %s\n", ok ? "ok" : "FAILED");
+  return ok;
+}
+
+/* commands with delays inside a transfer */
+static const uint8_t delay_seq[] = {
+  U8X8_START_TRANSFER(),
+  U8X8_C(0x0ae),
+  U8X8_CA(0x081, 0x10),
+  U8X8_DLY(5),
+  U8X8_C(0x0af),
+  U8X8_CAA(0x021, 0, 127),
+  U8X8_DLY(1),
+  U8X8_CA(0x081, 0x20),
+  U8X8_END_TRANSFER(),
+  U8X8_END()
+};
+
+/* trace of the init sequence and the delay sequence */
+static int protocol_trace(u8x8_msg_cb cad, uint16_t *dest)
+{
+  model_power_on();
+  trace_len = 0;
+  u8g2_Setup_ssd1306_i2c_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_model, u8x8_gpio_and_delay_model);
+  u8g2.u8x8.cad_cb = cad;
+  u8g2_InitDisplay(&u8g2);
+  u8g2_SetPowerSave(&u8g2, 0);
+  u8g2_SetContrast(&u8g2, 200);
+  u8x8_cad_SendSequence(u8g2_GetU8x8(&u8g2), delay_seq);
+  memcpy(dest, trace, trace_len*sizeof(uint16_t));
+  return trace_len;
+}
+
+static int protocol(void)
+{
+  static uint16_t ref[TRACE_SIZE];
+  int ref_len, i;
+  int ok = 1;
+  uint8_t r;
+  
+  ref_len = protocol_trace(u8x8_cad_ssd13xx_i2c, ref);
+  protocol_trace(u8x8_cad_ssd13xx_stream_i2c, trace);
+  if ( trace_len != ref_len || memcmp(trace, ref, ref_len*sizeof(uint16_t)) != 0 || model.errors != 0 )
+  {
+    printf("stream_i2c: command/delay trace differs from ssd13xx_i2c\n");
+    for( i = 0; i < ref_len || i < trace_len; i++ )
+      printf("  %3d: %03x %03x\n", i, i < ref_len ? ref[i] : 0, i < trace_len ? trace[i] : 0);
+    ok = 0;
+  }
+  printf("%-26s %d commands/delays, %ld transfers, same trace as ssd13xx_i2c", "stream_i2c protocol", trace_len, model.transfers);
+  
+  /* a failed i2c transfer is reported by END_TRANSFER */
+  fail_end_transfer = 1;
+  u8x8_cad_StartTransfer(u8g2_GetU8x8(&u8g2));
+  u8x8_cad_SendCmd(u8g2_GetU8x8(&u8g2), 0x0af);
+  r = u8x8_cad_EndTransfer(u8g2_GetU8x8(&u8g2));
+  fail_end_transfer = 0;
+  if ( r != 0 )
+  {
+    printf("\nstream_i2c: failed transfer not reported");
+    ok = 0;
+  }
+  printf(", %s\n", ok ? "ok" : "FAILED");
+  return ok;
+}
+
+int main(void)
+{
+  int ok = 1;
+  ok &= protocol();
+  ok &= run("ssd13xx_i2c", u8x8_cad_ssd13xx_i2c, 0);
+  ok &= run("ssd13xx_fast_i2c", u8x8_cad_ssd13xx_fast_i2c, 0);
+  ok &= run("ssd13xx_fast_i2c+shadow", u8x8_cad_ssd13xx_fast_i2c, 1);
+  ok &= run("ssd13xx_stream_i2c", u8x8_cad_ssd13xx_stream_i2c, 0);
+  ok &= run("ssd13xx_stream_i2c+shadow", u8x8_cad_ssd13xx_stream_i2c, 1);
+  return ok ? 0 : 1;
+}
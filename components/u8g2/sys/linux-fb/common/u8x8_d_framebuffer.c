@@ -91,15 +91,9 @@ uint8_t u8x8_LinuxFb_alloc(int fbfd, u8x8_linuxfb_t *fb)
 void u8x8_LinuxFb_DrawTiles(u8x8_linuxfb_t *fb, uint16_t tx, uint16_t ty, uint8_t tile_cnt, uint8_t *tile_ptr)
 {
 	uint8_t byte;
-	memset(fb->u8x8_buf,0x00,8*tile_cnt);
-
-	for(int i=0; i < tile_cnt * 8; i++){
-		byte = *tile_ptr++;
-		for(int bit=0; bit < 8;bit++){
-			if(byte & (1 << bit))
-				fb->u8x8_buf[tile_cnt*bit+(i/8)] |= (1 << i%8);
-		}
-	}
+
+	/* 8 pixel rows with tile_cnt bytes each, lsb is the left pixel */
+	u8x8_transpose_tiles(tile_ptr, tile_cnt, fb->u8x8_buf, tile_cnt);
 
 	switch (fb->vinfo.bits_per_pixel) {
 		case 1:
@@ -107,37 +101,35 @@ void u8x8_LinuxFb_DrawTiles(u8x8_linuxfb_t *fb, uint16_t tx, uint16_t ty, uint8_
 			break;
 		case 16:{
 			uint16_t pixel;
-			uint16_t *fbp16 = (uint16_t *)fb->fbp;
-			long int location = 0;
+			uint16_t *fbp16;
 
 			uint8_t b = (fb->active_color & 0x0000FF) >> 0;
 			uint8_t g = (fb->active_color & 0x00FF00) >> 8;
 			uint8_t r = (fb->active_color & 0xFF0000) >> 16;
+			pixel =  r<<11 | g << 5 | b;
 
 			for(int y=0; y<8;y++){
-				for(int x=0; x<8*tile_cnt;x++){
-					if(fb->u8x8_buf[(x/8) + (y*tile_cnt) ] & (1 << x%8))
-						pixel =  r<<11 | g << 5 | b;
-					else
-						pixel = 0x000000;
-					location = (x + fb->vinfo.xoffset) + ((ty*8)+y + fb->vinfo.yoffset) * fb->finfo.line_length / 2;
-					memcpy(&fbp16[location], &pixel, sizeof(pixel));
+				fbp16 = (uint16_t *)fb->fbp + fb->vinfo.xoffset + ((ty*8)+y + fb->vinfo.yoffset) * fb->finfo.line_length / 2;
+				for(int x=0; x<tile_cnt;x++){
+					byte = fb->u8x8_buf[x + y*tile_cnt];
+					for(int bit=0; bit<8;bit++){
+						*fbp16++ = (byte & 1) ? pixel : 0;
+						byte >>= 1;
+					}
 				}
 			}
 		}break;
 		case 32:{
-			uint32_t pixel;
-			uint32_t *fbp32 = (uint32_t *)fb->fbp;
-			long int location = 0;
+			uint32_t *fbp32;
 
 			for(int y=0; y<8;y++){
-				for(int x=0; x<8*tile_cnt;x++){
-					if(fb->u8x8_buf[(x/8) + (y*tile_cnt) ] & (1 << x%8))
-						pixel = fb->active_color;
-					else
-						pixel = 0x000000;
-					location = (x + fb->vinfo.xoffset) + ((ty*8)+y + fb->vinfo.yoffset) * fb->finfo.line_length / 4;
-					memcpy(&fbp32[location], &pixel, sizeof(pixel));
+				fbp32 = (uint32_t *)fb->fbp + fb->vinfo.xoffset + ((ty*8)+y + fb->vinfo.yoffset) * fb->finfo.line_length / 4;
+				for(int x=0; x<tile_cnt;x++){
+					byte = fb->u8x8_buf[x + y*tile_cnt];
+					for(int bit=0; bit<8;bit++){
+						*fbp32++ = (byte & 1) ? fb->active_color : 0;
+						byte >>= 1;
+					}
 				}
 			}
 		}break;
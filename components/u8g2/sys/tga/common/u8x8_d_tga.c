@@ -119,13 +119,83 @@ void tga_set_8pixel(int x, int y, uint8_t pixel, uint16_t f)
   }
 }
 
+/*
+  Draw 8 horizontal pixel (lsb is the left pixel) with a size of f x f.
+  Same result as tga_set_pixel()/tga_clr_pixel() for each pixel if
+  tga_is_transparent is 0: the first line is copied to the other f-1 lines.
+*/
+static void tga_set_8pixel_row(int x, int y, uint8_t pixel, uint16_t f)
+{
+  const uint8_t fg[3] = { tga_fg_b, tga_fg_g, tga_fg_r };
+  const uint8_t bg[3] = { tga_bg_b, tga_bg_g, tga_bg_r };
+  const uint8_t *color[2] = { bg, fg };
+  const uint8_t *c;
+  uint8_t *p, *first = NULL;
+  uint16_t w, n, xx, yy, i, j;
+  
+  if ( x >= tga_width )
+    return;
+  w = 8*f;
+  if ( w > tga_width - x )
+    w = tga_width - x;
+  for( yy = y; yy < y+f && yy < tga_height; yy++ )
+  {
+    p = tga_data + (tga_height-yy-1)*tga_width*3 + x*3;
+    if ( first != NULL )
+    {
+      memcpy(p, first, w*3);
+      continue;
+    }
+    first = p;
+    xx = 0;
+    for( i = 0; i < 8 && xx < w; i++ )
+    {
+      n = w - xx;
+      if ( n > f )
+	n = f;
+      c = color[(pixel >> i) & 1];
+      for( j = 0; j < n; j++ )
+      {
+	*p++ = c[0];
+	*p++ = c[1];
+	*p++ = c[2];
+      }
+      xx += n;
+    }
+  }
+}
+
 void tga_set_multiple_8pixel(int x, int y, int cnt, uint8_t *pixel, uint16_t f)
 {
-  uint8_t b;
+  uint8_t rows[8];
+  uint8_t r;
+  
+  /* with tga_is_transparent, only the set pixel are drawn: per byte as before */
+  if ( tga_is_transparent != 0 )
+  {
+    while( cnt > 0 )
+    {
+      tga_set_8pixel(x, y, *pixel, f);
+      x+=f;
+      pixel++;
+      cnt--;
+    }
+    return;
+  }
+  
+  /* transpose each group of 8 vertical bytes into 8 horizontal rows */
+  while( cnt >= 8 )
+  {
+    u8x8_transpose_8x8(pixel, rows);
+    for( r = 0; r < 8; r++ )
+      tga_set_8pixel_row(x, y+r*f, rows[r], f);
+    x+=8*f;
+    pixel+=8;
+    cnt-=8;
+  }
   while( cnt > 0 )
   {
-    b = *pixel;
-    tga_set_8pixel(x, y, b, f);
+    tga_set_8pixel(x, y, *pixel, f);
     x+=f;
     pixel++;
     cnt--;
@@ -0,0 +1,339 @@
+#include "u8g2.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Tile/row conversion with the 8x8 transpose kernels (u8x8_transpose.c)
+ * against the per pixel procedures used before. The output must be byte
+ * identical:
+ *   - u8x8_transpose_8x8() and u8x8_transpose_tiles() against a bit loop
+ *   - PBM/XBM capture (u8x8_capture_get_pixel_1/2, 1..40 x 1..4 tiles)
+ *     against the per pixel loop, which is still used for other get_pixel
+ *     procedures
+ *   - TGA device drawing, scale factor 1..3, opaque and transparent, against
+ *     tga_set_8pixel() for each byte (transparent drawing still uses the
+ *     per byte loop, both times must be the same)
+ *   - u8x8_SaveBitmapTGA() against a writer with u8x8_GetBitmapPixel()
+ *     for each pixel
+ * The time of the old and the new procedure is printed for each case.
+ * The program returns 1 if any of the outputs differ.
+ */
+
+/* not declared in u8x8.h */
+int tga_init(uint16_t w, uint16_t h);
+void tga_set_8pixel(int x, int y, uint8_t pixel, uint16_t f);
+void tga_set_multiple_8pixel(int x, int y, int cnt, uint8_t *pixel, uint16_t f);
+extern uint8_t tga_is_transparent;
+
+#define OUT_SIZE (1<<20)
+char out_buf[OUT_SIZE];
+size_t out_len;
+long out_calls;
+
+uint8_t buf[256*8*8];
+int errors;
+
+static uint32_t rnd_state = 1;
+static uint32_t rnd(void)
+{
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return rnd_state >> 16;
+}
+
+static double now_us(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec*1e6 + t.tv_nsec/1e3;
+}
+
+/* read a complete file, returns the number of bytes */
+static size_t read_file(const char *name, uint8_t *dest, size_t size)
+{
+  FILE *fp = fopen(name, "rb");
+  size_t len;
+  if ( fp == NULL )
+    return 0;
+  len = fread(dest, 1, size, fp);
+  fclose(fp);
+  return len;
+}
+
+/*=========================================*/
+/* kernels */
+
+static void check_kernels(void)
+{
+  uint8_t src[8], dest[8], ref[8];
+  uint8_t rows[8*50], tile[8];
+  long i;
+  int q, k, cnt, t, err = 0;
+
+  for( i = 0; i < 100000; i++ )
+  {
+    for( q = 0; q < 8; q++ )
+      src[q] = rnd();
+    u8x8_transpose_8x8(src, dest);
+    memset(ref, 0, 8);
+    for( q = 0; q < 8; q++ )
+      for( k = 0; k < 8; k++ )
+        if ( (src[q] >> k) & 1 )
+          ref[k] |= 1 << q;
+    if ( memcmp(dest, ref, 8) != 0 )
+      err++;
+  }
+
+  /* odd start address, rows after cnt must not be written */
+  for( cnt = 0; cnt < 40; cnt++ )
+  {
+    memset(rows, 0xee, sizeof(rows));
+    u8x8_transpose_tiles(buf+3, cnt, rows, 50);
+    for( t = 0; t < 50; t++ )
+    {
+      u8x8_transpose_8x8(buf+3+t*8, tile);
+      for( k = 0; k < 8; k++ )
+        if ( rows[k*50+t] != (t < cnt ? tile[k] : 0xee) )
+          err++;
+    }
+  }
+  printf("transpose kernels: %s\n", err == 0 ? "same bits" : "BIT MISMATCH");
+  errors += err;
+}
+
+/*=========================================*/
+/* PBM/XBM capture */
+
+static void out(const char *s)
+{
+  size_t l = strlen(s);
+  if ( out_len + l <= OUT_SIZE )
+    memcpy(out_buf + out_len, s, l);
+  out_len += l;
+  out_calls++;
+}
+
+/* other procedures than u8x8_capture_get_pixel_1/2 use the per pixel loop */
+static uint8_t pixel_get_pixel_1(uint16_t x, uint16_t y, uint8_t *dest_ptr, uint8_t tile_width)
+{
+  return u8x8_capture_get_pixel_1(x, y, dest_ptr, tile_width);
+}
+
+static uint8_t pixel_get_pixel_2(uint16_t x, uint16_t y, uint8_t *dest_ptr, uint8_t tile_width)
+{
+  return u8x8_capture_get_pixel_2(x, y, dest_ptr, tile_width);
+}
+
+typedef uint8_t (*get_pixel_fn)(uint16_t x, uint16_t y, uint8_t *dest_ptr, uint8_t tile_width);
+
+static void capture(int is_xbm, uint8_t tw, uint8_t th, get_pixel_fn get_pixel)
+{
+  out_len = 0;
+  if ( is_xbm )
+    u8x8_capture_write_xbm_buffer(buf, tw, th, get_pixel, out);
+  else
+    u8x8_capture_write_pbm_buffer(buf, tw, th, get_pixel, out);
+}
+
+static void check_capture(void)
+{
+  static char ref[OUT_SIZE];
+  static const get_pixel_fn fast[2] = { u8x8_capture_get_pixel_1, u8x8_capture_get_pixel_2 };
+  static const get_pixel_fn pixel[2] = { pixel_get_pixel_1, pixel_get_pixel_2 };
+  size_t ref_len;
+  int is_xbm, g, tw, th, i, err;
+  double t0, t1, t2;
+  long calls_ref, calls;
+
+  for( is_xbm = 0; is_xbm < 2; is_xbm++ )
+    for( g = 0; g < 2; g++ )
+    {
+      err = 0;
+      for( tw = 1; tw <= 40; tw++ )
+        for( th = 1; th <= 4; th++ )
+        {
+          capture(is_xbm, tw, th, pixel[g]);
+          ref_len = out_len;
+          memcpy(ref, out_buf, ref_len);
+          capture(is_xbm, tw, th, fast[g]);
+          if ( out_len != ref_len || memcmp(ref, out_buf, ref_len) != 0 )
+            err++;
+        }
+
+      out_calls = 0;
+      t0 = now_us();
+      for( i = 0; i < 200; i++ )
+        capture(is_xbm, 16, 8, pixel[g]);
+      calls_ref = out_calls / 200;
+      out_calls = 0;
+      t1 = now_us();
+      for( i = 0; i < 200; i++ )
+        capture(is_xbm, 16, 8, fast[g]);
+      t2 = now_us();
+      calls = out_calls / 200;
+
+      printf("%s get_pixel_%d 128x64: pixel loop %6.1f us (%4ld out), transpose %6.1f us (%4ld out), %s\n",
+        is_xbm ? "xbm" : "pbm", g+1, (t1-t0)/200, calls_ref, (t2-t1)/200, calls,
+        err == 0 ? "same output" : "OUTPUT MISMATCH");
+      errors += err;
+    }
+}
+
+/*=========================================*/
+/* TGA device */
+
+#define TGA_WIDTH 400
+
+/* 128x64 frame with 8 tile rows, followed by 13 tiles (partial group of 8) */
+static void tga_frame(int y, int f, int is_ref, int shift)
+{
+  int ty, i;
+  for( ty = 0; ty < 9; ty++ )
+  {
+    if ( is_ref )
+    {
+      /* per byte, as before */
+      for( i = 0; i < (ty < 8 ? 128 : 13); i++ )
+        tga_set_8pixel((ty < 8 ? 0 : 300) + i*f, y + ty*8*f, buf[ty*128 + shift + i], f);
+    }
+    else
+    {
+      tga_set_multiple_8pixel(ty < 8 ? 0 : 300, y + ty*8*f, ty < 8 ? 128 : 13, buf + ty*128 + shift, f);
+    }
+  }
+}
+
+static void check_tga(void)
+{
+  static uint8_t file[18 + TGA_WIDTH*2*9*8*3*3 + 64];
+  int f, tr, i, r, y, err;
+  int h;			/* height of one frame */
+  size_t len, row = TGA_WIDTH*3;
+  double t0, t1, t2, t_ref, t_new;
+
+  for( f = 1; f <= 3; f++ )
+    for( tr = 0; tr < 2; tr++ )
+    {
+      tga_is_transparent = tr;
+      h = 9*8*f;
+      /* reference frame at the top, new frame below */
+      tga_init(TGA_WIDTH, 2*h);
+      for( i = 0; i < 50; i++ )
+      {
+        tga_frame(0, f, 1, i);
+        tga_frame(h, f, 0, i);
+      }
+      tga_save("transpose_speed.tga");
+      len = read_file("transpose_speed.tga", file, sizeof(file));
+      err = len < 18 + 2*h*row;
+      /* the file starts with the lowest pixel row */
+      for( y = 0; y < h && err == 0; y++ )
+        if ( memcmp(file + 18 + (2*h-1-y)*row, file + 18 + (h-1-y)*row, row) != 0 )
+          err++;
+
+      /* both procedures in turn, the fastest of 10 rounds is printed */
+      t_ref = t_new = 1e30;
+      for( r = 0; r < 10; r++ )
+      {
+        t0 = now_us();
+        for( i = 0; i < 50; i++ )
+          tga_frame(0, f, 1, i);
+        t1 = now_us();
+        for( i = 0; i < 50; i++ )
+          tga_frame(h, f, 0, i);
+        t2 = now_us();
+        if ( t1-t0 < t_ref )
+          t_ref = t1-t0;
+        if ( t2-t1 < t_new )
+          t_new = t2-t1;
+      }
+      printf("tga factor %d %-11s frame: per byte %6.1f us, transpose %6.1f us, %s\n",
+        f, tr ? "transparent" : "opaque", t_ref/50, t_new/50, err == 0 ? "same pixels" : "PIXEL MISMATCH");
+      errors += err;
+    }
+  tga_is_transparent = 0;
+}
+
+/*=========================================*/
+/* bitmap device SaveTGA */
+
+u8x8_t u8x8;
+
+/* u8x8_SaveBitmapTGA() before the transpose: one pixel at a time */
+static void pixel_save_tga(uint16_t w, uint16_t h, const char *name)
+{
+  static const uint8_t header[18] = { 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 0 };
+  FILE *fp = fopen(name, "wb");
+  uint16_t x, y;
+  uint8_t c;
+  int k;
+  if ( fp == NULL )
+    return;
+  for( k = 0; k < 12; k++ )
+    fputc(header[k], fp);
+  fputc(w & 255, fp); fputc(w >> 8, fp);
+  fputc(h & 255, fp); fputc(h >> 8, fp);
+  fputc(header[16], fp); fputc(header[17], fp);
+  for( y = 0; y < h; y++ )
+    for( x = 0; x < w; x++ )
+    {
+      c = u8x8_GetBitmapPixel(&u8x8, x, h-y-1) ? 0 : 255;
+      fputc(c, fp); fputc(c, fp); fputc(c, fp);
+    }
+  for( k = 0; k < 8; k++ )
+    fputc(0, fp);
+  fwrite("TRUEVISION-XFILE.", 18, 1, fp);
+  fclose(fp);
+}
+
+static void check_save_tga(void)
+{
+  static const uint16_t dims[][2] = { { 128, 64 }, { 130, 61 }, { 7, 5 }, { 200, 200 } };
+  static uint8_t ref[18 + 200*200*3 + 64];
+  static uint8_t file[18 + 200*200*3 + 64];
+  size_t ref_len, len, j;
+  uint16_t w, h, ty, tw;
+  int i, err;
+  double t0, t1, t2;
+
+  for( j = 0; j < sizeof(dims)/sizeof(*dims); j++ )
+  {
+    w = dims[j][0];
+    h = dims[j][1];
+    u8x8_SetupBitmap(&u8x8, w, h);
+    tw = (w+7)/8;
+    for( ty = 0; ty < (h+7)/8; ty++ )
+      u8x8_DrawTile(&u8x8, 0, ty, tw, buf + ty*tw*8);
+
+    t0 = now_us();
+    for( i = 0; i < 20; i++ )
+      pixel_save_tga(w, h, "transpose_speed_ref.tga");
+    t1 = now_us();
+    for( i = 0; i < 20; i++ )
+      u8x8_SaveBitmapTGA(&u8x8, "transpose_speed.tga");
+    t2 = now_us();
+
+    ref_len = read_file("transpose_speed_ref.tga", ref, sizeof(ref));
+    len = read_file("transpose_speed.tga", file, sizeof(file));
+    err = ref_len == 0 || len != ref_len || memcmp(ref, file, len) != 0;
+    printf("SaveTGA %3dx%-3d: per pixel %6.1f us, transpose %6.1f us, %s\n",
+      w, h, (t1-t0)/20, (t2-t1)/20, err == 0 ? "same file" : "FILE MISMATCH");
+    errors += err;
+  }
+  remove("transpose_speed_ref.tga");
+}
+
+int main(void)
+{
+  size_t i;
+  for( i = 0; i < sizeof(buf); i++ )
+    buf[i] = rnd();
+
+  check_kernels();
+  check_capture();
+  check_tga();
+  check_save_tga();
+  remove("transpose_speed.tga");
+  return errors == 0 ? 0 : 1;
+}
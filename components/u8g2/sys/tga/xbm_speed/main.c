@@ -1,7 +1,21 @@
 
 #include "u8g2.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
+/*
+ * XBM drawing speed with and without the bitmap blit (U8G2_WITH_BITMAP_BLIT).
+ * The reference draws the bitmap row by row with u8g2_DrawHXBMP(), which
+ * is the hvline based procedure used by u8g2_DrawXBMP() without the blit.
+ * Both must produce the same pixels for all draw colors and bitmap modes.
+ *
+ * Box and line drawing with the word span fill of u8g2_ll_hvline.c is
+ * compared with the byte loops used before (vertical_top_lsb and
+ * horizontal_right_lsb buffer layouts, all draw colors).
+ * The program returns 1 if any of the pixels differ.
+ */
 
 #define u8g2_logo_128x64_width 128
 #define u8g2_logo_128x64_height 64
@@ -94,68 +108,258 @@ static unsigned char u8g2_logo_128x64_bits[] = {
    0x00, 0x00, 0x00, 0x00 };
 
   
+/* not declared in u8g2.h */
+void u8g2_DrawHXBMP(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, const uint8_t *b);
+
 u8g2_t u8g2;
 
-int main(void)
+#define ICON_SIZE 16
+static unsigned char icon_bits[ICON_SIZE*ICON_SIZE/8];
+
+uint32_t hash;
+
+void draw_xbm_rows(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, const uint8_t *bitmap)
+{
+  u8g2_uint_t blen = (w+7)/8;
+  while( h > 0 )
+  {
+    u8g2_DrawHXBMP(&u8g2, x, y, w, bitmap);
+    bitmap += blen;
+    y++;
+    h--;
+  }
+}
+
+void draw_scene(int i, int is_blit)
 {
-  int x, y;
   int k;
+  if ( is_blit )
+  {
+    u8g2_DrawXBMP(&u8g2, i & 63, 0, u8g2_logo_128x64_width, u8g2_logo_128x64_height, u8g2_logo_128x64_bits);
+    for( k = 0; k < 8; k++ )
+      u8g2_DrawXBMP(&u8g2, k*ICON_SIZE, (k*11+i) & 63, ICON_SIZE, ICON_SIZE, icon_bits);
+  }
+  else
+  {
+    draw_xbm_rows(i & 63, 0, u8g2_logo_128x64_width, u8g2_logo_128x64_height, u8g2_logo_128x64_bits);
+    for( k = 0; k < 8; k++ )
+      draw_xbm_rows(k*ICON_SIZE, (k*11+i) & 63, ICON_SIZE, ICON_SIZE, icon_bits);
+  }
+}
+
+/* 
+  returns the drawing time per frame in us (each page is drawn "cnt" times, 
+  the transfer to the tga device is not included), the page buffer content 
+  is added to "hash"
+*/
+double draw_loop(int cnt, int is_blit)
+{
+  clock_t t = 0;
+  clock_t start;
+  uint8_t *buf = u8g2_GetBufferPtr(&u8g2);
+  size_t len = 8*u8g2_GetBufferTileWidth(&u8g2)*u8g2_GetBufferTileHeight(&u8g2);
+  size_t j;
   int i;
+  
+  hash = 0;
+  u8g2_FirstPage(&u8g2);
+  do
+  {
+    start = clock();
+    for( i = 0; i < cnt; i++ )
+      draw_scene(i, is_blit);
+    t += clock() - start;
+    
+    /* compare a single frame */
+    memset(buf, 0, len);
+    draw_scene(0, is_blit);
+    for( j = 0; j < len; j++ )
+      hash = hash*31 + buf[j];
+  } while( u8g2_NextPage(&u8g2) );
+  return (double)t * 1e6 / CLOCKS_PER_SEC / cnt;
+}
 
-  u8g2_SetupBuffer_TGA_DESC(&u8g2, &u8g2_cb_r0);
-  u8x8_InitDisplay(u8g2_GetU8x8(&u8g2));
-  u8x8_SetPowerSave(u8g2_GetU8x8(&u8g2), 0);  
-  u8g2_SetFont(&u8g2, u8g2_font_helvB18_tr);
+/*=========================================*/
+/* boxes and lines: word span fill against the byte loop */
+
+/* u8g2_ll_hvline_vertical_top_lsb() before the word span fill */
+void byte_hvline_vertical_top_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir)
+{
+  uint8_t *ptr;
+  uint8_t bit_pos, or_mask, xor_mask;
   
-  x = 50;
-  y = 30+0;
+  bit_pos = y & 7;
+  ptr = u8g2->tile_buf_ptr + (uint32_t)(y & ~7)*u8g2_GetU8x8(u8g2)->display_info->tile_width + x;
+  or_mask = u8g2->draw_color <= 1 ? 1 << bit_pos : 0;
+  xor_mask = u8g2->draw_color != 1 ? 1 << bit_pos : 0;
+  do
+  {
+    *ptr |= or_mask;
+    *ptr ^= xor_mask;
+    len--;
+    if ( dir == 0 )
+    {
+      ptr++;
+    }
+    else if ( ++bit_pos == 8 )
+    {
+      bit_pos = 0;
+      ptr += u8g2->pixel_buf_width;
+      or_mask = or_mask ? 1 : 0;
+      xor_mask = xor_mask ? 1 : 0;
+    }
+    else
+    {
+      or_mask <<= 1;
+      xor_mask <<= 1;
+    }
+  } while( len != 0 );
+}
 
+/* u8g2_ll_hvline_horizontal_right_lsb() before the word span fill */
+void byte_hvline_horizontal_right_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir)
+{
+  uint8_t tile_width = u8g2_GetU8x8(u8g2)->display_info->tile_width;
+  uint8_t *ptr = u8g2->tile_buf_ptr + (uint32_t)y*tile_width + (x >> 3);
+  uint8_t mask = 128 >> (x & 7);
   
-#ifdef U8G2_WITH_HVLINE_COUNT
-    u8g2.hv_cnt = 0UL;
-#endif /* U8G2_WITH_HVLINE_COUNT */   
-    
-    /*
+  do
+  {
+    if ( u8g2->draw_color <= 1 )
+      *ptr |= mask;
+    if ( u8g2->draw_color != 1 )
+      *ptr ^= mask;
+    len--;
+    if ( dir == 0 )
+    {
+      mask >>= 1;
+      if ( mask == 0 )
+      {
+        mask = 128;
+        ptr++;
+      }
+    }
+    else
+    {
+      ptr += tile_width;
+    }
+  } while( len != 0 );
+}
+
+static uint32_t rnd_state;
+static uint32_t rnd(void)
+{
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return rnd_state >> 16;
+}
+
+/* status screen like frame: boxes, frames, bars and separator lines in all draw colors */
+void draw_boxes(int i)
+{
+  u8g2_uint_t w = u8g2_GetDisplayWidth(&u8g2);
+  u8g2_uint_t h = u8g2_GetDisplayHeight(&u8g2);
+  int k;
+  
+  rnd_state = i;
+  for( k = 0; k < 16; k++ )
+  {
+    u8g2_SetDrawColor(&u8g2, rnd() % 3);
+    u8g2_DrawBox(&u8g2, rnd() % w, rnd() % h, 1 + rnd() % (w/2), 1 + rnd() % 40);
+    u8g2_DrawFrame(&u8g2, rnd() % w, rnd() % h, 1 + rnd() % (w/2), 1 + rnd() % 40);
+    u8g2_DrawHLine(&u8g2, rnd() % w, rnd() % h, 1 + rnd() % w);
+    u8g2_DrawVLine(&u8g2, rnd() % w, rnd() % h, 1 + rnd() % h);
+  }
+}
+
+/* 
+  full frame buffer with the given hvline procedure, returns the drawing
+  time per frame in us, the buffer content of 50 frames is added to "hash"
+*/
+double box_loop(int cnt, u8g2_draw_ll_hvline_cb ll_hvline_cb)
+{
+  static uint8_t *buf;
+  const u8x8_display_info_t *info = u8g2_GetU8x8(&u8g2)->display_info;
+  size_t len = 8*info->tile_width*info->tile_height;
+  size_t j;
+  clock_t start;
+  int i;
+  
+  if ( buf == NULL )
+    buf = malloc(len);
+  u8g2_SetupBuffer(&u8g2, buf, info->tile_height, ll_hvline_cb, &u8g2_cb_r0);
+  
+  start = clock();
+  for( i = 0; i < cnt; i++ )
+    draw_boxes(i);
+  start = clock() - start;
+  
+  hash = 0;
+  for( i = 0; i < 50; i++ )
+  {
     u8g2_ClearBuffer(&u8g2);
-    
-      u8g2_SetFontDirection(&u8g2, 0);
-      u8g2_DrawStr(&u8g2, x, y, "ABC");
-      u8g2_SetFontDirection(&u8g2, 1);
-      u8g2_DrawStr(&u8g2, x, y, "abc");
-      u8g2_SetFontDirection(&u8g2, 2);
-      u8g2_DrawStr(&u8g2, x, y, "abc");
-      u8g2_SetFontDirection(&u8g2, 3);
-      u8g2_DrawStr(&u8g2, x, y, "abc");
-    
-    u8g2_SendBuffer(&u8g2);
-    */
+    draw_boxes(i);
+    for( j = 0; j < len; j++ )
+      hash = hash*31 + buf[j];
+  }
+  return (double)start * 1e6 / CLOCKS_PER_SEC / cnt;
+}
+
+int main(void)
+{
+  int mismatch = 0;
+  int cnt = 2000;
+  int color, mode;
+  int y;
+  double t_rows, t_blit;
+  uint32_t h_rows;
 
-    for( i = 0; i < 1000; i++ )
+  u8g2_SetupBuffer_TGA_DESC(&u8g2, &u8g2_cb_r0);
+  u8x8_InitDisplay(u8g2_GetU8x8(&u8g2));
+  u8x8_SetPowerSave(u8g2_GetU8x8(&u8g2), 0);  
+  
+  /* battery like icon from the logo area */
+  for( y = 0; y < ICON_SIZE; y++ )
+    memcpy(icon_bits + y*ICON_SIZE/8, u8g2_logo_128x64_bits + (y+8)*u8g2_logo_128x64_width/8 + 2, ICON_SIZE/8);
+  
+  for( mode = 0; mode < 2; mode++ )
+  {
+    u8g2_SetBitmapMode(&u8g2, mode);
+    for( color = 0; color < 3; color++ )
     {
-      u8g2_FirstPage(&u8g2);
-      do
-      {
-        u8g2_DrawXBMP(&u8g2, i,0, 128,64, u8g2_logo_128x64_bits);
-        /*
-        u8g2_SetFontDirection(&u8g2, 0);
-        u8g2_DrawStr(&u8g2, x, y, "ABC");
-        u8g2_SetFontDirection(&u8g2, 1);
-        u8g2_DrawStr(&u8g2, x, y, "abc");
-        u8g2_SetFontDirection(&u8g2, 2);
-        u8g2_DrawStr(&u8g2, x, y, "abc");
-        u8g2_SetFontDirection(&u8g2, 3);
-        u8g2_DrawStr(&u8g2, x, y, "abc");
-        */
-        
-
-      } while( u8g2_NextPage(&u8g2) );
+      u8g2_SetDrawColor(&u8g2, color);
+      t_rows = draw_loop(cnt, 0);
+      h_rows = hash;
+      t_blit = draw_loop(cnt, 1);
+      printf("color %d %-11s rows %7.2f us, blit %7.2f us per frame, %s\n",
+        color, mode ? "transparent" : "solid", t_rows, t_blit,
+        h_rows == hash ? "same pixels" : "PIXEL MISMATCH");
+      mismatch |= h_rows != hash;
     }
-#ifdef U8G2_WITH_HVLINE_COUNT
-    printf("hv cnt: %ld\n", u8g2.hv_cnt);
-#endif /* U8G2_WITH_HVLINE_COUNT */   
-    
+  }
+  
+  u8g2_SetBitmapMode(&u8g2, 0);
+  u8g2_SetDrawColor(&u8g2, 1);
+  u8g2_FirstPage(&u8g2);
+  do
+  {
+    draw_scene(0, 1);
+  } while( u8g2_NextPage(&u8g2) );
   tga_save("u8g2.tga");
   
-  return 0;
+  /* the tga buffer is replaced by a full frame buffer, no transfer to the device */
+  t_rows = box_loop(cnt, byte_hvline_vertical_top_lsb);
+  h_rows = hash;
+  t_blit = box_loop(cnt, u8g2_ll_hvline_vertical_top_lsb);
+  printf("boxes vertical_top_lsb     byte loop %7.2f us, word span %7.2f us per frame, %s\n",
+    t_rows, t_blit, h_rows == hash ? "same pixels" : "PIXEL MISMATCH");
+  mismatch |= h_rows != hash;
+  
+  t_rows = box_loop(cnt, byte_hvline_horizontal_right_lsb);
+  h_rows = hash;
+  t_blit = box_loop(cnt, u8g2_ll_hvline_horizontal_right_lsb);
+  printf("boxes horizontal_right_lsb byte loop %7.2f us, word span %7.2f us per frame, %s\n",
+    t_rows, t_blit, h_rows == hash ? "same pixels" : "PIXEL MISMATCH");
+  mismatch |= h_rows != hash;
+  
+  return mismatch;
 }
-
@@ -0,0 +1,47 @@
+#ifndef U8G2_FONT_SET_H
+#define U8G2_FONT_SET_H
+
+#include "hal_interface.h"
+
+#include <u8g2.h>
+
+// HAL 字型 (HAL_FONT_SMALL / HAL_FONT_LARGE) 與 u8g2 之間的連接
+// Esp32HAL 與 host 的 BenchHAL 共用，core_bench 量測到的就是韌體的字型處理
+// - 字型標頭只解析一次 (u8g2_font_info_t)，並建立 0..255 的 glyph 位移表，取代逐一走訪字型資料
+// - 已解碼字形快取: 狀態畫面反覆繪製相同的數字與字母，命中時直接以 byte 複製到 buffer
+class U8g2FontSet {
+public:
+    static const size_t GLYPH_CACHE_BYTES = 3072;
+
+    // 註冊 HAL 使用的字型並初始化快取 (不需要 u8g2_t，可在顯示器初始化前呼叫)
+    void begin();
+    // 在 u8g2_Setup_*() 之後呼叫: 讓 u8g2 使用字形快取
+    void attach(u8g2_t* u8g2) { u8g2_SetGlyphCache(u8g2, &_glyphCache); }
+
+    // 已是目前字型時 u8g2_SetFontWithInfo() 不做任何事
+    void select(u8g2_t* u8g2, int fontSize) {
+        Slot& f = _fonts[slot(fontSize)];
+        u8g2_SetFontWithInfo(u8g2, f.font, &f.info);
+        u8g2_SetGlyphIndex(u8g2, &f.index);
+    }
+    const u8g2_font_info_t& info(int fontSize) const { return _fonts[slot(fontSize)].info; }
+    void metrics(int fontSize, HalFontMetrics& out) const;
+
+private:
+    struct Slot {
+        const uint8_t* font;
+        u8g2_font_info_t info;      // 註冊時解析一次
+        u8g2_glyph_index_t index;
+    };
+
+    Slot _fonts[HAL_FONT_COUNT];
+    u8g2_glyph_cache_t _glyphCache;
+    uint8_t _glyphArena[GLYPH_CACHE_BYTES];
+
+    static int slot(int fontSize) {
+        return (fontSize >= 0 && fontSize < HAL_FONT_COUNT) ? fontSize : HAL_FONT_SMALL;
+    }
+    void add(int fontSize, const uint8_t* font);
+};
+
+#endif // U8G2_FONT_SET_H
@@ -0,0 +1,32 @@
+#include "u8g2_font_set.h"
+
+void U8g2FontSet::begin() {
+    add(HAL_FONT_SMALL, u8g2_font_6x10_tf);
+    add(HAL_FONT_LARGE, u8g2_font_profont17_tf);
+
+    // 依最大的字形決定每個快取 slot 的大小
+    uint16_t maxBytes = 0;
+    for (int i = 0; i < HAL_FONT_COUNT; i++) {
+        const u8g2_font_info_t& info = _fonts[i].info;
+        uint16_t bytes = (uint16_t)(info.max_char_width * ((info.max_char_height + 7) / 8));
+        if (bytes > maxBytes) maxBytes = bytes;
+    }
+    u8g2_InitGlyphCache(&_glyphCache, _glyphArena, sizeof(_glyphArena), maxBytes);
+}
+
+void U8g2FontSet::metrics(int fontSize, HalFontMetrics& out) const {
+    const u8g2_font_info_t& i = info(fontSize);
+    out.ascent = i.ascent_A;
+    out.descent = i.descent_g;
+    out.maxWidth = i.max_char_width;
+    out.maxHeight = i.max_char_height;
+}
+
+void U8g2FontSet::add(int fontSize, const uint8_t* font) {
+    Slot& f = _fonts[fontSize];
+    f.font = font;
+    u8g2_read_font_info(&f.info, font);
+    // 兩個字型都只有 32-255，不需要 unicode 表
+    u8g2_InitGlyphIndex(&f.index, NULL, 0);
+    u8g2_BuildGlyphIndex(&f.index, font);
+}
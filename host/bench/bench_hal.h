@@ -0,0 +1,96 @@
+#ifndef BENCH_HAL_H
+#define BENCH_HAL_H
+
+#include "hal_interface.h"
+#include "u8g2_font_set.h"
+
+#include <u8g2.h>
+
+#include <string.h>
+#include <string>
+
+// core_bench 使用的 HAL
+// 時間固定 (避免週期性工作干擾)，CAN/UART 從預先準備的資料循環讀取，
+// 顯示畫到 u8g2 記憶體 buffer (不送出到 I2C)
+// final 且全部定義在 class 內: core_bench_static 以 BenchHAL 具現化熱路徑模組時，HAL 呼叫可 inline
+class BenchHAL final : public IHardwareHAL {
+public:
+    BenchHAL() : tick(1000), canTxCount(0), _rxLeft(0), _rxTimeUs(0), _uartPos(0), _uartLeft(0) {
+        memset(&_rxFrame, 0, sizeof(_rxFrame));
+        u8g2_Setup_ssd1306_128x64_noname_f(&_u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+        u8g2_InitDisplay(&_u8g2);
+        // 字型與字形快取使用 Esp32HAL 的同一份程式碼 (u8g2_glue)
+        _fontSet.begin();
+        _fontSet.attach(&_u8g2);
+    }
+
+    void init() override {}
+    void getBootTimes(HalBootTimes& out) override { memset(&out, 0, sizeof(out)); }
+    uint32_t getTickCount() override { return tick; }
+    void delayMs(uint32_t ms) override { tick += ms; }
+    uint32_t waitEvents(uint32_t deadline) override {
+        if (halTickBefore(tick, deadline)) tick = deadline;
+        return 0;
+    }
+    bool readButton(HalButton) override { return false; }
+
+    bool canSend(const HalCanFrame& frame) override { lastTx = frame; canTxCount++; return true; }
+    bool canReceive(HalCanFrame& frame) override {
+        if (_rxLeft == 0) return false;
+        _rxLeft--;
+        frame = _rxFrame;
+        _rxTimeUs += 100000; // 每個 frame 間隔 100 ms，讓電量積分實際執行
+        frame.timestampUs = _rxTimeUs;
+        return true;
+    }
+    void canGetStats(HalCanStats& out) override { memset(&out, 0, sizeof(out)); out.state = HAL_CAN_RUNNING; }
+    bool canRecover() override { return true; } // CAN:RECOVER 量測成功路徑
+
+    bool storageRead(const char*, void*, size_t) override { return false; }
+    bool storageWrite(const char*, const void*, size_t) override { return true; }
+    bool storageCommit() override { return true; }
+
+    void uartSend(const char*) override {}
+    int uartRead() override {
+        if (_uartLeft == 0) return -1;
+        _uartLeft--;
+        int c = (uint8_t)_uartData[_uartPos++];
+        if (_uartPos >= _uartData.size()) _uartPos = 0;
+        return c;
+    }
+    int uartAvailable() override { return (int)_uartLeft; }
+
+    void displayClear() override { u8g2_ClearBuffer(&_u8g2); }
+    void displayDrawString(int x, int y, const char* str, int fontSize) override {
+        _fontSet.select(&_u8g2, fontSize);
+        u8g2_DrawStr(&_u8g2, x, y + 8, str);
+    }
+    void displayShow() override {}
+    int displayTextWidth(const char* str, int fontSize) override {
+        _fontSet.select(&_u8g2, fontSize);
+        return u8g2_GetStrWidth(&_u8g2, str);
+    }
+    void displayFontMetrics(int fontSize, HalFontMetrics& out) override { _fontSet.metrics(fontSize, out); }
+
+    // 接下來 canReceive() 會回傳 count 個 frame
+    void queueCan(const HalCanFrame& frame, uint32_t count) { _rxFrame = frame; _rxLeft = count; }
+    // 接下來 uartRead() 會回傳 count 個字元 (循環讀取 data)
+    void setUart(const std::string& data) { _uartData = data; _uartPos = 0; }
+    void queueUart(size_t count) { _uartLeft = count; }
+
+    uint32_t tick;
+    uint32_t canTxCount;
+    HalCanFrame lastTx;
+
+private:
+    u8g2_t _u8g2;
+    U8g2FontSet _fontSet;
+    HalCanFrame _rxFrame;
+    uint32_t _rxLeft;
+    uint32_t _rxTimeUs;
+    std::string _uartData;
+    size_t _uartPos;
+    size_t _uartLeft;
+};
+
+#endif // BENCH_HAL_H
@@ -0,0 +1,422 @@
+// core_logic 熱路徑微基準 (Host)
+// 用法: core_bench [--format csv|json] [--out FILE] [--baseline FILE] [--threshold PCT]
+//                  [--min-ms N] [--filter SUBSTR]
+//   --baseline   與先前輸出的 CSV/JSON 比較，任何項目變慢超過 threshold (預設 10%) 時回傳 1
+#include "bench_hal.h"
+#include "psu_protocol.h"
+#include "psu_bus.h"
+#include "output_ctrl.h"
+#include "load_share.h"
+#include "can_health.h"
+#include "profile_seq.h"
+#include "charge_ctrl.h"
+#include "energy_log.h"
+#include "telemetry_stats.h"
+#include "config_store.h"
+#include "boot_seq.h"
+#include "app_ui_impl.h"
+#include "serial_cmd_impl.h"
+
+#include <chrono>
+#include <map>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// 熱路徑模組 (PsuBusT、AppUIT、SerialCmdT) 的 HAL 類別
+// core_bench: IHardwareHAL (vtable)；core_bench_static (-DBENCH_STATIC_HAL): BenchHAL 直接呼叫
+// core_logic 只編譯一次，兩者只有這個檔案不同 (make bench-hal 比較)
+#if defined(BENCH_STATIC_HAL)
+typedef BenchHAL BenchHalType;
+#else
+typedef IHardwareHAL BenchHalType;
+#endif
+
+// --- Allocation Counter ---
+
+static unsigned long long g_allocCount = 0;
+
+void* operator new(size_t size) {
+    g_allocCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+#ifdef __GLIBC__
+// 攔截 C 端配置 (例如 printf 家族內部配置)
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void* malloc(size_t size) { g_allocCount++; return __libc_malloc(size); }
+extern "C" void* calloc(size_t n, size_t size) { g_allocCount++; return __libc_calloc(n, size); }
+extern "C" void* realloc(void* p, size_t size) { g_allocCount++; return __libc_realloc(p, size); }
+#endif
+
+static HalCanFrame makeStatusFrame(uint16_t rawI, uint16_t rawV, bool hwOff) {
+    HalCanFrame f;
+    memset(&f, 0, sizeof(f));
+    f.id = 0x1807C080 + PSU_ADDRESS;
+    f.len = 8;
+    f.ext = true;
+    f.data[0] = 0x01;
+    f.data[2] = rawI >> 8; f.data[3] = rawI & 0xFF;
+    f.data[4] = rawV >> 8; f.data[5] = rawV & 0xFF;
+    f.data[7] = hwOff ? 0x01 : 0x00;
+    return f;
+}
+
+// PSU 進入「已開機、非軟啟動」狀態，setOutput() 會直接送出設定指令
+static void bringUpRunning(BenchHAL& hal, PsuBusT<BenchHalType>& bus) {
+    bus.begin(PSU_ADDRESS);
+    hal.queueCan(makeStatusFrame(500, 1000, false), 1);
+    bus.loop();
+}
+
+// --- Runner ---
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp;
+    double allocsPerOp;
+    unsigned long long ops;
+};
+
+typedef void (*BenchFn)(void* ctx, uint32_t iterations);
+
+static double g_minMs = 200.0;
+
+// 自動校正迭代次數，重複 5 輪取最快的一輪
+static BenchResult runBench(const char* name, BenchFn fn, void* ctx, uint32_t opsPerIter) {
+    typedef std::chrono::steady_clock Clock;
+    uint32_t iters = 16;
+    for (;;) {
+        Clock::time_point t0 = Clock::now();
+        fn(ctx, iters);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms >= g_minMs / 5 || iters >= (1u << 30)) break;
+        iters *= 2;
+    }
+
+    BenchResult r;
+    r.name = name;
+    r.nsPerOp = 1e30;
+    r.allocsPerOp = 0;
+    r.ops = (unsigned long long)iters * opsPerIter;
+    for (int round = 0; round < 5; round++) {
+        unsigned long long allocs0 = g_allocCount;
+        Clock::time_point t0 = Clock::now();
+        fn(ctx, iters);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        double perOp = ns / r.ops;
+        if (perOp < r.nsPerOp) r.nsPerOp = perOp;
+        r.allocsPerOp = (double)(g_allocCount - allocs0) / r.ops;
+    }
+    return r;
+}
+
+// --- Benchmarks ---
+
+struct CoreCtx {
+    BenchHAL hal;
+    PsuBusT<BenchHalType> bus;
+    PowerProtocol& psu;
+    OutputControl out;
+    SerialCmdT<BenchHalType> serial;
+    AppUIT<BenchHalType> ui;
+    CoreCtx() : bus(&hal), psu(*bus.addModule()), out(&bus), serial(&hal, &psu, &out), ui(&hal, &psu, &out) {}
+};
+
+static const uint32_t FRAMES_PER_LOOP = 64;
+
+static void benchParseFrame(void* p, uint32_t n) {
+    CoreCtx* c = (CoreCtx*)p;
+    HalCanFrame f = makeStatusFrame(523, 1001, false);
+    for (uint32_t i = 0; i < n; i++) {
+        c->hal.queueCan(f, FRAMES_PER_LOOP);
+        c->bus.loop();
+    }
+}
+
+static void benchSendSet(void* p, uint32_t n) {
+    CoreCtx* c = (CoreCtx*)p;
+    for (uint32_t i = 0; i < n; i++) {
+        c->psu.setOutput(100.0f + (i & 7), 50.0f);
+    }
+}
+
+// 指令基準: 與 main.cpp 相同，所有模組都註冊到 SerialCmd 的指令表
+struct SerialCtx {
+    CoreCtx core;
+    ConfigStore config;
+    LoadShare share;
+    CanHealth can;
+    ProfileSequencer profile;
+    ChargeController charger;
+    EnergyLog energy;
+    TelemetryStats stats;
+    BootSequencer boot;
+    size_t lineLen;
+    SerialCtx()
+        : config(&core.hal), share(&core.hal, &core.out), can(&core.hal),
+          profile(&core.hal, &core.psu, &core.out), charger(&core.hal, &core.psu, &core.out),
+          energy(&core.hal, &core.bus), stats(&core.hal, &core.psu), boot(&core.hal, &core.bus), lineLen(0) {
+        CmdRegistry& reg = core.serial.registry();
+        config.begin();
+        energy.begin();
+        stats.begin();
+        config.registerCommands(reg);
+        share.registerCommands(reg);
+        can.registerCommands(reg);
+        profile.registerCommands(reg);
+        charger.registerCommands(reg);
+        energy.registerCommands(reg);
+        stats.registerCommands(reg);
+        boot.registerCommands(reg);
+        // 與 main.cpp 相同的指令集合必須全部放得進指令表
+        if (reg.rejected()) {
+            fprintf(stderr, "command table: %d rejected, first %s\n", reg.rejected(), reg.firstRejected());
+            exit(2);
+        }
+    }
+};
+
+static void benchSerialLine(void* p, uint32_t n) {
+    SerialCtx* c = (SerialCtx*)p;
+    for (uint32_t i = 0; i < n; i++) {
+        c->core.hal.queueUart(c->lineLen);
+        c->core.serial.loop();
+    }
+}
+
+static void benchDrawScreen(void* p, uint32_t n) {
+    CoreCtx* c = (CoreCtx*)p;
+    for (uint32_t i = 0; i < n; i++) {
+        c->ui.loop();
+    }
+}
+
+static void benchSuperloop(void* p, uint32_t n) {
+    CoreCtx* c = (CoreCtx*)p;
+    HalCanFrame f = makeStatusFrame(523, 1001, false);
+    for (uint32_t i = 0; i < n; i++) {
+        c->hal.tick += 1; // 模擬 1 ms 週期，讓週期性查詢/回報照常發生
+        if ((i % 100) == 0) c->hal.queueCan(f, 1);
+        c->bus.loop();
+        c->ui.loop();
+        c->serial.loop();
+    }
+}
+
+// 量測前先執行一次: 除了 unknown 之外，每一行都必須成功 (否則量到的是錯誤路徑)
+// 成對的指令會回到原狀態，之後的量測從相同狀態開始
+static void checkCommandLines(CmdRegistry& reg, const char* name, const std::string& lines) {
+    size_t pos = 0;
+    while (pos < lines.size()) {
+        size_t eol = lines.find('\n', pos);
+        std::string line = lines.substr(pos, eol - pos);
+        char buf[64];
+        char reply[192];
+        snprintf(buf, sizeof(buf), "%s", line.c_str());
+        if (reg.dispatch(buf, reply, sizeof(reply)) != CMD_OK && !strstr(name, "unknown")) {
+            fprintf(stderr, "%s: %s -> %s\n", name, line.c_str(), reply);
+        }
+        pos = eol + 1;
+    }
+}
+
+// --- Output / Baseline ---
+
+static void writeCsv(FILE* out, const std::vector<BenchResult>& results) {
+    fprintf(out, "name,ns_per_op,allocs_per_op,ops\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(out, "%s,%.2f,%.3f,%llu\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.ops);
+    }
+}
+
+static void writeJson(FILE* out, const std::vector<BenchResult>& results) {
+    fprintf(out, "[\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(out, "  {\"name\": \"%s\", \"ns_per_op\": %.2f, \"allocs_per_op\": %.3f, \"ops\": %llu}%s\n",
+                r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.ops, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(out, "]\n");
+}
+
+// 讀取 CSV 或 JSON (本程式輸出的格式) 的 name -> ns_per_op
+static bool loadBaseline(const char* path, std::map<std::string, double>& out) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        const char* nameKey = strstr(line, "\"name\": \"");
+        if (nameKey) {
+            const char* s = nameKey + 9;
+            const char* e = strchr(s, '"');
+            const char* v = strstr(line, "\"ns_per_op\": ");
+            if (e && v) out[std::string(s, e - s)] = strtod(v + 13, NULL);
+            continue;
+        }
+        char* comma = strchr(line, ',');
+        if (!comma || strncmp(line, "name,", 5) == 0) continue;
+        out[std::string(line, comma - line)] = strtod(comma + 1, NULL);
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* format = "csv";
+    const char* outPath = NULL;
+    const char* baselinePath = NULL;
+    const char* filter = NULL;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--format") && i + 1 < argc) format = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) baselinePath = argv[++i];
+        else if (!strcmp(argv[i], "--threshold") && i + 1 < argc) threshold = strtod(argv[++i], NULL);
+        else if (!strcmp(argv[i], "--min-ms") && i + 1 < argc) g_minMs = strtod(argv[++i], NULL);
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--format csv|json] [--out FILE] [--baseline FILE] "
+                            "[--threshold PCT] [--min-ms N] [--filter SUBSTR]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<BenchResult> results;
+#define RUN(name, fn, ctx, ops) \
+    if (!filter || strstr(name, filter)) results.push_back(runBench(name, fn, ctx, ops))
+
+    {
+        CoreCtx c;
+        bringUpRunning(c.hal, c.bus);
+        RUN("psu.parseFrame", benchParseFrame, &c, FRAMES_PER_LOOP);
+    }
+    {
+        CoreCtx c;
+        bringUpRunning(c.hal, c.bus);
+        RUN("psu.sendSetCommand", benchSendSet, &c, 1);
+    }
+
+    // 每個指令一行; 會改變狀態的指令與復原指令成對執行 (ns/op 為每行的平均)
+    // setup 在量測前執行一次 (例如 PROF:RUN 需要先有步驟)
+    static const struct { const char* name; const char* line; const char* setup; } commands[] = {
+        { "serial.cmd.ON",          "ON\n",                                 NULL },
+        { "serial.cmd.OFF",         "OFF\n",                                NULL },
+        { "serial.cmd.SET_V",       "SET:V=100.0\n",                        NULL },
+        { "serial.cmd.SET_I",       "SET:I=50.0\n",                         NULL },
+        { "serial.cmd.GET_AC",      "GET:AC\n",                             NULL },
+        { "serial.cmd.CFG_V",       "CFG:V=100.0\nCFG:V=101.0\n",          NULL },
+        { "serial.cmd.CFG_ADDR",    "CFG:ADDR=1\n",                         NULL },
+        { "serial.cmd.GET_CFG",     "GET:CFG\n",                            NULL },
+        { "serial.cmd.CFG_SAVE",    "CFG:SAVE\n",                           NULL },
+        { "serial.cmd.CFG_RESET",   "CFG:RESET\n",                          NULL },
+        { "serial.cmd.SHARE_I",     "SHARE:I=60.0,100.0\n",                 NULL },
+        { "serial.cmd.SHARE_OFF",   "SHARE:I=60.0,100.0\nSHARE:OFF\n",     NULL },
+        { "serial.cmd.GET_SHARE",   "GET:SHARE\n",                          NULL },
+        { "serial.cmd.GET_CAN",     "GET:CAN\n",                            NULL },
+        { "serial.cmd.CAN_RECOVER", "CAN:RECOVER\n",                        NULL },
+        { "serial.cmd.PROF_ADD",    "PROF:ADD=5000,50.0,20.0,2,1.5\nPROF:CLR\n", NULL },
+        { "serial.cmd.PROF_RUN",    "PROF:RUN=3\nPROF:ABORT\n",            "PROF:ADD=5000,50.0,20.0\n" },
+        { "serial.cmd.PROF_PAUSE",  "PROF:PAUSE\nPROF:RESUME\n",           "PROF:ADD=5000,50.0,20.0\nPROF:RUN=0\n" },
+        { "serial.cmd.GET_PROF",    "GET:PROF\n",                           "PROF:ADD=5000,50.0,20.0\nPROF:RUN=0\n" },
+        { "serial.cmd.CHG_SET",     "CHG:SET=56.4,30.0,2.0,54.0,1.0\n",     NULL },
+        { "serial.cmd.CHG_PRE",     "CHG:PRE=40.0,5.0\n",                   NULL },
+        { "serial.cmd.CHG_LIM",     "CHG:LIM=100.0,600,58.0\n",             NULL },
+        { "serial.cmd.CHG_START",   "CHG:START\nCHG:STOP\n",               "CHG:SET=56.4,30.0,2.0\n" },
+        { "serial.cmd.GET_CHG",     "GET:CHG\n",                            "CHG:SET=56.4,30.0,2.0\nCHG:START\n" },
+        { "serial.cmd.GET_ENERGY",  "GET:ENERGY\n",                         NULL },
+        { "serial.cmd.ENERGY_RESET", "ENERGY:RESET\n",                      NULL },
+        { "serial.cmd.ENERGY_SAVE", "ENERGY:SAVE\n",                        NULL },
+        { "serial.cmd.GET_STAT",    "GET:STAT=1\n",                         NULL },
+        { "serial.cmd.STAT_WIN",    "STAT:WIN=1,5.0\n",                     NULL },
+        { "serial.cmd.STAT_AUTO",   "STAT:AUTO=0\n",                        NULL },
+        { "serial.cmd.GET_BOOT",    "GET:BOOT\n",                           NULL },
+        { "serial.cmd.unknown",     "FOO\n",                                NULL },
+    };
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        SerialCtx c;
+        bringUpRunning(c.core.hal, c.core.bus);
+        c.core.serial.loop(); // 先送出第一次週期回報
+        if (commands[i].setup) {
+            c.core.hal.setUart(commands[i].setup);
+            c.core.hal.queueUart(strlen(commands[i].setup));
+            c.core.serial.loop();
+        }
+        std::string lines(commands[i].line);
+        uint32_t lineCount = 0;
+        for (size_t k = 0; k < lines.size(); k++) lineCount += (lines[k] == '\n') ? 1 : 0;
+        if (!filter || strstr(commands[i].name, filter)) checkCommandLines(c.core.serial.registry(), commands[i].name, lines);
+        c.core.hal.setUart(lines);
+        c.lineLen = lines.size();
+        RUN(commands[i].name, benchSerialLine, &c, lineCount);
+    }
+    {
+        // 行組合器: 每個字元的成本 (63 字元的未知指令)
+        SerialCtx c;
+        bringUpRunning(c.core.hal, c.core.bus);
+        c.core.serial.loop();
+        std::string line(63, 'X');
+        line += "\r\n";
+        c.core.hal.setUart(line);
+        c.lineLen = line.size();
+        RUN("serial.lineAssembler.byte", benchSerialLine, &c, (uint32_t)c.lineLen);
+    }
+    {
+        CoreCtx c;
+        bringUpRunning(c.hal, c.bus);
+        RUN("ui.drawScreen", benchDrawScreen, &c, 1);
+    }
+    {
+        CoreCtx c;
+        bringUpRunning(c.hal, c.bus);
+        RUN("main.superloop", benchSuperloop, &c, 1);
+    }
+#undef RUN
+
+    FILE* out = stdout;
+    if (outPath) {
+        out = fopen(outPath, "w");
+        if (!out) { perror(outPath); return 2; }
+    }
+    if (!strcmp(format, "json")) writeJson(out, results);
+    else writeCsv(out, results);
+    if (out != stdout) fclose(out);
+
+    if (!baselinePath) return 0;
+
+    std::map<std::string, double> baseline;
+    if (!loadBaseline(baselinePath, baseline)) {
+        perror(baselinePath);
+        return 2;
+    }
+    int regressions = 0;
+    fprintf(stderr, "%-28s %12s %12s %8s\n", "name", "baseline", "current", "delta");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        std::map<std::string, double>::const_iterator it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0) {
+            fprintf(stderr, "%-28s %12s %12.2f %8s\n", r.name.c_str(), "-", r.nsPerOp, "new");
+            continue;
+        }
+        double delta = (r.nsPerOp - it->second) * 100.0 / it->second;
+        bool bad = delta > threshold;
+        if (bad) regressions++;
+        fprintf(stderr, "%-28s %12.2f %12.2f %+7.1f%%%s\n",
+                r.name.c_str(), it->second, r.nsPerOp, delta, bad ? "  REGRESSION" : "");
+    }
+    return regressions ? 1 : 0;
+}
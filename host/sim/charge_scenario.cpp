@@ -0,0 +1,137 @@
+// 充電狀態機情境: CC -> CV -> DONE / FLOAT，以及 OV / OC / PSU / COMM 保護跳脫
+// 電池以電動勢 + 內阻模擬，電動勢隨充入電荷上升，CV 階段電流自然下降
+#include "sim_rig.h"
+#include "psu_policy.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// CHG:ST= 主動回報濃縮成 "CC>CV>DONE/TAPER"，結束狀態附上結束原因 / 故障
+static std::string chargeTrace(const SimRig& rig) {
+    std::string all = rig.lines("CHG:ST=");
+    std::string trace;
+    size_t pos = 0;
+    while (pos < all.size()) {
+        size_t eol = all.find('\n', pos);
+        std::string l = all.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        std::string st = l.substr(7, l.find(',') - 7);
+        if (!trace.empty()) trace += '>';
+        trace += st;
+        if (st == "DONE") trace += "/" + l.substr(l.find("END=") + 4, l.find(",ERR=") - l.find("END=") - 4);
+        if (st == "FAULT") trace += "/" + l.substr(l.find("ERR=") + 4);
+    }
+    return trace;
+}
+
+static void setParams(SimRig& rig, float floatVolts) {
+    ChargeParams& p = rig.charger.params();
+    p.cvVolts = 100.0f;
+    p.ccAmps = 20.0f;
+    p.taperAmps = 2.0f;
+    p.floatVolts = floatVolts;
+    p.floatAmps = 5.0f;
+}
+
+// 模塊啟動 1.5 s (超過 3 次狀態回報) 不可判定為故障; 充電量與模型側積分一致
+static void caseTaper(SimCheck& chk) {
+    SimRig rig;
+    rig.module.setStartupDelay(1500);
+    rig.boot();
+    setParams(rig, 0.0f);
+    rig.startBattery(90.0f, 0.1f, 0.004f);
+
+    chk.expect(rig.charger.start(), "taper: start");
+    rig.runFor(1000);
+    chk.expect(rig.charger.state() == CHG_CC, "taper: still CC during module startup", chargeTrace(rig));
+    std::string reply = rig.command("SHARE:I=10");
+    chk.expect(reply == "ERR:STATE:SHARE:I", "taper: SHARE rejected while charging", reply);
+    chk.expect(!rig.out.isFree() && rig.out.owner() == OUT_OWNER_CHARGER, "taper: charger owns output");
+
+    rig.runFor(10 * 60 * 1000);
+    std::string trace = chargeTrace(rig);
+    chk.expect(trace == "CC>CV>DONE/TAPER", "taper: CC>CV>DONE/TAPER", trace);
+    chk.expect(!rig.module.isRunning(), "taper: module off after DONE");
+    chk.expect(rig.out.isFree(), "taper: output released");
+
+    double ah = rig.charger.chargedAh();
+    chk.expect(ah > 0.5 && fabs(ah - rig.deliveredAh) < rig.deliveredAh * 0.02 + 0.002,
+               "taper: charged Ah matches delivered charge");
+    printf("taper: %s, %.3f Ah (model %.3f Ah)\n", trace.c_str(), ah, rig.deliveredAh);
+
+    // 結束後手動開機的電量不計入
+    rig.command("ON");
+    rig.runFor(5000);
+    chk.expect(fabs(rig.charger.chargedAh() - ah) < 1e-6, "taper: Ah frozen after DONE");
+    chk.expect(rig.command("SHARE:I=10").compare(0, 14, "CMD_ACK:SHARE:") == 0, "taper: SHARE accepted after DONE");
+}
+
+// 浮充持續到手動停止; OFF 指令關閉所有模塊並結束充電
+static void caseFloat(SimCheck& chk) {
+    SimRig rig;
+    rig.boot();
+    setParams(rig, 98.0f);
+    rig.startBattery(90.0f, 0.1f, 0.004f);
+    chk.expect(rig.charger.start(), "float: start");
+    rig.runFor(10 * 60 * 1000);
+    chk.expect(rig.charger.state() == CHG_FLOAT, "float: in FLOAT", chargeTrace(rig));
+    chk.expect(fabsf(rig.module.setVoltage() - 98.0f) < 0.01f, "float: module at float voltage");
+
+    chk.expect(rig.command("OFF") == "CMD_ACK:OFF", "float: OFF");
+    rig.runFor(1000);
+    std::string trace = chargeTrace(rig);
+    chk.expect(trace == "CC>CV>FLOAT>DONE/STOP", "float: CC>CV>FLOAT>DONE/STOP", trace);
+    chk.expect(!rig.module.isRunning() && rig.out.isFree(), "float: module off, output released");
+}
+
+// 以 CAN 直接改寫模塊設定值，模擬其他主機 / 控制器搶寫輸出
+static void overrideModule(SimRig& rig, float volts, float amps) {
+    HalCanFrame f;
+    PsuPolicy::encodeSetOutput(PSU_ADDRESS, volts, amps, f);
+    rig.module.handleFrame(f);
+}
+
+// 跳脫: fault 發生的時間 (相對開始) 與預期的結束狀態
+static void caseTrip(SimCheck& chk, const char* name, const char* expected, uint32_t minMs, uint32_t maxMs,
+                     void (*inject)(SimRig&), uint32_t startupMs) {
+    SimRig rig;
+    rig.module.setStartupDelay(startupMs);
+    rig.boot();
+    setParams(rig, 0.0f);
+    rig.startBattery(90.0f, 0.1f, 0.004f);
+    chk.expect(rig.charger.start(), name);
+    uint64_t t0 = rig.hal.now();
+    rig.runFor(2000);
+    inject(rig);
+    while (rig.charger.isActive() && rig.hal.now() - t0 < 60000) rig.runFor(10);
+    uint32_t at = (uint32_t)(rig.hal.now() - t0);
+
+    std::string trace = chargeTrace(rig);
+    char what[96];
+    snprintf(what, sizeof(what), "%s: %s within %lu..%lu ms (tripped at %lu ms)", name, expected,
+             (unsigned long)minMs, (unsigned long)maxMs, (unsigned long)at);
+    chk.expect(trace == expected && at >= minMs && at <= maxMs, what, trace);
+    // 失聯的模塊收不到關機指令，只能確認控制器已下令關機
+    chk.expect(!rig.psu.getStatus().isOn && rig.out.isFree(), name);
+}
+
+static void injectNone(SimRig& rig) { (void)rig; }
+static void injectOv(SimRig& rig) { rig.emf = 110.0f; }
+static void injectOc(SimRig& rig) { overrideModule(rig, 100.0f, 40.0f); }
+static void injectFault(SimRig& rig) { rig.module.setFault(true); }
+static void injectOffline(SimRig& rig) { rig.module.setOffline(true); }
+
+int runChargeScenario() {
+    SimCheck chk("charge");
+    caseTaper(chk);
+    caseFloat(chk);
+    caseTrip(chk, "ov",   "CC>FAULT/OV",   2000, 2300, injectOv, 0);
+    caseTrip(chk, "oc",   "CC>FAULT/OC",   2000, 2500, injectOc, 0);
+    caseTrip(chk, "psu",  "CC>FAULT/PSU",  2000, 2500, injectFault, 0);
+    caseTrip(chk, "comm", "CC>FAULT/COMM", 2900, 3200, injectOffline, 0);
+    // 模塊一直沒有啟動: 啟動等待時間過後才判定
+    caseTrip(chk, "startup", "CC>FAULT/PSU", CHARGE_STARTUP_MS, CHARGE_STARTUP_MS + 500, injectNone, 60000);
+    return chk.finish();
+}
@@ -0,0 +1,262 @@
+// 曲線序列器情境: 步驟時間不累積誤差、V_ABOVE / I_BELOW 條件、循環、暫停 / 繼續、中止，
+// 與充電 / 均流的輸出互斥，以及結束後與 ConfigStore 的同步
+#include "sim_rig.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 開機並等待軟啟動結束，之後 setOutput() 會直接送到模塊
+static void powerUp(SimRig& rig, float volts, float amps) {
+    rig.psu.setOutput(volts, amps);
+    rig.command("ON");
+    rig.runFor(2000);
+}
+
+static void addSteps(SimCheck& chk, SimRig& rig, const char* const* steps, int n) {
+    char line[64];
+    for (int i = 0; i < n; i++) {
+        snprintf(line, sizeof(line), "PROF:ADD=%s", steps[i]);
+        chk.expect(rig.command(line).compare(0, 17, "CMD_ACK:PROF_ADD:") == 0, line);
+    }
+}
+
+// 前進到下一個步驟 (或結束)，回傳經過的時間
+static uint32_t runToStepChange(SimRig& rig, uint32_t limitMs) {
+    int step = rig.profile.stepIndex();
+    uint64_t t0 = rig.hal.now();
+    while (rig.profile.isActive() && rig.profile.stepIndex() == step && rig.hal.now() - t0 < limitMs) {
+        rig.runFor(10);
+    }
+    return (uint32_t)(rig.hal.now() - t0);
+}
+
+static int countLines(const SimRig& rig, const char* prefix) {
+    std::string all = rig.lines(prefix);
+    int n = 0;
+    for (size_t i = 0; i < all.size(); i++) n += (all[i] == '\n');
+    return n;
+}
+
+// 3 步驟 x 3 次，每次主迴圈延遲 7 ms: 每個步驟的切換時間都在預定時間點之後 20 ms 內
+static void caseTiming(SimCheck& chk) {
+    SimRig rig;
+    rig.boot();
+    rig.module.setLoad(10.0f);
+    powerUp(rig, 50.0f, 10.0f);
+    static const char* const steps[] = { "1000,50,10", "1000,60,10", "1000,70,10" };
+    addSteps(chk, rig, steps, 3);
+    rig.loopLatencyMs = 7;
+
+    uint64_t t0 = rig.hal.now();
+    chk.expect(rig.command("PROF:RUN=3") == "", "timing: PROF:RUN=3");
+    rig.runFor(12000);
+
+    std::vector<SimRig::SetPoint> changes;
+    for (size_t i = 0; i < rig.setLog.size(); i++) {
+        if (rig.setLog[i].at >= t0) changes.push_back(rig.setLog[i]);
+    }
+    // 第一步與開機設定值相同，不會出現在設定值變化中
+    bool ok = changes.size() == 8;
+    std::string detail;
+    for (size_t i = 0; i < changes.size(); i++) {
+        int k = (int)i + 1;
+        float volts = 50.0f + 10.0f * (k % 3);
+        int64_t late = (int64_t)(changes[i].at - t0) - (int64_t)k * 1000;
+        char buf[64];
+        snprintf(buf, sizeof(buf), "  step %d: %.0f V, %+lld ms\n", k, changes[i].volts, (long long)late);
+        detail += buf;
+        if (changes[i].volts != volts || late < 0 || late > 20) ok = false;
+    }
+    chk.expect(ok, "timing: 8 step changes on schedule (no drift)", detail);
+    chk.expect(rig.profile.state() == PROF_DONE && rig.profile.loopIndex() == 3, "timing: DONE after 3 loops");
+    chk.expect(countLines(rig, "PROF:LOOP") == 2 && countLines(rig, "PROF:DONE,STEP=3/3,LOOP=3") == 1,
+               "timing: LOOP / DONE notifications", rig.lines("PROF:"));
+    chk.expect(rig.out.isFree(), "timing: output released after DONE");
+}
+
+// V_ABOVE / I_BELOW: 以電池模型的實測值切換，以及逾時
+static void caseConditions(SimCheck& chk) {
+    {
+        SimRig rig;
+        rig.boot();
+        rig.startBattery(90.0f, 0.1f, 0.004f);
+        powerUp(rig, 100.0f, 20.0f);
+        static const char* const steps[] = { "0,100,20,1,95", "1000,100,5" };
+        addSteps(chk, rig, steps, 2);
+        rig.command("PROF:RUN");
+        uint32_t ms = runToStepChange(rig, 120000);
+        PowerStatus st = rig.psu.getStatus();
+        char what[80];
+        snprintf(what, sizeof(what), "v_above: step at %.2f V after %lu ms", st.voltageOut, (unsigned long)ms);
+        chk.expect(rig.profile.stepIndex() == 1 && st.voltageOut >= 95.0f && st.voltageOut < 95.1f, what);
+    }
+    {
+        SimRig rig;
+        rig.boot();
+        rig.startBattery(99.0f, 0.1f, 0.004f);
+        powerUp(rig, 100.0f, 20.0f);
+        static const char* const steps[] = { "0,100,20,2,5", "1000,100,1" };
+        addSteps(chk, rig, steps, 2);
+        rig.command("PROF:RUN");
+        uint32_t ms = runToStepChange(rig, 600000);
+        PowerStatus st = rig.psu.getStatus();
+        char what[80];
+        snprintf(what, sizeof(what), "i_below: step at %.2f A after %lu ms", st.currentOut, (unsigned long)ms);
+        chk.expect(rig.profile.stepIndex() == 1 && st.currentOut <= 5.0f && st.currentOut > 4.8f, what);
+    }
+    {
+        // 條件不成立時在 durationMs 逾時切換
+        SimRig rig;
+        rig.boot();
+        rig.module.setLoad(10.0f);
+        powerUp(rig, 100.0f, 20.0f);
+        static const char* const steps[] = { "2000,100,20,1,200", "1000,50,5" };
+        addSteps(chk, rig, steps, 2);
+        uint64_t t0 = rig.hal.now();
+        rig.command("PROF:RUN");
+        runToStepChange(rig, 10000);
+        bool ok = !rig.setLog.empty() && rig.setLog.back().volts == 50.0f && rig.setLog.back().at == t0 + 2000;
+        chk.expect(ok, "v_above timeout: step change exactly at 2000 ms");
+    }
+}
+
+// loops = 0 無限循環，直到中止; 中止後電流為 0、保留電壓，輸出釋放
+static void caseLoopAbort(SimCheck& chk) {
+    SimRig rig;
+    rig.boot();
+    rig.module.setLoad(10.0f);
+    powerUp(rig, 50.0f, 10.0f);
+    static const char* const steps[] = { "100,50,10", "100,60,10" };
+    addSteps(chk, rig, steps, 2);
+    rig.command("PROF:RUN=0");
+    rig.runFor(5000);
+    chk.expect(rig.profile.state() == PROF_RUNNING && rig.profile.loopIndex() >= 24, "loop: endless loop running");
+
+    chk.expect(rig.command("PROF:ABORT") == "", "abort: PROF:ABORT");
+    rig.runFor(500);
+    chk.expect(rig.profile.state() == PROF_ABORTED && rig.out.isFree(), "abort: ABORTED, output released");
+    chk.expect(rig.module.setCurrent() == 0.0f && rig.module.setVoltage() >= 50.0f, "abort: current 0, voltage kept");
+    chk.expect(rig.module.isRunning(), "abort: module stays on");
+    chk.expect(rig.command("PROF:ABORT") == "ERR:STATE:PROF:ABORT", "abort: second abort rejected");
+}
+
+// 暫停期間不計時、輸出不變; 繼續後步驟結束時間往後移動暫停的時間
+static void casePause(SimCheck& chk) {
+    SimRig rig;
+    rig.boot();
+    rig.module.setLoad(10.0f);
+    powerUp(rig, 50.0f, 10.0f);
+    static const char* const steps[] = { "2000,40,10", "2000,60,10" };
+    addSteps(chk, rig, steps, 2);
+    uint64_t t0 = rig.hal.now();
+    rig.command("PROF:RUN");
+    rig.runFor(500);
+    chk.expect(rig.command("PROF:PAUSE") == "", "pause: PROF:PAUSE");
+    size_t logged = rig.setLog.size();
+    rig.runFor(3000);
+    std::string get = rig.command("GET:PROF");
+    chk.expect(get == "PROF:ST=PAUSE,STEP=1/2,LOOP=0/1,T=500/2000", "pause: GET:PROF while paused", get);
+    chk.expect(rig.setLog.size() == logged && rig.module.setVoltage() == 40.0f, "pause: output held");
+    chk.expect(rig.command("PROF:RESUME") == "", "pause: PROF:RESUME");
+    runToStepChange(rig, 10000);
+    bool ok = !rig.setLog.empty() && rig.setLog.back().volts == 60.0f && rig.setLog.back().at == t0 + 5000;
+    chk.expect(ok, "pause: next step at 2000 + 3000 ms");
+    chk.expect(rig.command("PROF:RESUME") == "ERR:STATE:PROF:RESUME", "pause: resume while running rejected");
+}
+
+// 曲線與充電 / 均流互相排斥; OFF 中止曲線並關閉模塊
+static void caseExclusion(SimCheck& chk) {
+    SimRig rig;
+    rig.boot();
+    rig.module.setLoad(10.0f);
+    powerUp(rig, 50.0f, 10.0f);
+    static const char* const steps[] = { "60000,50,10" };
+    addSteps(chk, rig, steps, 1);
+    rig.command("PROF:RUN");
+    rig.runFor(100);
+    chk.expect(rig.out.owner() == OUT_OWNER_PROFILE, "excl: profile owns output");
+    chk.expect(rig.command("CHG:START") == "ERR:STATE:CHG:START", "excl: CHG:START rejected while profile runs");
+    chk.expect(rig.command("SHARE:I=10") == "ERR:STATE:SHARE:I", "excl: SHARE:I rejected while profile runs");
+    chk.expect(rig.command("SET:V=80") == "ERR:STATE:SET:V", "excl: SET:V rejected while profile runs");
+    chk.expect(rig.charger.state() == CHG_IDLE && !rig.share.isEnabled(), "excl: charger / share untouched");
+
+    chk.expect(rig.command("OFF") == "CMD_ACK:OFF", "excl: OFF");
+    rig.runFor(500);
+    chk.expect(rig.profile.state() == PROF_ABORTED && !rig.module.isRunning() && rig.out.isFree(),
+               "excl: OFF aborts profile and powers off", rig.lines("PROF:"));
+
+    chk.expect(rig.command("CHG:START") == "", "excl: CHG:START");
+    chk.expect(rig.command("PROF:RUN") == "ERR:STATE:PROF:RUN", "excl: PROF:RUN rejected while charging");
+    chk.expect(rig.profile.state() == PROF_ABORTED, "excl: profile untouched");
+}
+
+// 儲存的設定值 100 V / 6 A，曲線 50 V / 20 A:
+// 中止或結束後 ConfigSync 保留曲線留下的設定值 (寫回 config)，不會重新套用儲存的 V/I
+static void caseConfigSync(SimCheck& chk) {
+    {
+        SimRig rig;
+        rig.boot();
+        rig.module.setLoad(10.0f);
+        chk.expect(rig.module.setVoltage() == 100.0f, "cfg abort: stored 100 V applied at boot");
+        rig.command("ON");
+        rig.runFor(2000);
+        static const char* const steps[] = { "60000,50,20" };
+        addSteps(chk, rig, steps, 1);
+        rig.command("PROF:RUN");
+        rig.runFor(1000);
+        chk.expect(rig.module.setVoltage() == 50.0f && rig.module.setCurrent() == 20.0f, "cfg abort: profile 50 V / 20 A");
+
+        uint64_t t0 = rig.hal.now();
+        rig.command("PROF:ABORT");
+        rig.runFor(2000);
+        bool ok = true;
+        std::string detail;
+        for (size_t i = 0; i < rig.setLog.size(); i++) {
+            if (rig.setLog[i].at < t0) continue;
+            char buf[64];
+            snprintf(buf, sizeof(buf), "  +%llu ms: %.1f V / %.1f A\n", (unsigned long long)(rig.setLog[i].at - t0),
+                     rig.setLog[i].volts, rig.setLog[i].amps);
+            detail += buf;
+            if (rig.setLog[i].volts != 50.0f || rig.setLog[i].amps != 0.0f) ok = false;
+        }
+        chk.expect(ok && rig.module.setCurrent() == 0.0f, "cfg abort: stays at 50 V / 0 A after release", detail);
+        chk.expect(rig.config.getFloat(CFG_TARGET_VOLTAGE) == 50.0f && rig.config.getFloat(CFG_TARGET_CURRENT) == 0.0f,
+                   "cfg abort: config stores 50 V / 0 A", rig.command("GET:CFG"));
+
+        // 釋放後 CFG:V 仍會套用，SET:I 仍會寫回
+        chk.expect(rig.command("CFG:V=80") == "CMD_ACK:CFG:V:80.000", "cfg abort: CFG:V=80");
+        rig.runFor(500);
+        chk.expect(rig.module.setVoltage() == 80.0f && rig.module.setCurrent() == 0.0f, "cfg abort: CFG:V applied");
+        rig.command("SET:I=5");
+        rig.runFor(500);
+        chk.expect(rig.config.getFloat(CFG_TARGET_CURRENT) == 5.0f && rig.module.setCurrent() == 5.0f,
+                   "cfg abort: SET:I stored");
+    }
+    {
+        SimRig rig;
+        rig.boot();
+        rig.module.setLoad(10.0f);
+        rig.command("ON");
+        rig.runFor(2000);
+        static const char* const steps[] = { "500,50,20", "500,60,10" };
+        addSteps(chk, rig, steps, 2);
+        rig.command("PROF:RUN");
+        rig.runFor(3000);
+        chk.expect(rig.profile.state() == PROF_DONE && rig.out.isFree(), "cfg done: DONE, output released");
+        chk.expect(rig.module.setVoltage() == 60.0f && rig.module.setCurrent() == 10.0f,
+                   "cfg done: last step 60 V / 10 A kept");
+        chk.expect(rig.config.getFloat(CFG_TARGET_VOLTAGE) == 60.0f && rig.config.getFloat(CFG_TARGET_CURRENT) == 10.0f,
+                   "cfg done: config stores 60 V / 10 A", rig.command("GET:CFG"));
+    }
+}
+
+int runProfileScenario() {
+    SimCheck chk("profile");
+    caseTiming(chk);
+    caseConditions(chk);
+    caseLoopAbort(chk);
+    casePause(chk);
+    caseExclusion(chk);
+    caseConfigSync(chk);
+    return chk.finish();
+}
@@ -0,0 +1,166 @@
+// PSU 控制器主機端模擬 (虛擬時鐘)
+// 用法: psu_sim [minutes] [target_amps] [load_ohms] [contactor_s] [fault_s] [modules] [busoff_s]
+//   minutes     模擬的虛擬時間長度 (預設 10 分鐘)
+//   target_amps 目標電流 (預設 60 A)
+//   load_ohms   負載電阻 (預設 1.0 Ω)
+//   contactor_s 接觸器吸合時間 (預設 5 s)
+//   fault_s     模塊故障時間 (預設 0 = 不故障)，多模塊時只有第一台故障
+//   modules     並聯模塊數 (預設 1)，大於 1 時以 LoadShare 均流
+//               每台接 load_ohms * modules 的負載，總負載與單台時相同
+//   busoff_s    CAN Bus 進入 bus-off 的時間 (預設 0 = 不發生)，驗證自動復原
+// 情境測試: psu_sim charge  (充電狀態機與保護跳脫，失敗時 exit code 1)
+//           psu_sim profile (曲線步驟時間、量測條件、循環、暫停 / 繼續、中止)
+//           psu_sim share   (3 台並聯: OFF -> ON / SHARE:I 開啟所有模塊、模塊停止時重新分配)
+#include "virtual_clock_hal.h"
+#include "sim_lm_psu.h"
+#include "psu_protocol.h"
+#include "psu_bus.h"
+#include "output_ctrl.h"
+#include "load_share.h"
+#include "can_health.h"
+#include "energy_log.h"
+#include "telemetry_stats.h"
+#include "app_ui.h"
+#include "serial_cmd.h"
+#include "boot_seq.h"
+#include "sim_rig.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "charge") == 0) return runChargeScenario();
+    if (argc > 1 && strcmp(argv[1], "profile") == 0) return runProfileScenario();
+    if (argc > 1 && strcmp(argv[1], "share") == 0) return runShareScenario();
+
+    float minutes    = (argc > 1) ? strtof(argv[1], NULL) : 10.0f;
+    float targetAmps = (argc > 2) ? strtof(argv[2], NULL) : 60.0f;
+    float loadOhms   = (argc > 3) ? strtof(argv[3], NULL) : 1.0f;
+    float contactorS = (argc > 4) ? strtof(argv[4], NULL) : 5.0f;
+    float faultS     = (argc > 5) ? strtof(argv[5], NULL) : 0.0f;
+    int moduleCount  = (argc > 6) ? atoi(argv[6]) : 1;
+    if (moduleCount < 1) moduleCount = 1;
+    if (moduleCount > PSU_MAX_MODULES) moduleCount = PSU_MAX_MODULES;
+    float busOffS    = (argc > 7) ? strtof(argv[7], NULL) : 0.0f;
+
+    VirtualClockHAL hal;
+    std::vector<std::unique_ptr<SimLmPsu> > modules;
+    for (int i = 0; i < moduleCount; i++) {
+        modules.emplace_back(new SimLmPsu(&hal, (uint8_t)(PSU_ADDRESS + i)));
+    }
+    SimLmPsu& module = *modules[0];
+    hal.setCanTxHandler([&modules](const HalCanFrame& f) {
+        for (size_t i = 0; i < modules.size(); i++) {
+            if (modules[i]->handleFrame(f)) break;
+        }
+    });
+
+    hal.init();
+
+    PsuBus bus(&hal);
+    for (int i = 0; i < moduleCount; i++) bus.addModule();
+    PowerProtocol& psu = *bus.module(0);
+    OutputControl out(&bus);
+    LoadShare share(&hal, &out);
+    CanHealth can(&hal);
+    EnergyLog energy(&hal, &bus);
+    static TelemetryStats stats(&hal, &psu);
+    AppUI ui(&hal, &psu, &out);
+    SerialCmd serial(&hal, &psu, &out);
+    ui.setCanHealth(&can);
+    ui.setStats(&stats);
+    can.registerCommands(serial.registry());
+    share.registerCommands(serial.registry());
+    energy.registerCommands(serial.registry());
+    energy.begin();
+    stats.registerCommands(serial.registry());
+    stats.begin();
+    serial.begin();
+    ui.begin();
+
+    bus.begin(PSU_ADDRESS);
+    BootSequencer boot(&hal, &bus);
+    boot.registerCommands(serial.registry());
+    if (serial.registry().rejected()) {
+        printf("command table: %d rejected, first %s\n", serial.registry().rejected(), serial.registry().firstRejected());
+        return 1;
+    }
+    boot.run();
+    int responded = 0;
+    for (int i = 0; i < moduleCount; i++) responded += bus.module(i)->hasResponded() ? 1 : 0;
+    printf("boot: probe %lu ms, %s, %d/%d modules responded\n", (unsigned long)boot.report().probeMs,
+           boot.report().psuFound ? "PSU found" : "timeout", responded, moduleCount);
+    uint64_t simStart = hal.now();
+    if (moduleCount > 1) {
+        share.setTarget(DEFAULT_TARGET_VOLTAGE, targetAmps);
+    } else {
+        psu.setOutput(DEFAULT_TARGET_VOLTAGE, targetAmps);
+    }
+
+    hal.scheduleIn((uint32_t)(contactorS * 1000), [&modules, loadOhms]() {
+        for (size_t i = 0; i < modules.size(); i++) modules[i]->setLoad(loadOhms * modules.size());
+    });
+    if (faultS > 0.0f) {
+        hal.scheduleIn((uint32_t)(faultS * 1000), [&module]() { module.setFault(true); });
+    }
+    if (busOffS > 0.0f) {
+        hal.scheduleIn((uint32_t)(busOffS * 1000), [&hal]() { hal.setCanBusOff(); });
+    }
+
+    uint64_t end = hal.now() + (uint64_t)(minutes * 60000.0f);
+    uint64_t nextPrint = hal.now();
+    uint64_t iterations = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    while (hal.now() < end) {
+        bus.loop();
+        share.loop();
+        can.loop();
+        energy.loop();
+        stats.loop();
+        ui.loop();
+        serial.loop();
+        iterations++;
+
+        uint32_t deadline = bus.nextDeadline();
+        deadline = halTickMin(deadline, share.nextDeadline());
+        deadline = halTickMin(deadline, can.nextDeadline());
+        deadline = halTickMin(deadline, energy.nextDeadline());
+        deadline = halTickMin(deadline, stats.nextDeadline());
+        deadline = halTickMin(deadline, ui.nextDeadline());
+        deadline = halTickMin(deadline, serial.nextDeadline());
+        hal.waitEvents(deadline);
+
+        hal.takeUartOutput(); // 丟棄 100 ms 週期回報，避免無限累積
+
+        if (hal.now() >= nextPrint) {
+            PowerStatus st = psu.getStatus();
+            printf("t=%8.1fs  V=%6.1f I=%6.1f  set=%.1fV/%.1fA  %s\n",
+                   hal.now() / 1000.0, st.voltageOut, st.currentOut,
+                   module.setVoltage(), module.setCurrent(),
+                   st.isSoftStarting ? "SOFT" : (st.hwRunning ? "RUN" : "OFF"));
+            for (int i = 1; i < moduleCount; i++) {
+                PowerStatus ms = bus.module(i)->getStatus();
+                printf("           M%d I=%6.1f  set=%.1fA  %s\n", i, ms.currentOut, modules[i]->setCurrent(),
+                       share.isHealthy(i) ? "OK" : "FAULT");
+            }
+            nextPrint += 10000;
+        }
+    }
+
+    hal.takeUartOutput();
+    hal.injectUart("GET:CAN\nGET:ENERGY\nGET:STAT=1\nGET:STAT=3\n");
+    serial.loop();
+    printf("%s", hal.takeUartOutput().c_str());
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double simulated = (hal.now() - simStart) / 1000.0;
+    printf("simulated %.1f s in %.3f s wall (x%.0f), %llu loop iterations, %u CAN tx\n",
+           simulated, wall, (wall > 0.0) ? simulated / wall : 0.0,
+           (unsigned long long)iterations, hal.canTxCount());
+    return 0;
+}
@@ -0,0 +1,112 @@
+// 均流情境 (3 台並聯): OFF -> ON 與直接 SHARE:I 都要開啟每一台模塊，
+// 總電流達到目標; 模塊停止運轉時由其他模塊分擔
+#include "sim_rig.h"
+
+#include <math.h>
+#include <stdio.h>
+
+static const int SHARE_MODULES = 3;
+
+// 每台 2 Ω: 100 V 時可輸出 50 A，均流的 30 A 限流生效
+static void connectLoads(SimRig& rig) {
+    for (size_t i = 0; i < rig.modules.size(); i++) rig.modules[i]->setLoad(2.0f);
+}
+
+static int runningCount(const SimRig& rig) {
+    int n = 0;
+    for (size_t i = 0; i < rig.modules.size(); i++) n += rig.modules[i]->isRunning() ? 1 : 0;
+    return n;
+}
+
+static float totalAmps(const SimRig& rig) {
+    float sum = 0;
+    for (size_t i = 0; i < rig.modules.size(); i++) sum += rig.modules[i]->outputCurrent();
+    return sum;
+}
+
+static std::string describe(SimRig& rig) {
+    char buf[160];
+    std::string s;
+    for (size_t i = 0; i < rig.modules.size(); i++) {
+        snprintf(buf, sizeof(buf), "  M%d: %s, set %.1f V / %.1f A, out %.1f A\n", (int)i,
+                 rig.modules[i]->isRunning() ? "running" : "stopped", rig.modules[i]->setVoltage(),
+                 rig.modules[i]->setCurrent(), rig.modules[i]->outputCurrent());
+        s += buf;
+    }
+    s += "  " + rig.command("GET:SHARE");
+    return s;
+}
+
+static void expectShared(SimCheck& chk, SimRig& rig, const char* what, float total, int running) {
+    std::string detail = describe(rig);
+    char name[96];
+    snprintf(name, sizeof(name), "%s: %d modules running", what, running);
+    chk.expect(runningCount(rig) == running, name, detail);
+    snprintf(name, sizeof(name), "%s: total %.0f A", what, total);
+    chk.expect(fabsf(totalAmps(rig) - total) < 1.0f, name, detail);
+    float each = total / running;
+    bool limits = true;
+    for (size_t i = 0; i < rig.modules.size(); i++) {
+        if (rig.modules[i]->isRunning() && fabsf(rig.modules[i]->setCurrent() - each) > 1.0f) limits = false;
+    }
+    snprintf(name, sizeof(name), "%s: %.0f A limit each", what, each);
+    chk.expect(limits, name, detail);
+}
+
+// 開機後 OFF -> ON，再啟用均流
+static void caseOffOn(SimCheck& chk) {
+    SimRig rig(SHARE_MODULES);
+    rig.boot();
+    connectLoads(rig);
+    chk.expect(runningCount(rig) == 0, "off-on: all modules off after boot", describe(rig));
+
+    chk.expect(rig.command("ON") == "CMD_ACK:ON", "off-on: ON");
+    rig.runFor(3000);
+    chk.expect(runningCount(rig) == SHARE_MODULES, "off-on: ON starts every module", describe(rig));
+
+    chk.expect(rig.command("SHARE:I=90,100").compare(0, 14, "CMD_ACK:SHARE:") == 0, "off-on: SHARE:I=90,100");
+    rig.runFor(5000);
+    expectShared(chk, rig, "off-on", 90.0f, SHARE_MODULES);
+    chk.expect(rig.command("GET:SHARE").find("FAULT") == std::string::npos, "off-on: GET:SHARE all OK",
+               describe(rig));
+
+    chk.expect(rig.command("OFF") == "CMD_ACK:OFF", "off-on: OFF");
+    rig.runFor(2000);
+    chk.expect(runningCount(rig) == 0, "off-on: OFF stops every module", describe(rig));
+}
+
+// 模塊關機時直接 SHARE:I: 均流開啟所有模塊，開始運轉後才分配電流
+static void caseShareFromOff(SimCheck& chk) {
+    SimRig rig(SHARE_MODULES);
+    rig.boot();
+    connectLoads(rig);
+
+    chk.expect(rig.command("SHARE:I=90,100").compare(0, 14, "CMD_ACK:SHARE:") == 0, "from off: SHARE:I=90,100");
+    rig.runFor(5000);
+    expectShared(chk, rig, "from off", 90.0f, SHARE_MODULES);
+}
+
+// 均流中一台模塊停止運轉: 標示 FAULT，其餘兩台分擔 90 A
+static void caseModuleStops(SimCheck& chk) {
+    SimRig rig(SHARE_MODULES);
+    rig.boot();
+    connectLoads(rig);
+    rig.command("ON");
+    rig.runFor(3000);
+    rig.command("SHARE:I=90,100");
+    rig.runFor(5000);
+
+    rig.modules[2]->setFault(true);
+    rig.runFor(3000);
+    expectShared(chk, rig, "module stops", 90.0f, SHARE_MODULES - 1);
+    chk.expect(rig.command("GET:SHARE").find("M2=0.0/0.0/FAULT") != std::string::npos, "module stops: M2 FAULT",
+               describe(rig));
+}
+
+int runShareScenario() {
+    SimCheck chk("share");
+    caseOffOn(chk);
+    caseShareFromOff(chk);
+    caseModuleStops(chk);
+    return chk.finish();
+}
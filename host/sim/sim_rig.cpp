@@ -0,0 +1,135 @@
+#include "sim_rig.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+SimRig::SimRig(int moduleCount)
+    : modules(makeModules(&hal, moduleCount)), module(*modules[0]), bus(&hal), psu(*bus.addModule()), out(&bus),
+      config(&hal), sync(&config, &psu, &out), share(&hal, &out), profile(&hal, &psu, &out), charger(&hal, &psu, &out), serial(&hal, &psu, &out),
+      loopLatencyMs(0), battery(false), emf(0), ohms(0), voltsPerAs(0), deliveredAh(0) {
+    for (size_t i = 1; i < modules.size(); i++) bus.addModule();
+    hal.setCanTxHandler([this](const HalCanFrame& f) {
+        for (size_t i = 0; i < modules.size(); i++) {
+            if (modules[i]->handleFrame(f)) break;
+        }
+        if (setLog.empty() || setLog.back().volts != module.setVoltage() || setLog.back().amps != module.setCurrent()) {
+            SetPoint sp = { hal.now(), module.setVoltage(), module.setCurrent() };
+            setLog.push_back(sp);
+        }
+    });
+    hal.init();
+    config.begin();
+    config.registerCommands(serial.registry());
+    share.registerCommands(serial.registry());
+    profile.registerCommands(serial.registry());
+    charger.registerCommands(serial.registry());
+    if (serial.registry().rejected()) {
+        fprintf(stderr, "command table: %d rejected, first %s\n", serial.registry().rejected(),
+                serial.registry().firstRejected());
+        exit(1);
+    }
+}
+
+std::vector<std::unique_ptr<SimLmPsu> > SimRig::makeModules(VirtualClockHAL* hal, int count) {
+    std::vector<std::unique_ptr<SimLmPsu> > list;
+    if (count < 1) count = 1;
+    if (count > PSU_MAX_MODULES) count = PSU_MAX_MODULES;
+    for (int i = 0; i < count; i++) list.emplace_back(new SimLmPsu(hal, (uint8_t)(PSU_ADDRESS + i)));
+    return list;
+}
+
+void SimRig::boot() {
+    bus.begin(PSU_ADDRESS);
+    sync.begin();
+    runFor(500);
+    out.powerOffAll();
+    runFor(500);
+    uart.clear();
+    setLog.clear();
+}
+
+void SimRig::runFor(uint32_t ms) {
+    uint64_t end = hal.now() + ms;
+    while (hal.now() < end) {
+        // 喚醒後先經過其他工作的處理時間，控制器才看到期限
+        if (loopLatencyMs) hal.delayMs(loopLatencyMs);
+        bus.loop();
+        share.loop();
+        profile.loop();
+        charger.loop();
+        serial.loop();
+        sync.loop();
+
+        uint32_t deadline = bus.nextDeadline();
+        deadline = halTickMin(deadline, share.nextDeadline());
+        deadline = halTickMin(deadline, profile.nextDeadline());
+        deadline = halTickMin(deadline, charger.nextDeadline());
+        deadline = halTickMin(deadline, serial.nextDeadline());
+        deadline = halTickMin(deadline, config.nextDeadline());
+        deadline = halTickMin(deadline, (uint32_t)end);
+        hal.waitEvents(deadline);
+        uart += hal.takeUartOutput();
+    }
+}
+
+std::string SimRig::command(const char* line) {
+    char buf[64];
+    char reply[192];
+    snprintf(buf, sizeof(buf), "%s", line);
+    serial.registry().dispatch(buf, reply, sizeof(reply));
+    uart += hal.takeUartOutput();
+    return reply;
+}
+
+void SimRig::startBattery(float emf0, float rOhms, float vPerAs) {
+    emf = emf0;
+    ohms = rOhms;
+    voltsPerAs = vPerAs;
+    deliveredAh = 0;
+    module.setLoad(ohms, emf);
+    if (!battery) {
+        battery = true;
+        hal.scheduleIn(100, [this]() { batteryTick(); });
+    }
+}
+
+// 每 100 ms 依輸出電流更新電動勢
+void SimRig::batteryTick() {
+    float amps = module.outputCurrent();
+    emf += amps * 0.1f * voltsPerAs;
+    deliveredAh += amps * 0.1 / 3600.0;
+    module.setLoad(ohms, emf);
+    hal.scheduleIn(100, [this]() { batteryTick(); });
+}
+
+std::string SimRig::lines(const char* prefix) const {
+    std::string result;
+    size_t len = strlen(prefix);
+    size_t pos = 0;
+    while (pos < uart.size()) {
+        size_t eol = uart.find('\n', pos);
+        if (eol == std::string::npos) eol = uart.size();
+        if (uart.compare(pos, len, prefix) == 0) {
+            std::string l = uart.substr(pos, eol - pos);
+            if (!l.empty() && l[l.size() - 1] == '\r') l.erase(l.size() - 1);
+            result += l;
+            result += '\n';
+        }
+        pos = eol + 1;
+    }
+    return result;
+}
+
+void SimCheck::expect(bool ok, const char* what, const std::string& detail) {
+    checks++;
+    if (ok) return;
+    failed++;
+    printf("FAIL [%s] %s\n", scenario, what);
+    if (!detail.empty()) printf("%s\n", detail.c_str());
+}
+
+int SimCheck::finish() const {
+    printf("%s: %d checks, %d failed\n", scenario, checks, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+#ifndef SIM_RIG_H
+#define SIM_RIG_H
+
+// 情境測試用的模擬環境: 一或多台並聯 SimLmPsu + 控制器模組 + 設定儲存 + 電池模型
+#include "virtual_clock_hal.h"
+#include "sim_lm_psu.h"
+#include "psu_bus.h"
+#include "output_ctrl.h"
+#include "load_share.h"
+#include "profile_seq.h"
+#include "charge_ctrl.h"
+#include "serial_cmd.h"
+#include "config_store.h"
+#include "config_sync.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SimRig {
+    VirtualClockHAL hal;
+    std::vector<std::unique_ptr<SimLmPsu> > modules; // 位址 PSU_ADDRESS 起依序排列
+    SimLmPsu& module;   // 第一台 (主模塊)，電池與 setLog 只接在這一台
+    PsuBus bus;
+    PowerProtocol& psu;
+    OutputControl out;
+    ConfigStore config;
+    ConfigSync sync;    // 與主程式相同: CFG:V/I 套用到 PSU，設定值變更寫回 config
+    LoadShare share;
+    ProfileSequencer profile;
+    ChargeController charger;
+    SerialCmd serial;
+    std::string uart;   // 累積的 UART 輸出 (含主動回報)
+    uint32_t loopLatencyMs; // 每次主迴圈額外的處理時間 (模擬 loop 延遲)
+
+    // 模塊收到的設定值變化 (虛擬時間 ms, 電壓, 電流)
+    struct SetPoint { uint64_t at; float volts; float amps; };
+    std::vector<SetPoint> setLog;
+
+    // 電池: 電動勢 emf 串接內阻 ohms，電動勢依充入電荷上升 voltsPerAs (V / A·s)
+    bool battery;
+    float emf;
+    float ohms;
+    float voltsPerAs;
+    double deliveredAh; // 模型側獨立積分的充電量，用來核對 EnergyMeter
+
+    explicit SimRig(int moduleCount = 1);
+
+    // 開機並等待模塊回應，結束時所有模塊關機、輸出沒有擁有者
+    void boot();
+    // 依主程式的順序執行各模組，推進 ms 虛擬時間
+    void runFor(uint32_t ms);
+    // 以 SerialCmd 的指令表執行一行指令，回傳回覆 (主動回報留在 uart)
+    std::string command(const char* line);
+    void startBattery(float emf0, float rOhms, float vPerAs);
+
+    // 從 uart 中取出以 prefix 開頭的行
+    std::string lines(const char* prefix) const;
+
+private:
+    static std::vector<std::unique_ptr<SimLmPsu> > makeModules(VirtualClockHAL* hal, int count);
+    void batteryTick();
+};
+
+// 檢查結果統計: 失敗時印出說明
+struct SimCheck {
+    const char* scenario;
+    int checks;
+    int failed;
+
+    explicit SimCheck(const char* name) : scenario(name), checks(0), failed(0) {}
+    void expect(bool ok, const char* what, const std::string& detail = std::string());
+    int finish() const; // 回傳 process exit code
+};
+
+int runChargeScenario();
+int runProfileScenario();
+int runShareScenario();
+
+#endif
@@ -1,16 +1,29 @@
-#include "hal_interface.h"
+#include "esp32_hal.h"
 #include "psu_protocol.h"
-#include "app_ui.h"
-#include "serial_cmd.h"
-#include <freertos/FreeRTOS.h>
-#include <freertos/task.h>
+#include "psu_bus.h"
+#include "output_ctrl.h"
+#include "load_share.h"
+#include "can_health.h"
+#include "profile_seq.h"
+#include "charge_ctrl.h"
+#include "energy_log.h"
+#include "telemetry_stats.h"
+#include "app_ui_impl.h"
+#include "serial_cmd_impl.h"
+#include "boot_seq.h"
+#include "config_store.h"
+#include "config_sync.h"
+
+#include <stdio.h>
 
 // 宣告在 port_esp32 中實作的 HAL 取得函數
 extern IHardwareHAL* getHal();
 
 extern "C" void app_main(void) {
     // 1. 取得硬體抽象層實體
-    IHardwareHAL* hal = getHal();
+    // 熱路徑模組 (PsuBusT、AppUIT、SerialCmdT) 以具體類別 Esp32HAL 具現化，HAL 呼叫不經 vtable;
+    // 其他模組仍使用 IHardwareHAL*
+    Esp32HAL* hal = static_cast<Esp32HAL*>(getHal());
 
     hal->init();
     
@@ -18,26 +31,84 @@ extern "C" void app_main(void) {
 
     // 2. 初始化核心邏輯模組
     // Dependency Injection: 將 HAL 注入到應用層
-    PowerProtocol psu(hal);
-    AppUI ui(hal, &psu);
-    SerialCmd serial(hal, &psu);
+    // 並聯模塊共用一條 CAN Bus; UI / 序列埠指令操作第一台 (主模塊)
+    // 關機 (OFF / 按鍵 / 充電保護) 一律經由 OutputControl 關閉所有模塊
+    ConfigStore config(hal);
+    PsuBusT<Esp32HAL> bus(hal);
+    for (int i = 0; i < PSU_MODULE_COUNT; i++) bus.addModule();
+    PowerProtocol& psu = *bus.module(0);
+    OutputControl out(&bus);
+    ConfigSync sync(&config, &psu, &out);
+    LoadShare share(hal, &out);
+    for (int i = 0; i < PSU_MODULE_COUNT; i++) share.setCapacity(i, PSU_MODULE_CAPACITY_A);
+    CanHealth can(hal);
+    ProfileSequencer profile(hal, &psu, &out);
+    ChargeController charger(hal, &psu, &out);
+    EnergyLog energy(hal, &bus);
+    // 統計的樣本 ring 約 34 KB，放在 .bss 而不是 main task 的 stack
+    static TelemetryStats stats(hal, &psu);
+    AppUIT<Esp32HAL> ui(hal, &psu, &out);
+    SerialCmdT<Esp32HAL> serial(hal, &psu, &out);
+    ui.setCanHealth(&can);
+    ui.setStats(&stats);
 
     // 3. 模組初始化
+    config.begin();
+    energy.begin();
+    stats.begin();
+    config.registerCommands(serial.registry());
+    share.registerCommands(serial.registry());
+    can.registerCommands(serial.registry());
+    profile.registerCommands(serial.registry());
+    charger.registerCommands(serial.registry());
+    energy.registerCommands(serial.registry());
+    stats.registerCommands(serial.registry());
     serial.begin();
     ui.begin();
     
-    hal->delayMs(3000);
-    psu.init(PSU_ADDRESS);
-    hal->uartSend("PSU Initialized.\r\n");
+    // 主動偵測 PSU: 收到狀態回應即繼續 (最多等待 BOOT_PROBE_TIMEOUT_MS)
+    // 位址與設定值從 ConfigStore 載入 (CFG:ADDR 變更需重新開機)
+    // 多模塊時位址依序為 ADDR, ADDR+1, ...
+    bus.begin((uint8_t)config.getU32(CFG_PSU_ADDRESS));
+    sync.begin();
+    BootSequencer boot(hal, &bus);
+    boot.registerCommands(serial.registry());
+    // 指令表已滿或名稱重複時該指令不會生效: 開機時回報 (MAX_COMMANDS 見 cmd_registry.h)
+    if (serial.registry().rejected()) {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "ERR:CMD_TABLE:%s,REJECTED=%d,MAX=%d\r\n", serial.registry().firstRejected(),
+                 serial.registry().rejected(), CmdRegistry::capacity());
+        hal->uartSend(buf);
+    }
+    boot.run();
+    hal->uartSend(boot.report().psuFound ? "PSU Initialized.\r\n" : "PSU not responding, continue polling.\r\n");
+    boot.printReport();
 
     // 4. 主迴圈
     while (1) {
-        psu.loop();
+        bus.loop();
+        share.loop();
+        can.loop();
+        profile.loop();
+        charger.loop();
+        energy.loop();
+        stats.loop();
         ui.loop();
         serial.loop();
-        
-        // 釋放一點 CPU 給 FreeRTOS 的 IDLE task
-        // 如果 loop 執行很快，加這個可以避免 Watchdog 觸發
-        vTaskDelay(pdMS_TO_TICKS(1)); 
+        sync.loop();
+
+        // 阻塞到下一個事件 (CAN 訊框 / UART 換行 / 按鍵) 或最早的模組期限
+        // 期間 CPU 交給 FreeRTOS 的 IDLE task，不需要固定 vTaskDelay
+        uint32_t deadline = bus.nextDeadline();
+        deadline = halTickMin(deadline, share.nextDeadline());
+        deadline = halTickMin(deadline, can.nextDeadline());
+        deadline = halTickMin(deadline, profile.nextDeadline());
+        deadline = halTickMin(deadline, charger.nextDeadline());
+        deadline = halTickMin(deadline, energy.nextDeadline());
+        deadline = halTickMin(deadline, stats.nextDeadline());
+        deadline = halTickMin(deadline, ui.nextDeadline());
+        deadline = halTickMin(deadline, serial.nextDeadline());
+        deadline = halTickMin(deadline, config.nextDeadline());
+        hal->waitEvents(deadline);
     }
 }
\ No newline at end of file